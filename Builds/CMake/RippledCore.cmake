@@ -63,6 +63,7 @@ target_sources (xrpl_core PRIVATE
   src/ripple/json/impl/JsonPropertyStream.cpp
   src/ripple/json/impl/Object.cpp
   src/ripple/json/impl/Output.cpp
+  src/ripple/json/impl/ValueStream.cpp
   src/ripple/json/impl/Writer.cpp
   src/ripple/json/impl/json_reader.cpp
   src/ripple/json/impl/json_value.cpp
@@ -97,6 +98,7 @@ target_sources (xrpl_core PRIVATE
   src/ripple/protocol/impl/STInteger.cpp
   src/ripple/protocol/impl/STLedgerEntry.cpp
   src/ripple/protocol/impl/STObject.cpp
+  src/ripple/protocol/impl/STObjectView.cpp
   src/ripple/protocol/impl/STParsedJSON.cpp
   src/ripple/protocol/impl/STPathSet.cpp
   src/ripple/protocol/impl/STTx.cpp
@@ -186,6 +188,7 @@ install (
     src/ripple/json/JsonPropertyStream.h
     src/ripple/json/Object.h
     src/ripple/json/Output.h
+    src/ripple/json/ValueStream.h
     src/ripple/json/Writer.h
     src/ripple/json/json_forwards.h
     src/ripple/json/json_reader.h
@@ -366,6 +369,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/impl/LocalTxs.cpp
   src/ripple/app/ledger/impl/OpenLedger.cpp
   src/ripple/app/ledger/impl/SkipListAcquire.cpp
+  src/ripple/app/ledger/impl/SpeculativeApply.cpp
   src/ripple/app/ledger/impl/TimeoutCounter.cpp
   src/ripple/app/ledger/impl/TransactionAcquire.cpp
   src/ripple/app/ledger/impl/TransactionMaster.cpp
@@ -402,9 +406,11 @@ target_sources (rippled PRIVATE
   src/ripple/app/paths/PathRequest.cpp
   src/ripple/app/paths/PathRequests.cpp
   src/ripple/app/paths/Pathfinder.cpp
+  src/ripple/app/paths/PathfinderCache.cpp
   src/ripple/app/paths/RippleCalc.cpp
   src/ripple/app/paths/RippleLineCache.cpp
   src/ripple/app/paths/TrustLine.cpp
+  src/ripple/app/paths/TrustLineGraph.cpp
   src/ripple/app/paths/impl/BookStep.cpp
   src/ripple/app/paths/impl/DirectStep.cpp
   src/ripple/app/paths/impl/PaySteps.cpp
@@ -414,6 +420,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/rdb/backend/impl/PostgresDatabase.cpp
   src/ripple/app/rdb/backend/impl/SQLiteDatabase.cpp
   src/ripple/app/rdb/impl/Download.cpp
+  src/ripple/app/rdb/impl/MigrateTxDB.cpp
   src/ripple/app/rdb/impl/PeerFinder.cpp
   src/ripple/app/rdb/impl/RelationalDatabase.cpp
   src/ripple/app/rdb/impl/ShardArchive.cpp
@@ -541,6 +548,7 @@ target_sources (rippled PRIVATE
   src/ripple/nodestore/impl/Shard.cpp
   src/ripple/nodestore/impl/ShardInfo.cpp
   src/ripple/nodestore/impl/TaskQueue.cpp
+  src/ripple/nodestore/impl/ZstdCodec.cpp
   #[===============================[
      main sources:
        subdir: overlay
@@ -554,6 +562,7 @@ target_sources (rippled PRIVATE
   src/ripple/overlay/impl/PeerReservationTable.cpp
   src/ripple/overlay/impl/PeerSet.cpp
   src/ripple/overlay/impl/ProtocolVersion.cpp
+  src/ripple/overlay/impl/SignatureBatcher.cpp
   src/ripple/overlay/impl/TrafficCount.cpp
   src/ripple/overlay/impl/TxMetrics.cpp
   #[===============================[
@@ -707,6 +716,7 @@ if (tests)
     src/test/app/LedgerReplay_test.cpp
     src/test/app/LoadFeeTrack_test.cpp
     src/test/app/Manifest_test.cpp
+    src/test/app/MigrateTxDB_test.cpp
     src/test/app/MultiSign_test.cpp
     src/test/app/NetworkID_test.cpp
     src/test/app/NFToken_test.cpp
@@ -714,6 +724,7 @@ if (tests)
     src/test/app/NFTokenDir_test.cpp
     src/test/app/OfferStream_test.cpp
     src/test/app/Offer_test.cpp
+    src/test/app/OrderBookDB_test.cpp
     src/test/app/OversizeMeta_test.cpp
     src/test/app/Path_test.cpp
     src/test/app/PayChan_test.cpp
@@ -726,6 +737,7 @@ if (tests)
     src/test/app/SetAuth_test.cpp
     src/test/app/SetRegularKey_test.cpp
     src/test/app/SetTrust_test.cpp
+    src/test/app/SpeculativeApply_test.cpp
     src/test/app/Taker_test.cpp
     src/test/app/TheoreticalQuality_test.cpp
     src/test/app/Ticket_test.cpp
@@ -822,6 +834,7 @@ if (tests)
     #]===============================]
     src/test/json/Object_test.cpp
     src/test/json/Output_test.cpp
+    src/test/json/ValueStream_test.cpp
     src/test/json/Writer_test.cpp
     src/test/json/json_value_test.cpp
     #[===============================[
@@ -925,6 +938,7 @@ if (tests)
     src/test/protocol/STAccount_test.cpp
     src/test/protocol/STAmount_test.cpp
     src/test/protocol/STObject_test.cpp
+    src/test/protocol/STObjectView_test.cpp
     src/test/protocol/STTx_test.cpp
     src/test/protocol/STValidation_test.cpp
     src/test/protocol/SecretKey_test.cpp
@@ -994,6 +1008,7 @@ if (tests)
     #]===============================]
     src/test/shamap/FetchPack_test.cpp
     src/test/shamap/SHAMapSync_test.cpp
+    src/test/shamap/SHAMapTiming_test.cpp
     src/test/shamap/SHAMap_test.cpp
     #[===============================[
        test sources:
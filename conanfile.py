@@ -36,6 +36,7 @@ class Xrpl(ConanFile):
         'soci/4.0.3',
         'sqlite3/3.38.0',
         'zlib/1.2.12',
+        'zstd/1.5.2',
     ]
 
     default_options = {
@@ -85,6 +86,7 @@ class Xrpl(ConanFile):
         'soci:shared': False,
         'soci:with_sqlite3': True,
         'soci:with_boost': True,
+        'zstd:shared': False,
     }
 
     def set_version(self):
@@ -115,6 +115,30 @@ ED25519_FN(ed25519_sign_open) (const unsigned char *m, size_t mlen, const ed2551
 	return ed25519_verify(RS, checkR, 32) ? 0 : -1;
 }
 
+/*
+	Check that a point is in the subgroup of prime order L, i.e. that
+	[L]P is the identity. Scalars are reduced modulo L, so this computes
+	[L - 1](-P) = P - [L]P and compares it with P.
+*/
+int
+ED25519_FN(ed25519_point_has_prime_order) (const ed25519_public_key p) {
+	static const unsigned char order_minus_one[32] = {
+		0xec,0xd3,0xf5,0x5c,0x1a,0x63,0x12,0x58,0xd6,0x9c,0xf7,0xa2,0xde,0xf9,0xde,0x14,
+		0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10
+	};
+	ge25519 ALIGN(16) P, Q;
+	bignum256modm s, zero = {0};
+	unsigned char check[32];
+
+	if (!ge25519_unpack_negative_vartime(&P, p))
+		return 0;
+
+	expand256_modm(s, order_minus_one, 32);
+	ge25519_double_scalarmult_vartime(&Q, &P, s, zero);
+	ge25519_pack(check, &Q);
+	return ed25519_verify(p, check, 32);
+}
+
 #include "ed25519-donna-batchverify.h"
 
 /*
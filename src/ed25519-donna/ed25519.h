@@ -19,6 +19,8 @@ void ed25519_sign(const unsigned char *m, size_t mlen, const ed25519_secret_key
 
 int ed25519_sign_open_batch(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid);
 
+int ed25519_point_has_prime_order(const ed25519_public_key p);
+
 void ed25519_randombytes_unsafe(void *out, size_t count);
 
 void curved25519_scalarmult_basepoint(curved25519_key pk, const curved25519_key e);
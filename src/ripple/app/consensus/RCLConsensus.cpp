@@ -34,6 +34,7 @@
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorList.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/random.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/consensus/LedgerTiming.h>
@@ -450,6 +451,9 @@ RCLConsensus::Adaptor::doAccept(
     prevProposers_ = result.proposers;
     prevRoundTime_ = result.roundTime.read();
 
+    app_.getPerfLog().ledgerPhase(
+        perf::LedgerPhase::establish, result.roundTime.read());
+
     bool closeTimeCorrect;
 
     const bool proposing = mode == ConsensusMode::proposing;
@@ -88,6 +88,12 @@ public:
     std::string
     getEscMeta() const;
 
+    Blob const&
+    getRawMeta() const
+    {
+        return mRawMeta;
+    }
+
     Json::Value const&
     getJson() const
     {
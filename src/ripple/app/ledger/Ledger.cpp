@@ -466,6 +466,27 @@ Ledger::read(Keylet const& k) const
     return sle;
 }
 
+std::optional<STObjectView>
+Ledger::readFields(Keylet const& k) const
+{
+    if (k.key == beast::zero)
+    {
+        assert(false);
+        return std::nullopt;
+    }
+    auto item = stateMap_.peekItem(k.key);
+    if (!item)
+        return std::nullopt;
+    // The view refers to the item's data, and holds the item to keep it
+    auto const data = item->slice();
+    STObjectView view(
+        data, std::shared_ptr<void const>(data.data(), [item](void const*) {}));
+    if (!k.check(safe_cast<LedgerEntryType>(
+            view.getFieldU16(sfLedgerEntryType))))
+        return std::nullopt;
+    return view;
+}
+
 //------------------------------------------------------------------------------
 
 auto
@@ -971,6 +992,9 @@ isFlagLedger(LedgerIndex seq)
     return seq % FLAG_LEDGER_INTERVAL == 0;
 }
 
+// Number of queued ledgers written in one database transaction
+static constexpr std::size_t maxSaveBatch = 16;
+
 static bool
 saveValidatedLedger(
     Application& app,
@@ -994,10 +1018,47 @@ saveValidatedLedger(
 
     // Clients can now trust the database for
     // information about this ledger sequence.
-    app.pendingSaves().finishWork(seq);
+    app.pendingSaves().finishWork(seq, res);
     return res;
 }
 
+/** Save the ledgers queued by pendSaveValidated
+
+    Runs until the queue is empty. Ledgers that were queued while a batch
+    was being written are taken together in the next batch, so that they
+    share a single database transaction.
+*/
+static void
+saveQueuedLedgers(Application& app)
+{
+    auto const db = dynamic_cast<SQLiteDatabase*>(&app.getRelationalDatabase());
+    if (!db)
+        Throw<std::runtime_error>("Failed to get relational database");
+
+    for (;;)
+    {
+        auto const batch = app.pendingSaves().dequeue(maxSaveBatch);
+        if (batch.empty())
+            return;
+
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        ledgers.reserve(batch.size());
+        bool current = false;
+        for (auto const& save : batch)
+        {
+            ledgers.push_back(save.ledger);
+            current = current || save.isCurrent;
+        }
+
+        auto const saved = db->saveValidatedLedgers(ledgers, current);
+
+        // Clients can now trust the database for
+        // information about these ledger sequences.
+        for (std::size_t i = 0; i < ledgers.size(); ++i)
+            app.pendingSaves().finishWork(ledgers[i]->info().seq, saved[i]);
+    }
+}
+
 /** Save, or arrange to save, a fully-validated ledger
     Returns false on error
 */
@@ -1033,15 +1094,23 @@ pendSaveValidated(
         return true;
     }
 
-    // See if we can use the JobQueue.
-    if (!isSynchronous &&
-        app.getJobQueue().addJob(
-            isCurrent ? jtPUBLEDGER : jtPUBOLDLEDGER,
-            std::to_string(ledger->seq()),
-            [&app, ledger, isCurrent]() {
-                saveValidatedLedger(app, ledger, isCurrent);
-            }))
+    if (!isSynchronous)
     {
+        // Hand the ledger to the writer, starting one if none is running.
+        if (!app.pendingSaves().enqueue(ledger, ledger->seq(), isCurrent))
+            return true;
+
+        // See if we can use the JobQueue.
+        if (app.getJobQueue().addJob(
+                isCurrent ? jtPUBLEDGER : jtPUBOLDLEDGER,
+                std::to_string(ledger->seq()),
+                [&app]() { saveQueuedLedgers(app); }))
+        {
+            return true;
+        }
+
+        // The JobQueue won't do the Job.  Do the saves synchronously.
+        saveQueuedLedgers(app);
         return true;
     }
 
@@ -1169,7 +1238,7 @@ flatFetchTransactions(Application& app, std::vector<uint256>& nodestoreHashes)
         Throw<std::runtime_error>(
             "Called flatFetchTransactions but database is not DatabaseNodeImp");
     }
-    auto objs = nodeDb->fetchBatch(nodestoreHashes);
+    auto objs = nodeDb->fetchBatch(nodestoreHashes, 0);
 
     auto end = std::chrono::system_clock::now();
     JLOG(app.journal("Ledger").debug())
@@ -121,6 +121,12 @@ public:
     getPublishedLedgerAge();
     std::chrono::seconds
     getValidatedLedgerAge();
+
+    // The number of ledgers by which the SQL database trails the last
+    // fully validated ledger
+    std::uint32_t
+    getSaveLag();
+
     bool
     isCaughtUp(std::string& reason);
 
@@ -420,12 +426,14 @@ private:
                   collector->make_gauge("LedgerMaster", "Validated_Ledger_Age"))
             , publishedLedgerAge(
                   collector->make_gauge("LedgerMaster", "Published_Ledger_Age"))
+            , saveLag(collector->make_gauge("LedgerMaster", "Save_Lag"))
         {
         }
 
         beast::insight::Hook hook;
         beast::insight::Gauge validatedLedgerAge;
         beast::insight::Gauge publishedLedgerAge;
+        beast::insight::Gauge saveLag;
     };
 
     Stats m_stats;
@@ -437,6 +445,7 @@ private:
         std::lock_guard lock(m_mutex);
         m_stats.validatedLedgerAge.set(getValidatedLedgerAge().count());
         m_stats.publishedLedgerAge.set(getPublishedLedgerAge().count());
+        m_stats.saveLag.set(getSaveLag());
     }
 };
 
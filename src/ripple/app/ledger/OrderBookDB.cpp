@@ -22,6 +22,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Indexes.h>
@@ -61,6 +62,11 @@ OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
 
     if (app_.config().PATH_SEARCH_MAX != 0)
     {
+        {
+            std::lock_guard sl(mLock);
+            scanPending_ = true;
+        }
+
         if (app_.config().standalone())
             update(ledger);
         else
@@ -85,6 +91,16 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
         return;
     }
 
+    auto const start = std::chrono::steady_clock::now();
+
+    // Incremental changes no longer need to be kept for this scan
+    auto const abandon = [this]() {
+        seq_.store(0);
+        std::lock_guard sl(mLock);
+        scanPending_ = false;
+        changes_.clear();
+    };
+
     decltype(allBooks_) allBooks;
     decltype(xrpBooks_) xrpBooks;
 
@@ -104,7 +120,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
             {
                 JLOG(j_.info())
                     << "Update halted because the process is stopping";
-                seq_.store(0);
+                abandon();
                 return;
             }
 
@@ -132,20 +148,190 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     {
         JLOG(j_.info()) << "Missing node in " << ledger->seq()
                         << " during update: " << mn.what();
-        seq_.store(0);
+        abandon();
         return;
     }
 
     JLOG(j_.debug()) << "Update completed (" << ledger->seq() << "): " << cnt
                      << " books found";
 
+    app_.getPerfLog().ledgerPhase(
+        perf::LedgerPhase::orderBook,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+
+    // Books found by the scan but not maintained incrementally, and the
+    // reverse. The latter include books added speculatively by offers
+    // in the open ledger.
+    std::size_t missing = 0;
+    std::size_t extra = 0;
+
+    auto const countMissing = [](auto const& from, auto const& in) {
+        std::size_t count = 0;
+        for (auto const& [issueIn, outs] : from)
+        {
+            auto const it = in.find(issueIn);
+            for (auto const& issueOut : outs)
+            {
+                if (it == in.end() || it->second.count(issueOut) == 0)
+                    ++count;
+            }
+        }
+        return count;
+    };
+
+    bool firstScan;
+
     {
         std::lock_guard sl(mLock);
+
+        // Replay the changes made by ledgers published after the one
+        // that was scanned.
+        for (auto const& change : changes_)
+        {
+            if (change.seq > ledger->seq())
+                applyChange(change, allBooks, xrpBooks);
+        }
+
+        if (seq_.load() == ledger->seq())
+        {
+            scanPending_ = false;
+            changes_.clear();
+        }
+
+        firstScan = scannedSeq_ == 0;
+
+        if (!firstScan)
+        {
+            missing = countMissing(allBooks, allBooks_);
+            extra = countMissing(allBooks_, allBooks);
+        }
+
         allBooks_.swap(allBooks);
         xrpBooks_.swap(xrpBooks);
+        scannedSeq_ = ledger->seq();
+    }
+
+    if (missing != 0)
+    {
+        JLOG(j_.warn()) << "Update found " << missing
+                        << " books missing from the index, " << extra
+                        << " extra";
+    }
+    else if (extra != 0)
+    {
+        JLOG(j_.debug()) << "Update removed " << extra << " extra books";
+    }
+
+    if (firstScan || missing != 0 || extra != 0)
+        app_.getLedgerMaster().newOrderBookDB();
+}
+
+void
+OrderBookDB::applyChange(
+    BookChange const& change,
+    hardened_hash_map<Issue, hardened_hash_set<Issue>>& allBooks,
+    hash_set<Issue>& xrpBooks)
+{
+    auto const& book = change.book;
+
+    if (change.added)
+    {
+        allBooks[book.in].insert(book.out);
+
+        if (isXRP(book.out))
+            xrpBooks.insert(book.in);
+
+        return;
+    }
+
+    if (auto it = allBooks.find(book.in); it != allBooks.end())
+    {
+        it->second.erase(book.out);
+
+        if (it->second.empty())
+            allBooks.erase(it);
+    }
+
+    if (isXRP(book.out))
+        xrpBooks.erase(book.in);
+}
+
+bool
+OrderBookDB::updateBooks(
+    std::shared_ptr<ReadView const> const& ledger,
+    AcceptedLedgerTx const& alTx)
+{
+    std::vector<BookChange> changes;
+
+    for (auto const& node : alTx.getMeta().getNodes())
+    {
+        try
+        {
+            if (node.getFieldU16(sfLedgerEntryType) != ltDIR_NODE)
+                continue;
+
+            // A book exists while the root of any of its quality
+            // directories does.
+            bool const added = node.getFName() == sfCreatedNode;
+
+            if (!added && node.getFName() != sfDeletedNode)
+                continue;
+
+            auto const fields = dynamic_cast<STObject const*>(
+                node.peekAtPField(added ? sfNewFields : sfFinalFields));
+
+            if (!fields || !fields->isFieldPresent(sfExchangeRate) ||
+                !fields->isFieldPresent(sfRootIndex) ||
+                fields->getFieldH256(sfRootIndex) !=
+                    node.getFieldH256(sfLedgerIndex))
+                continue;
+
+            // Fields with default values, such as the currency and issuer
+            // of XRP, are omitted from the metadata of new entries.
+            auto const get = [fields](SField const& field) {
+                uint160 value;
+                if (fields->isFieldPresent(field))
+                    value = fields->getFieldH160(field);
+                return value;
+            };
+
+            Book book;
+            book.in.currency = get(sfTakerPaysCurrency);
+            book.in.account = get(sfTakerPaysIssuer);
+            book.out.currency = get(sfTakerGetsCurrency);
+            book.out.account = get(sfTakerGetsIssuer);
+
+            if (!added)
+            {
+                // Other qualities of the book may remain
+                auto const base = getBookBase(book);
+                if (ledger->succ(base, getQualityNext(base)))
+                    continue;
+            }
+
+            changes.push_back({ledger->seq(), book, added});
+        }
+        catch (std::exception const& ex)
+        {
+            JLOG(j_.info())
+                << "updateBooks: field not found (" << ex.what() << ")";
+        }
     }
 
-    app_.getLedgerMaster().newOrderBookDB();
+    std::lock_guard sl(mLock);
+
+    for (auto const& change : changes)
+    {
+        if (scanPending_)
+            changes_.push_back(change);
+
+        if (change.seq > scannedSeq_)
+            applyChange(change, allBooks_, xrpBooks_);
+    }
+
+    return scannedSeq_ != 0 && !scanPending_ &&
+        ledger->seq() >= scannedSeq_ + checkInterval;
 }
 
 void
@@ -236,6 +422,12 @@ OrderBookDB::processTxn(
     const AcceptedLedgerTx& alTx,
     Json::Value const& jvObj)
 {
+    if (updateBooks(ledger, alTx))
+        setup(ledger);
+
+    if (alTx.getResult() != tesSUCCESS)
+        return;
+
     std::lock_guard sl(mLock);
 
     // For this particular transaction, maintain the set of unique
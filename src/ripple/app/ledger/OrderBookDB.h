@@ -24,16 +24,34 @@
 #include <ripple/app/ledger/BookListeners.h>
 #include <ripple/app/main/Application.h>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
+/** Tracks the order books present in the validated ledger.
+
+    The set of books is built once by scanning every entry of a ledger,
+    and from then on is maintained from the metadata of each validated
+    transaction: a book is added when the root of one of its quality
+    directories is created, and removed when the last one is deleted.
+
+    The ledger is scanned again when the stream of published ledgers has
+    a gap, since the metadata of the skipped ledgers is never seen, and
+    every checkInterval ledgers to verify the incremental index.
+*/
 class OrderBookDB
 {
 public:
+    /** Number of ledgers between scans that check the index. */
+    static constexpr std::uint32_t checkInterval = 25600;
+
     explicit OrderBookDB(Application& app);
 
+    /** Schedule a scan of the given ledger, unless it is unnecessary. */
     void
     setup(std::shared_ptr<ReadView const> const& ledger);
+
+    /** Rebuild the set of books by scanning every entry of a ledger. */
     void
     update(std::shared_ptr<ReadView const> const& ledger);
 
@@ -58,7 +76,12 @@ public:
     BookListeners::pointer
     makeBookListeners(Book const&);
 
-    // see if this txn effects any orderbook
+    /** Process a transaction from a validated ledger.
+
+        Updates the set of books from the transaction's metadata and, if
+        the transaction succeeded, publishes it to the listeners of every
+        book it affects.
+    */
     void
     processTxn(
         std::shared_ptr<ReadView const> const& ledger,
@@ -66,6 +89,27 @@ public:
         Json::Value const& jvObj);
 
 private:
+    // A book added or removed by the transactions of a ledger
+    struct BookChange
+    {
+        std::uint32_t seq;
+        Book book;
+        bool added;
+    };
+
+    // Update the set of books from a transaction's metadata. Returns
+    // `true` if a scan to check the result is due.
+    bool
+    updateBooks(
+        std::shared_ptr<ReadView const> const& ledger,
+        AcceptedLedgerTx const& alTx);
+
+    static void
+    applyChange(
+        BookChange const& change,
+        hardened_hash_map<Issue, hardened_hash_set<Issue>>& allBooks,
+        hash_set<Issue>& xrpBooks);
+
     Application& app_;
 
     // Maps order books by "issue in" to "issue out":
@@ -82,6 +126,16 @@ private:
 
     std::atomic<std::uint32_t> seq_;
 
+    // The ledger that the current set of books was last scanned from.
+    // Changes from this ledger or earlier ones are already reflected.
+    std::uint32_t scannedSeq_ = 0;
+
+    // Whether a scan has been scheduled and not yet completed
+    bool scanPending_ = false;
+
+    // Changes made while a scan is pending, replayed onto its result
+    std::vector<BookChange> changes_;
+
     beast::Journal const j_;
 };
 
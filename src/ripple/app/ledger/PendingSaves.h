@@ -23,23 +23,42 @@
 #include <ripple/protocol/Protocol.h>
 #include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
+class Ledger;
+
 /** Keeps track of which ledgers haven't been fully saved.
 
     During the ledger building process this collection will keep
     track of those ledgers that are being built but have not yet
     been completely written.
+
+    Ledgers saved asynchronously are queued here for a single writer,
+    which takes them off the queue in batches.
 */
 class PendingSaves
 {
+public:
+    /** A ledger waiting in the queue. */
+    struct Save
+    {
+        std::shared_ptr<Ledger const> ledger;
+        bool isCurrent;
+    };
+
 private:
     std::mutex mutable mutex_;
     std::map<LedgerIndex, bool> map_;
     std::condition_variable await_;
 
+    std::map<LedgerIndex, Save> queue_;
+    bool writing_ = false;
+    LedgerIndex lastSaved_ = 0;
+
 public:
     /** Start working on a ledger
 
@@ -69,13 +88,18 @@ public:
         This is called after updating the SQLite indexes.
         The tracking of the work in progress is removed and
         threads awaiting completion are notified.
+
+        @param saved Whether the ledger was saved. Only a saved ledger
+                     counts towards lastSaved.
     */
     void
-    finishWork(LedgerIndex seq)
+    finishWork(LedgerIndex seq, bool saved = true)
     {
         std::lock_guard lock(mutex_);
 
         map_.erase(seq);
+        if (saved && seq > lastSaved_)
+            lastSaved_ = seq;
         await_.notify_all();
     }
 
@@ -127,6 +151,71 @@ public:
         } while (true);
     }
 
+    /** Queue a ledger for the writer
+
+        A ledger queued earlier with the same sequence is replaced.
+
+        @return 'true' if the caller must start the writer
+    */
+    bool
+    enqueue(
+        std::shared_ptr<Ledger const> ledger,
+        LedgerIndex seq,
+        bool isCurrent)
+    {
+        std::lock_guard lock(mutex_);
+
+        queue_[seq] = Save{std::move(ledger), isCurrent};
+        if (writing_)
+            return false;
+
+        writing_ = true;
+        return true;
+    }
+
+    /** Take the next batch of queued ledgers
+
+        Called by the writer. Ledgers are taken newest first and work is
+        started on each of them; a ledger that was saved synchronously in
+        the meantime is dropped. When the queue is empty the writer is
+        considered stopped and an empty batch is returned.
+
+        @param maxSize The largest number of ledgers to return.
+    */
+    std::vector<Save>
+    dequeue(std::size_t maxSize)
+    {
+        std::lock_guard lock(mutex_);
+
+        std::vector<Save> batch;
+        while (!queue_.empty() && batch.size() < maxSize)
+        {
+            auto const last = std::prev(queue_.end());
+
+            auto it = map_.find(last->first);
+            if ((it != map_.end()) && !it->second)
+            {
+                it->second = true;
+                batch.push_back(std::move(last->second));
+            }
+
+            queue_.erase(last);
+        }
+
+        if (batch.empty())
+            writing_ = false;
+
+        return batch;
+    }
+
+    /** Return the highest sequence that was saved successfully. */
+    LedgerIndex
+    lastSaved() const
+    {
+        std::lock_guard lock(mutex_);
+        return lastSaved_;
+    }
+
     /** Get a snapshot of the pending saves
 
         Each entry in the returned map corresponds to a ledger
@@ -21,10 +21,15 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/ledger/impl/SpeculativeApply.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/basics/PerfLog.h>
+#include <ripple/protocol/Book.h>
 #include <ripple/protocol/Feature.h>
+#include <ripple/protocol/Indexes.h>
+#include <algorithm>
 
 namespace ripple {
 
@@ -45,6 +50,9 @@ buildLedgerImpl(
     beast::Journal j,
     ApplyTxs&& applyTxs)
 {
+    using namespace std::chrono;
+    auto const start = steady_clock::now();
+
     auto built = std::make_shared<Ledger>(*parent, closeTime);
 
     if (built->isFlagLedger() && built->rules().enabled(featureNegativeUNL))
@@ -67,8 +75,20 @@ buildLedgerImpl(
         // Write the final version of all modified SHAMap
         // nodes to the node store to preserve the new LCL
 
-        int const asf = built->stateMap().flushDirty(hotACCOUNT_NODE);
-        int const tmf = built->txMap().flushDirty(hotTRANSACTION_NODE);
+        // The calling thread is one of the workers
+        int const helpers = (app.config().LEDGER_FLUSH_WORKERS > 0
+                                 ? app.config().LEDGER_FLUSH_WORKERS
+                                 : 4) -
+            1;
+        auto& jobQueue = app.getJobQueue();
+        auto const flushStart = steady_clock::now();
+        int const asf = built->stateMap().flushDirty(
+            hotACCOUNT_NODE, jobQueue, helpers);
+        int const tmf = built->txMap().flushDirty(
+            hotTRANSACTION_NODE, jobQueue, helpers);
+        app.getPerfLog().ledgerPhase(
+            perf::LedgerPhase::flush,
+            duration_cast<microseconds>(steady_clock::now() - flushStart));
         JLOG(j.debug()) << "Flushed " << asf << " accounts and " << tmf
                         << " transaction nodes";
     }
@@ -80,9 +100,200 @@ buildLedgerImpl(
         built->read(keylet::fees()));
     built->setAccepted(closeTime, closeResolution, closeTimeCorrect);
 
+    app.getPerfLog().ledgerPhase(
+        perf::LedgerPhase::build,
+        duration_cast<microseconds>(steady_clock::now() - start));
+
     return built;
 }
 
+/** Add the keys of ledger entries a transaction is likely to read.
+
+    The keys are a guess made from the transaction's fields alone; a key
+    that is missing from the ledger, or never read, only costs a lookup.
+*/
+static void
+addTouchedKeys(STTx const& tx, std::vector<uint256>& keys)
+{
+    auto const account = tx.getAccountID(sfAccount);
+    keys.push_back(keylet::account(account).key);
+    keys.push_back(keylet::ownerDir(account).key);
+
+    std::optional<AccountID> destination;
+    if (tx.isFieldPresent(sfDestination))
+    {
+        destination = tx.getAccountID(sfDestination);
+        keys.push_back(keylet::account(*destination).key);
+    }
+
+    // The issuers of any issued amounts and the trust lines to them
+    for (auto const field :
+         {&sfAmount,
+          &sfSendMax,
+          &sfDeliverMin,
+          &sfLimitAmount,
+          &sfTakerPays,
+          &sfTakerGets})
+    {
+        if (!tx.isFieldPresent(*field))
+            continue;
+
+        auto const& amount = tx.getFieldAmount(*field);
+        if (isXRP(amount))
+            continue;
+
+        auto const& issue = amount.issue();
+        keys.push_back(keylet::account(issue.account).key);
+        if (issue.account != account)
+            keys.push_back(keylet::line(account, issue).key);
+        if (destination && issue.account != *destination)
+            keys.push_back(keylet::line(*destination, issue).key);
+    }
+
+    // The book an offer crosses and the book it is placed in
+    if (tx.getTxnType() == ttOFFER_CREATE &&
+        tx.isFieldPresent(sfTakerPays) && tx.isFieldPresent(sfTakerGets))
+    {
+        Book const book{tx[sfTakerPays].issue(), tx[sfTakerGets].issue()};
+        if (isConsistent(book))
+        {
+            keys.push_back(getBookBase(reversed(book)));
+            keys.push_back(getBookBase(book));
+        }
+    }
+
+    if (tx.isFieldPresent(sfOfferSequence))
+        keys.push_back(keylet::offer(account, tx[sfOfferSequence]).key);
+
+    if (tx.isFieldPresent(sfTicketSequence))
+        keys.push_back(keylet::ticket(account, tx[sfTicketSequence]).key);
+
+    if (tx.isFieldPresent(sfSigners))
+    {
+        for (auto const& signer : tx.getFieldArray(sfSigners))
+            keys.push_back(
+                keylet::account(signer.getAccountID(sfAccount)).key);
+    }
+}
+
+/** Load the state entries that a set of transactions will touch.
+
+    Applying a transaction reads its entries one at a time, each read
+    walking the state map and fetching any missing node from the backend.
+    Loading the paths to every entry up front turns those reads into one
+    batched backend read per level of the map.
+*/
+template <class Txs>
+static void
+prefetchTouched(
+    std::shared_ptr<Ledger const> const& built,
+    Txs const& txs,
+    beast::Journal j)
+{
+    using namespace std::chrono;
+    auto const start = steady_clock::now();
+
+    std::vector<uint256> keys;
+    for (auto const& item : txs)
+        addTouchedKeys(*item.second, keys);
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    auto const fetched = built->stateMap().prefetch(keys);
+
+    JLOG(j.debug()) << "Prefetched " << keys.size() << " entries for "
+                    << txs.size() << " transactions, " << fetched
+                    << " nodes read in "
+                    << duration_cast<milliseconds>(steady_clock::now() - start)
+                           .count()
+                    << "ms";
+}
+
+/** Apply one pass of consensus transactions speculatively in parallel.
+
+    The transactions are taken in windows, and each window is applied with
+    applySpeculatively, which leaves the view as a serial pass would.
+
+    @return number of transactions applied
+*/
+static int
+applyPassSpeculatively(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    int pass,
+    bool certainRetry,
+    int workers,
+    beast::Journal j)
+{
+    // Each window holds a view per transaction until it is merged
+    std::size_t const windowSize = 8 * workers;
+
+    int changes = 0;
+    std::vector<CanonicalTXSet::const_iterator> window;
+    std::vector<std::shared_ptr<STTx const>> batch;
+
+    auto it = txns.begin();
+    while (it != txns.end())
+    {
+        window.clear();
+        batch.clear();
+
+        while (it != txns.end() && window.size() < windowSize)
+        {
+            auto const txid = it->first.getTXID();
+
+            try
+            {
+                if (pass == 0 && built->txExists(txid))
+                {
+                    it = txns.erase(it);
+                    continue;
+                }
+            }
+            catch (std::exception const& ex)
+            {
+                JLOG(j.warn())
+                    << "Transaction " << txid << " throws: " << ex.what();
+                failed.insert(txid);
+                it = txns.erase(it);
+                continue;
+            }
+
+            window.push_back(it);
+            batch.push_back(it->second);
+            ++it;
+        }
+
+        auto const results =
+            applySpeculatively(app, view, batch, certainRetry, workers, j);
+
+        for (std::size_t i = 0; i < window.size(); ++i)
+        {
+            switch (results[i])
+            {
+                case ApplyResult::Success:
+                    txns.erase(window[i]);
+                    ++changes;
+                    break;
+
+                case ApplyResult::Fail:
+                    failed.insert(window[i]->first.getTXID());
+                    txns.erase(window[i]);
+                    break;
+
+                case ApplyResult::Retry:
+                    break;
+            }
+        }
+    }
+
+    return changes;
+}
+
 /** Apply a set of consensus transactions to a ledger.
 
   @param app Handle to application
@@ -104,6 +315,7 @@ applyTransactions(
 {
     bool certainRetry = true;
     std::size_t count = 0;
+    int const workers = app.config().LEDGER_APPLY_WORKERS;
 
     // Attempt to apply all of the retriable transactions
     for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
@@ -112,43 +324,51 @@ applyTransactions(
                         << " begins (" << txns.size() << " transactions)";
         int changes = 0;
 
-        auto it = txns.begin();
-
-        while (it != txns.end())
+        if (workers > 1)
         {
-            auto const txid = it->first.getTXID();
+            changes = applyPassSpeculatively(
+                app, built, txns, failed, view, pass, certainRetry, workers, j);
+        }
+        else
+        {
+            auto it = txns.begin();
 
-            try
+            while (it != txns.end())
             {
-                if (pass == 0 && built->txExists(txid))
-                {
-                    it = txns.erase(it);
-                    continue;
-                }
+                auto const txid = it->first.getTXID();
 
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNONE, j))
+                try
                 {
-                    case ApplyResult::Success:
+                    if (pass == 0 && built->txExists(txid))
+                    {
                         it = txns.erase(it);
-                        ++changes;
-                        break;
-
-                    case ApplyResult::Fail:
-                        failed.insert(txid);
-                        it = txns.erase(it);
-                        break;
-
-                    case ApplyResult::Retry:
-                        ++it;
+                        continue;
+                    }
+
+                    switch (applyTransaction(
+                        app, view, *it->second, certainRetry, tapNONE, j))
+                    {
+                        case ApplyResult::Success:
+                            it = txns.erase(it);
+                            ++changes;
+                            break;
+
+                        case ApplyResult::Fail:
+                            failed.insert(txid);
+                            it = txns.erase(it);
+                            break;
+
+                        case ApplyResult::Retry:
+                            ++it;
+                    }
+                }
+                catch (std::exception const& ex)
+                {
+                    JLOG(j.warn())
+                        << "Transaction " << txid << " throws: " << ex.what();
+                    failed.insert(txid);
+                    it = txns.erase(it);
                 }
-            }
-            catch (std::exception const& ex)
-            {
-                JLOG(j.warn())
-                    << "Transaction " << txid << " throws: " << ex.what();
-                failed.insert(txid);
-                it = txns.erase(it);
             }
         }
 
@@ -200,6 +420,8 @@ buildLedger(
             JLOG(j.debug())
                 << "Attempting to apply " << txns.size() << " transactions";
 
+            prefetchTouched(built, txns, j);
+
             auto const applied =
                 applyTransactions(app, built, txns, failedTxns, accum, j);
 
@@ -232,6 +454,8 @@ buildLedger(
         app,
         j,
         [&](OpenView& accum, std::shared_ptr<Ledger> const& built) {
+            prefetchTouched(built, replayData.orderedTxns(), j);
+
             for (auto& tx : replayData.orderedTxns())
                 applyTransaction(app, accum, *tx.second, false, applyFlags, j);
         });
@@ -301,6 +301,20 @@ LedgerMaster::getValidatedLedgerAge()
     return ret;
 }
 
+std::uint32_t
+LedgerMaster::getSaveLag()
+{
+    if (app_.config().reporting())
+        return 0;
+
+    auto const lastSaved = app_.pendingSaves().lastSaved();
+    auto const valid = mValidLedgerSeq.load();
+    if (lastSaved == 0 || valid <= lastSaved)
+        return 0;
+
+    return valid - lastSaved;
+}
+
 bool
 LedgerMaster::isCaughtUp(std::string& reason)
 {
@@ -0,0 +1,377 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/impl/SpeculativeApply.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/ledger/RawView.h>
+
+#include <algorithm>
+#include <set>
+
+namespace ripple {
+
+namespace {
+
+/** A view that records what is read through it. */
+class ReadSetView final : public ReadView
+{
+    ReadView const& base_;
+
+    // Keys of the state entries read
+    mutable std::vector<key_type> keys_;
+
+    // Ranges (first, last] of keys whose presence was read. An empty
+    // upper bound means the range is unbounded.
+    mutable std::vector<std::pair<key_type, std::optional<key_type>>>
+        ranges_;
+
+    // Keys of the transactions read
+    mutable std::vector<key_type> txs_;
+
+    // Whether all of the state or transactions were iterated
+    mutable bool all_ = false;
+
+public:
+    explicit ReadSetView(ReadView const& base) : base_(base)
+    {
+    }
+
+    /** Returns `true` if a change could affect what was read.
+
+        @param written Keys of the state entries changed.
+        @param txs Keys of the transactions inserted.
+    */
+    bool
+    conflicts(std::set<key_type> const& written, std::set<key_type> const& txs)
+        const
+    {
+        if (all_)
+            return !written.empty() || !txs.empty();
+
+        for (auto const& key : keys_)
+        {
+            if (written.count(key))
+                return true;
+        }
+
+        for (auto const& [first, last] : ranges_)
+        {
+            auto const it = written.upper_bound(first);
+            if (it != written.end() && (!last || *it <= *last))
+                return true;
+        }
+
+        for (auto const& key : txs_)
+        {
+            if (txs.count(key))
+                return true;
+        }
+
+        return false;
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        keys_.push_back(k.key);
+        return base_.exists(k);
+    }
+
+    std::optional<key_type>
+    succ(key_type const& key, std::optional<key_type> const& last)
+        const override
+    {
+        auto next = base_.succ(key, last);
+        // Adding or removing an entry up to the one found changes the result
+        ranges_.emplace_back(key, next ? next : last);
+        return next;
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        keys_.push_back(k.key);
+        return base_.read(k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        all_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        all_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override
+    {
+        all_ = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        all_ = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        all_ = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        txs_.push_back(key);
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        txs_.push_back(key);
+        return base_.txRead(key);
+    }
+};
+
+/** A view that records what is written through it. */
+class WriteSetView final : public TxsRawView
+{
+    TxsRawView& to_;
+    std::set<uint256>& written_;
+    std::set<uint256>& txs_;
+
+public:
+    WriteSetView(
+        TxsRawView& to,
+        std::set<uint256>& written,
+        std::set<uint256>& txs)
+        : to_(to), written_(written), txs_(txs)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        to_.rawErase(sle);
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        to_.rawInsert(sle);
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        to_.rawReplace(sle);
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const& fee) override
+    {
+        to_.rawDestroyXRP(fee);
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+        std::shared_ptr<Serializer const> const& metaData) override
+    {
+        txs_.insert(key);
+        to_.rawTxInsert(key, txn, metaData);
+    }
+};
+
+}  // namespace
+
+std::vector<ApplyResult>
+applySpeculatively(
+    Application& app,
+    OpenView& view,
+    std::vector<std::shared_ptr<STTx const>> const& txns,
+    bool retryAssured,
+    int workers,
+    beast::Journal j)
+{
+    struct Attempt
+    {
+        std::unique_ptr<ReadSetView> reads;
+        std::unique_ptr<OpenView> view;
+        std::size_t ordinal = 0;
+        ApplyResult result = ApplyResult::Retry;
+        bool done = false;
+    };
+
+    std::vector<Attempt> attempts(txns.size());
+
+    // Apply the chosen transactions on the calling thread and up to
+    // `workers - 1` jobs
+    auto speculate = [&](std::vector<std::size_t> const& chosen) {
+        app.getJobQueue().forEach(
+            jtLEDGER_APPLY,
+            "applySpeculatively",
+            chosen.size(),
+            workers > 1 ? workers - 1 : 0,
+            [&](std::size_t i) {
+                auto const index = chosen[i];
+                auto& attempt = attempts[index];
+
+                attempt.view.reset();
+                attempt.reads = std::make_unique<ReadSetView>(view);
+                attempt.view = std::make_unique<OpenView>(
+                    attempt.reads.get(), attempt.ordinal);
+                try
+                {
+                    attempt.result = applyTransaction(
+                        app,
+                        *attempt.view,
+                        *txns[index],
+                        retryAssured,
+                        tapNONE,
+                        j);
+                    attempt.done = true;
+                }
+                catch (...)
+                {
+                    // Applied again serially
+                    attempt.done = false;
+                }
+            });
+    };
+
+    auto const base = view.txCount();
+
+    // First assume that every transaction will be applied
+    {
+        std::vector<std::size_t> chosen;
+        chosen.reserve(txns.size());
+        for (std::size_t i = 0; i < txns.size(); ++i)
+        {
+            if (isPseudoTx(*txns[i]))
+                continue;
+            attempts[i].ordinal = base + i;
+            chosen.push_back(i);
+        }
+        speculate(chosen);
+    }
+
+    // Then correct the ordinals of those applied after a transaction that
+    // was not. The ordinal only affects the metadata, so the results do
+    // not change.
+    {
+        std::vector<std::size_t> chosen;
+        auto ordinal = base;
+        for (std::size_t i = 0; i < txns.size(); ++i)
+        {
+            auto& attempt = attempts[i];
+            if (attempt.done && attempt.result != ApplyResult::Success)
+                continue;
+
+            if (attempt.done && attempt.ordinal != ordinal)
+            {
+                attempt.ordinal = ordinal;
+                chosen.push_back(i);
+            }
+            ++ordinal;
+        }
+        speculate(chosen);
+    }
+
+    // Merge the views in order, applying again whatever may have changed
+    std::vector<ApplyResult> results;
+    results.reserve(txns.size());
+    std::set<uint256> written;
+    std::set<uint256> inserted;
+    std::size_t serial = 0;
+
+    for (std::size_t i = 0; i < txns.size(); ++i)
+    {
+        auto& attempt = attempts[i];
+        WriteSetView to(view, written, inserted);
+
+        if (attempt.done &&
+            (attempt.result != ApplyResult::Success ||
+             attempt.ordinal == view.txCount()) &&
+            !attempt.reads->conflicts(written, inserted))
+        {
+            attempt.view->apply(to);
+            results.push_back(attempt.result);
+        }
+        else
+        {
+            ++serial;
+            OpenView again(&view, view.txCount());
+            results.push_back(applyTransaction(
+                app, again, *txns[i], retryAssured, tapNONE, j));
+            again.apply(to);
+        }
+
+        attempt.view.reset();
+        attempt.reads.reset();
+    }
+
+    JLOG(j.debug()) << "Applied " << txns.size() << " transactions on "
+                    << workers << " workers, " << serial << " serially";
+
+    return results;
+}
+
+}  // namespace ripple
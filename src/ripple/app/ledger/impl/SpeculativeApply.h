@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_SPECULATIVEAPPLY_H_INCLUDED
+#define RIPPLE_APP_LEDGER_SPECULATIVEAPPLY_H_INCLUDED
+
+#include <ripple/app/tx/apply.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/STTx.h>
+
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+class Application;
+
+/** Apply transactions in order, speculatively in parallel.
+
+    Each transaction is first applied by a worker to a view of its own on
+    top of `view`, which records the state entries and transactions the
+    application reads. The views are then applied to `view` in order.
+    A transaction is applied again, serially, when a transaction before it
+    wrote an entry it read, or when the ordinal it was applied at is not
+    its position in `view`. The resulting `view` is therefore identical to
+    one produced by applying the transactions one after the other.
+
+    Pseudo-transactions are never applied speculatively, since applying
+    them has effects outside the view.
+
+    @param app The application.
+    @param view The view to apply the transactions to.
+    @param txns The transactions, in the order they must be applied.
+    @param retryAssured Whether the transactions will be retried.
+    @param workers Number of workers to apply on: the calling thread and
+                   up to `workers - 1` jobs.
+    @param j Journal for logging.
+    @return The result for each transaction, in order.
+*/
+std::vector<ApplyResult>
+applySpeculatively(
+    Application& app,
+    OpenView& view,
+    std::vector<std::shared_ptr<STTx const>> const& txns,
+    bool retryAssured,
+    int workers,
+    beast::Journal j);
+
+}  // namespace ripple
+
+#endif
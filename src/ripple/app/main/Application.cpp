@@ -326,7 +326,8 @@ public:
               m_collectorManager->group("jobq"),
               logs_->journal("JobQueue"),
               *logs_,
-              *perfLog_))
+              *perfLog_,
+              config_->LOCKFREE_JOB_QUEUE))
 
         , m_nodeStoreScheduler(*m_jobQueue)
 
@@ -122,6 +122,49 @@ inline constexpr std::array<char const*, 8> TxDBInit{
 
      "END TRANSACTION;"}};
 
+// An alternative layout of the transaction database, selected with the
+// compact_tx_tables setting, which stores transaction IDs and accounts as
+// binary rather than as hex and base58 text. AccountTransactions is
+// clustered on the key that account_tx pages through, so that a page of
+// an account's history is read from consecutive rows.
+//
+// Transactions keeps its rowid: its rows hold the raw transaction and
+// metadata, and a WITHOUT ROWID table stores whole rows in the interior
+// pages of its b-tree.
+inline constexpr std::array<char const*, 7> TxDBInitCompact{
+    {"BEGIN TRANSACTION;",
+
+     "CREATE TABLE IF NOT EXISTS Transactions (          \
+        TransID     BLOB PRIMARY KEY,                   \
+        TransType   CHARACTER(24),                      \
+        FromAcct    BLOB,                               \
+        FromSeq     BIGINT UNSIGNED,                    \
+        LedgerSeq   BIGINT UNSIGNED,                    \
+        Status      CHARACTER(1),                       \
+        RawTxn      BLOB,                               \
+        TxnMeta     BLOB                                \
+    );",
+     "CREATE INDEX IF NOT EXISTS TxLgrIndex ON           \
+        Transactions(LedgerSeq);",
+
+     "CREATE TABLE IF NOT EXISTS AccountTransactions (   \
+        Account     BLOB,                               \
+        LedgerSeq   BIGINT UNSIGNED,                    \
+        TxnSeq      INTEGER,                            \
+        TransID     BLOB,                               \
+        PRIMARY KEY (Account, LedgerSeq, TxnSeq)        \
+    ) WITHOUT ROWID;",
+     "CREATE INDEX IF NOT EXISTS AcctTxIDIndex ON        \
+        AccountTransactions(TransID);",
+     "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON         \
+        AccountTransactions(LedgerSeq);",
+
+     "END TRANSACTION;"}};
+
+// A transaction database in the compact layout, written by the
+// --migrate_txdb command until it replaces the transaction database
+inline constexpr auto TxDBMigrationName{"transaction_compact.db"};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // The Ledger Meta database maps ledger hashes to shard indexes
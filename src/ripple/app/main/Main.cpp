@@ -19,6 +19,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/app/main/DBInit.h>
+#include <ripple/app/rdb/MigrateTxDB.h>
 #include <ripple/app/rdb/Vacuum.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/StringUtilities.h>
@@ -391,6 +392,11 @@ run(int argc, char** argv)
         po::value<std::string>(),
         "Load the specified ledger file.")(
         "load", "Load the current ledger from the local DB.")(
+        "migrate_txdb",
+        po::value<std::string>()->implicit_value("copy"),
+        "Copy the transaction db into the compact layout, which can be done "
+        "while rippled is running. Use --migrate_txdb=finish with rippled "
+        "stopped to replace the transaction db with the copy.")(
         "net", "Get the initial ledger from the network.")(
         "nodetoshard", "Import node store into shards")(
         "replay", "Replay a ledger close.")(
@@ -603,6 +609,37 @@ run(int argc, char** argv)
         return 0;
     }
 
+    if (vm.count("migrate_txdb"))
+    {
+        if (config->standalone())
+        {
+            std::cerr << "migrate_txdb not applicable in standalone mode.\n";
+            return -1;
+        }
+
+        auto const step = vm["migrate_txdb"].as<std::string>();
+        if (step != "copy" && step != "finish")
+        {
+            std::cerr << "migrate_txdb must be \"copy\" or \"finish\".\n";
+            return -1;
+        }
+
+        try
+        {
+            auto setup = setup_DatabaseCon(*config);
+            if (!doMigrateTxDB(setup, step == "finish"))
+                return -1;
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "exception " << e.what() << " in function " << __func__
+                      << std::endl;
+            return -1;
+        }
+
+        return 0;
+    }
+
     if (vm.count("start"))
     {
         config->START_UP = Config::FRESH;
@@ -26,7 +26,14 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/container/aged_unordered_map.h>
 
+#include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
+
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -49,6 +56,11 @@ namespace ripple {
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    The table is split into shards by hash, each with its own lock, so that
+    peers receiving different messages rarely contend. Entries expire
+    separately in each shard: an insertion into a shard removes the entries
+    of that shard which have not been accessed within the hold time.
 */
 class HashRouter
 {
@@ -56,6 +68,9 @@ public:
     // The type here *MUST* match the type of Peer::id_t
     using PeerShortID = std::uint32_t;
 
+    /** The default number of shards. */
+    static constexpr std::size_t defaultShards = 16;
+
 private:
     /** An entry in the routing table.
      */
@@ -89,7 +104,9 @@ private:
         std::set<PeerShortID>
         releasePeerSet()
         {
-            return std::move(peers_);
+            std::set<PeerShortID> peers(peers_.begin(), peers_.end());
+            PeerSet{}.swap(peers_);
+            return peers;
         }
 
         /** Return seated relay time point if the message has been relayed */
@@ -126,8 +143,15 @@ private:
         }
 
     private:
+        // Most entries are only seen from a few peers, so those are stored
+        // inline; sorted, so membership checks need no extra index.
+        using PeerSet = boost::container::flat_set<
+            PeerShortID,
+            std::less<PeerShortID>,
+            boost::container::small_vector<PeerShortID, 4>>;
+
         int flags_ = 0;
-        std::set<PeerShortID> peers_;
+        PeerSet peers_;
         // This could be generalized to a map, if more
         // than one flag needs to expire independently.
         std::optional<Stopwatch::time_point> relayed_;
@@ -143,10 +167,10 @@ public:
         return 300s;
     }
 
-    HashRouter(Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds)
-        : suppressionMap_(clock), holdTime_(entryHoldTimeInSeconds)
-    {
-    }
+    HashRouter(
+        Stopwatch& clock,
+        std::chrono::seconds entryHoldTimeInSeconds,
+        std::size_t shards = defaultShards);
 
     HashRouter&
     operator=(HashRouter const&) = delete;
@@ -206,19 +230,35 @@ public:
     shouldRelay(uint256 const& key);
 
 private:
+    struct Shard
+    {
+        std::mutex mutex;
+
+        // Stores the suppressed hashes of this shard and their
+        // expiration time
+        beast::aged_unordered_map<
+            uint256,
+            Entry,
+            Stopwatch::clock_type,
+            hardened_hash<strong_hash>>
+            suppressionMap;
+
+        explicit Shard(Stopwatch& clock) : suppressionMap(clock)
+        {
+        }
+    };
+
+    Shard&
+    shard(uint256 const& key);
+
     // pair.second indicates whether the entry was created
     std::pair<Entry&, bool>
-    emplace(uint256 const&);
+    emplace(Shard& shard, uint256 const&);
 
-    std::mutex mutable mutex_;
+    std::vector<std::unique_ptr<Shard>> shards_;
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<
-        uint256,
-        Entry,
-        Stopwatch::clock_type,
-        hardened_hash<strong_hash>>
-        suppressionMap_;
+    // Selects a shard; seeded so that peers cannot pick the shard of a hash
+    hardened_hash<strong_hash> const hasher_;
 
     std::chrono::seconds const holdTime_;
 };
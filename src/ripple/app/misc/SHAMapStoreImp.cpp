@@ -23,6 +23,7 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/rdb/State.h>
 #include <ripple/app/rdb/backend/SQLiteDatabase.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/core/Pg.h>
@@ -358,6 +359,8 @@ SHAMapStoreImp::run()
                 << app_.getOPs().strOperatingMode(false) << " age "
                 << ledgerMaster_->getValidatedLedgerAge().count() << 's';
 
+            auto const start = std::chrono::steady_clock::now();
+
             clearPrior(lastRotated);
             if (healthWait() == stopping)
                 return;
@@ -419,6 +422,11 @@ SHAMapStoreImp::run()
                     return std::move(newBackend);
                 });
 
+            app_.getPerfLog().ledgerPhase(
+                perf::LedgerPhase::rotate,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start));
+
             JLOG(journal_.warn()) << "finished rotation " << validatedSeq;
         }
     }
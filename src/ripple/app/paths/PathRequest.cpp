@@ -251,7 +251,10 @@ PathRequest::doCreate(
     {
         valid = isValid(cache);
         if (!hasCompletion() && valid)
-            doUpdate(cache, true);
+        {
+            PathfinderCache pathfinders(cache, app_);
+            doUpdate(pathfinders, true);
+        }
     }
 
     if (auto stream = m_journal.debug())
@@ -463,41 +466,14 @@ PathRequest::doAborting() const
     JLOG(m_journal.info()) << iIdentifier << " aborting early";
 }
 
-std::unique_ptr<Pathfinder> const&
-PathRequest::getPathFinder(
-    std::shared_ptr<RippleLineCache> const& cache,
-    hash_map<Currency, std::unique_ptr<Pathfinder>>& currency_map,
-    Currency const& currency,
-    STAmount const& dst_amount,
-    int const level,
-    std::function<bool(void)> const& continueCallback)
-{
-    auto i = currency_map.find(currency);
-    if (i != currency_map.end())
-        return i->second;
-    auto pathfinder = std::make_unique<Pathfinder>(
-        cache,
-        *raSrcAccount,
-        *raDstAccount,
-        currency,
-        std::nullopt,
-        dst_amount,
-        saSendMax,
-        app_);
-    if (pathfinder->findPaths(level, continueCallback))
-        pathfinder->computePathRanks(max_paths_, continueCallback);
-    else
-        pathfinder.reset();  // It's a bad request - clear it.
-    return currency_map[currency] = std::move(pathfinder);
-}
-
 bool
 PathRequest::findPaths(
-    std::shared_ptr<RippleLineCache> const& cache,
+    PathfinderCache& pathfinders,
     int const level,
     Json::Value& jvArray,
     std::function<bool(void)> const& continueCallback)
 {
+    auto const& cache = pathfinders.getLineCache();
     auto sourceCurrencies = sciSourceCurrencies;
     if (sourceCurrencies.empty() && saSendMax)
     {
@@ -520,7 +496,6 @@ PathRequest::findPaths(
     }
 
     auto const dst_amount = convertAmount(saDstAmount, convert_all_);
-    hash_map<Currency, std::unique_ptr<Pathfinder>> currency_map;
     for (auto const& issue : sourceCurrencies)
     {
         if (continueCallback && !continueCallback())
@@ -529,12 +504,14 @@ PathRequest::findPaths(
             << iIdentifier
             << " Trying to find paths: " << STAmount(issue, 1).getFullText();
 
-        auto& pathfinder = getPathFinder(
-            cache,
-            currency_map,
+        auto const pathfinder = pathfinders.getPathfinder(
+            *raSrcAccount,
+            *raDstAccount,
             issue.currency,
             dst_amount,
+            saSendMax,
             level,
+            max_paths_,
             continueCallback);
         if (!pathfinder)
         {
@@ -655,11 +632,12 @@ PathRequest::findPaths(
 
 Json::Value
 PathRequest::doUpdate(
-    std::shared_ptr<RippleLineCache> const& cache,
+    PathfinderCache& pathfinders,
     bool fast,
     std::function<bool(void)> const& continueCallback)
 {
     using namespace std::chrono;
+    auto const& cache = pathfinders.getLineCache();
     JLOG(m_journal.debug())
         << iIdentifier << " update " << (fast ? "fast" : "normal");
 
@@ -726,7 +704,7 @@ PathRequest::doUpdate(
     JLOG(m_journal.debug()) << iIdentifier << " processing at level " << iLevel;
 
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray, continueCallback))
+    if (findPaths(pathfinders, iLevel, jvArray, continueCallback))
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move(jvArray);
@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/Pathfinder.h>
+#include <ripple/app/paths/PathfinderCache.h>
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/json/json_value.h>
 #include <ripple/net/InfoSub.h>
@@ -95,10 +96,10 @@ public:
     void
     doAborting() const;
 
-    // update jvStatus
+    // update jvStatus, sharing pathfinders with other requests
     Json::Value
     doUpdate(
-        std::shared_ptr<RippleLineCache> const&,
+        PathfinderCache& pathfinders,
         bool fast,
         std::function<bool(void)> const& continueCallback = {});
     InfoSub::pointer
@@ -110,21 +111,12 @@ private:
     bool
     isValid(std::shared_ptr<RippleLineCache> const& crCache);
 
-    std::unique_ptr<Pathfinder> const&
-    getPathFinder(
-        std::shared_ptr<RippleLineCache> const&,
-        hash_map<Currency, std::unique_ptr<Pathfinder>>&,
-        Currency const&,
-        STAmount const&,
-        int const,
-        std::function<bool(void)> const&);
-
     /** Finds and sets a PathSet in the JSON argument.
         Returns false if the source currencies are inavlid.
     */
     bool
     findPaths(
-        std::shared_ptr<RippleLineCache> const&,
+        PathfinderCache&,
         int const,
         Json::Value&,
         std::function<bool(void)> const&);
@@ -22,14 +22,20 @@
 #include <ripple/app/paths/PathRequests.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/JobTypes.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/shamap/SHAMapMissingNode.h>
 #include <algorithm>
 
 namespace ripple {
 
+// The most state entries a ledger may differ from the trust line graph's
+// ledger in for the graph to be updated rather than built again
+static constexpr int maxGraphChanges = 100000;
+
 /** Get the current RippleLineCache, updating it if necessary.
     Get the correct ledger to use.
 */
@@ -59,11 +65,100 @@ PathRequests::getLineCache(
         // weak_ptr, and will immediately discard it if there are no other
         // references.
         lineCache_ = lineCache = std::make_shared<RippleLineCache>(
-            ledger, app_.journal("RippleLineCache"));
+            ledger, app_.journal("RippleLineCache"), getGraph(*ledger));
     }
     return lineCache;
 }
 
+std::shared_ptr<TrustLineGraph const>
+PathRequests::getGraph(ReadView const& ledger) const
+{
+    std::lock_guard sl(mLock);
+    if (!graph_ || ledger.open() ||
+        graph_->getLedger()->info().hash != ledger.info().hash)
+        return nullptr;
+    return graph_;
+}
+
+void
+PathRequests::updateGraph(std::shared_ptr<ReadView const> const& view)
+{
+    auto const ledger = std::dynamic_pointer_cast<Ledger const>(view);
+    if (!ledger || ledger->open())
+        return;
+
+    std::shared_ptr<TrustLineGraph const> graph;
+    {
+        std::lock_guard sl(mLock);
+        if (graphPending_)
+            return;
+        graph = graph_;
+    }
+
+    if (graph)
+    {
+        if (graph->getLedger()->info().hash == ledger->info().hash)
+            return;
+
+        std::shared_ptr<TrustLineGraph const> next;
+        try
+        {
+            next = graph->update(ledger, maxGraphChanges);
+        }
+        catch (SHAMapMissingNode const& e)
+        {
+            // Updating the graph again would fail the same way, so it is
+            // built from scratch below.
+            JLOG(mJournal.info())
+                << "updating the trust line graph: " << e.what();
+        }
+        if (next)
+        {
+            JLOG(mJournal.debug())
+                << "updated the trust line graph to ledger " << ledger->seq()
+                << " with " << next->size() << " trust lines";
+            std::lock_guard sl(mLock);
+            graph_ = std::move(next);
+            return;
+        }
+    }
+
+    // Reading every trust line of a ledger takes a while, so the graph is
+    // built by a job while paths are found without it. The next update
+    // brings the graph up to date with the ledgers closed meanwhile.
+    {
+        std::lock_guard sl(mLock);
+        graph_.reset();
+        graphPending_ = true;
+    }
+    JLOG(mJournal.debug()) << "building the trust line graph for ledger "
+                           << ledger->seq();
+    if (!app_.getJobQueue().addJob(
+            jtPATH_GRAPH, "TrustLineGraph::make", [this, ledger]() {
+                std::shared_ptr<TrustLineGraph const> graph;
+                try
+                {
+                    graph = TrustLineGraph::make(ledger);
+                    JLOG(mJournal.debug())
+                        << "built the trust line graph for ledger "
+                        << ledger->seq() << " with " << graph->size()
+                        << " trust lines";
+                }
+                catch (SHAMapMissingNode const& e)
+                {
+                    JLOG(mJournal.info())
+                        << "building the trust line graph: " << e.what();
+                }
+                std::lock_guard sl(mLock);
+                graph_ = std::move(graph);
+                graphPending_ = false;
+            }))
+    {
+        std::lock_guard sl(mLock);
+        graphPending_ = false;
+    }
+}
+
 void
 PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
 {
@@ -73,6 +168,8 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
     std::vector<PathRequest::wptr> requests;
     std::shared_ptr<RippleLineCache> cache;
 
+    updateGraph(inLedger);
+
     // Get the ledger and cache we should be using
     {
         std::lock_guard sl(mLock);
@@ -80,13 +177,16 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
         cache = getLineCache(inLedger, true);
     }
 
+    // Requests updated against the same ledger share their pathfinders
+    auto pathfinders = std::make_unique<PathfinderCache>(cache, app_);
+
     bool newRequests = app_.getLedgerMaster().isNewPathRequest();
-    bool mustBreak = false;
+    std::atomic<bool> mustBreak = false;
 
     JLOG(mJournal.trace()) << "updateAll seq=" << cache->getLedger()->seq()
                            << ", " << requests.size() << " requests";
 
-    int processed = 0, removed = 0;
+    std::atomic<int> processed = 0, removed = 0;
 
     auto getSubscriber =
         [](PathRequest::pointer const& request) -> InfoSub::pointer {
@@ -99,91 +199,93 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
         return nullptr;
     };
 
-    do
-    {
-        JLOG(mJournal.trace()) << "updateAll looping";
-        for (auto const& wr : requests)
-        {
-            if (app_.getJobQueue().isStopping())
-                break;
-
-            auto request = wr.lock();
-            bool remove = true;
-            JLOG(mJournal.trace())
-                << "updateAll request " << (request ? "" : "not ") << "found";
+    // Requests are independent, so several are updated at once
+    auto update = [&](std::size_t index) {
+        auto request = requests[index].lock();
+        bool remove = true;
+        JLOG(mJournal.trace())
+            << "updateAll request " << (request ? "" : "not ") << "found";
 
-            if (request)
+        if (request)
+        {
+            auto continueCallback = [&getSubscriber, &request]() {
+                // This callback is used by doUpdate to determine whether to
+                // continue working. If getSubscriber returns null, that
+                // indicates that this request is no longer relevant.
+                return (bool)getSubscriber(request);
+            };
+            if (!request->needsUpdate(newRequests, cache->getLedger()->seq()))
+                remove = false;
+            else
             {
-                auto continueCallback = [&getSubscriber, &request]() {
-                    // This callback is used by doUpdate to determine whether to
-                    // continue working. If getSubscriber returns null, that
-                    // indicates that this request is no longer relevant.
-                    return (bool)getSubscriber(request);
-                };
-                if (!request->needsUpdate(
-                        newRequests, cache->getLedger()->seq()))
-                    remove = false;
-                else
+                if (auto ipSub = getSubscriber(request))
                 {
-                    if (auto ipSub = getSubscriber(request))
+                    if (!ipSub->getConsumer().warn())
                     {
-                        if (!ipSub->getConsumer().warn())
+                        // Release the shared ptr to the subscriber so that
+                        // it can be freed if the client disconnects, and
+                        // thus fail to lock later.
+                        ipSub.reset();
+                        Json::Value update = request->doUpdate(
+                            *pathfinders, false, continueCallback);
+                        request->updateComplete();
+                        update[jss::type] = "path_find";
+                        if ((ipSub = getSubscriber(request)))
                         {
-                            // Release the shared ptr to the subscriber so that
-                            // it can be freed if the client disconnects, and
-                            // thus fail to lock later.
-                            ipSub.reset();
-                            Json::Value update = request->doUpdate(
-                                cache, false, continueCallback);
-                            request->updateComplete();
-                            update[jss::type] = "path_find";
-                            if ((ipSub = getSubscriber(request)))
-                            {
-                                ipSub->send(update, false);
-                                remove = false;
-                                ++processed;
-                            }
+                            ipSub->send(update, false);
+                            remove = false;
+                            ++processed;
                         }
                     }
-                    else if (request->hasCompletion())
-                    {
-                        // One-shot request with completion function
-                        request->doUpdate(cache, false);
-                        request->updateComplete();
-                        ++processed;
-                    }
+                }
+                else if (request->hasCompletion())
+                {
+                    // One-shot request with completion function
+                    request->doUpdate(*pathfinders, false);
+                    request->updateComplete();
+                    ++processed;
                 }
             }
+        }
 
-            if (remove)
-            {
-                std::lock_guard sl(mLock);
+        if (remove)
+        {
+            std::lock_guard sl(mLock);
 
-                // Remove any dangling weak pointers or weak
-                // pointers that refer to this path request.
-                auto ret = std::remove_if(
-                    requests_.begin(),
-                    requests_.end(),
-                    [&removed, &request](auto const& wl) {
-                        auto r = wl.lock();
-
-                        if (r && r != request)
-                            return false;
-                        ++removed;
-                        return true;
-                    });
-
-                requests_.erase(ret, requests_.end());
-            }
+            // Remove any dangling weak pointers or weak
+            // pointers that refer to this path request.
+            auto ret = std::remove_if(
+                requests_.begin(),
+                requests_.end(),
+                [&removed, &request](auto const& wl) {
+                    auto r = wl.lock();
+
+                    if (r && r != request)
+                        return false;
+                    ++removed;
+                    return true;
+                });
+
+            requests_.erase(ret, requests_.end());
+        }
 
-            mustBreak =
-                !newRequests && app_.getLedgerMaster().isNewPathRequest();
+        // We weren't handling new requests and then
+        // there was a new request
+        if (!newRequests && app_.getLedgerMaster().isNewPathRequest())
+            mustBreak = true;
+    };
 
-            // We weren't handling new requests and then
-            // there was a new request
-            if (mustBreak)
-                break;
-        }
+    do
+    {
+        JLOG(mJournal.trace()) << "updateAll looping";
+        mustBreak = false;
+        app_.getJobQueue().forEach(
+            jtPATH_UPDATE,
+            "PathRequest::update",
+            requests.size(),
+            JobTypes::instance().get(jtPATH_UPDATE).limit(),
+            update,
+            [&]() { return mustBreak || app_.getJobQueue().isStopping(); });
 
         if (mustBreak)
         {  // a new request came in while we were working
@@ -205,9 +307,19 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
             std::lock_guard sl(mLock);
 
             if (requests_.empty())
+            {
+                // The graph would have to be updated for every ledger
+                // until paths are next requested, so let it go.
+                graph_.reset();
                 break;
+            }
             requests = requests_;
-            cache = getLineCache(cache->getLedger(), false);
+            if (auto const latest = getLineCache(cache->getLedger(), false);
+                latest != cache)
+            {
+                cache = latest;
+                pathfinders = std::make_unique<PathfinderCache>(cache, app_);
+            }
         }
     } while (!app_.getJobQueue().isStopping());
 
@@ -303,14 +415,17 @@ PathRequests::doLegacyPathRequest(
     Json::Value const& request)
 {
     auto cache = std::make_shared<RippleLineCache>(
-        inLedger, app_.journal("RippleLineCache"));
+        inLedger, app_.journal("RippleLineCache"), getGraph(*inLedger));
 
     auto req = std::make_shared<PathRequest>(
         app_, [] {}, consumer, ++mLastIdentifier, *this, mJournal);
 
     auto [valid, jvRes] = req->doCreate(cache, request);
     if (valid)
-        jvRes = req->doUpdate(cache, false);
+    {
+        PathfinderCache pathfinders(cache, app_);
+        jvRes = req->doUpdate(pathfinders, false);
+    }
     return std::move(jvRes);
 }
 
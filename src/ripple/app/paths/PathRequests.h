@@ -22,14 +22,21 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/app/paths/PathRequest.h>
+#include <ripple/app/paths/PathfinderCache.h>
 #include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/app/paths/TrustLineGraph.h>
 #include <ripple/core/Job.h>
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <vector>
 
 namespace ripple {
 
+namespace test {
+class Path_test;
+}  // namespace test
+
 class PathRequests
 {
 public:
@@ -102,6 +109,20 @@ private:
     void
     insertPathRequest(PathRequest::pointer const&);
 
+    /** Bring the trust line graph up to date with a closed ledger.
+
+        The graph is updated from the entries that changed since its
+        ledger. If there is no graph, the ledgers differ too much, or either
+        ledger is missing nodes, a new graph is built by a job, and lines
+        are read from ledgers until it is ready.
+    */
+    void
+    updateGraph(std::shared_ptr<ReadView const> const& ledger);
+
+    /** The trust line graph of a ledger, or nullptr if there is none. */
+    std::shared_ptr<TrustLineGraph const>
+    getGraph(ReadView const& ledger) const;
+
     Application& app_;
     beast::Journal mJournal;
 
@@ -114,9 +135,15 @@ private:
     // Use a RippleLineCache
     std::weak_ptr<RippleLineCache> lineCache_;
 
+    // The trust lines of the latest ledger paths were updated in
+    std::shared_ptr<TrustLineGraph const> graph_;
+    bool graphPending_ = false;
+
     std::atomic<int> mLastIdentifier;
 
     std::recursive_mutex mutable mLock;
+
+    friend class test::Path_test;
 };
 
 }  // namespace ripple
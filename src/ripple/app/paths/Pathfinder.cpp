@@ -449,6 +449,9 @@ Pathfinder::computePathRanks(
     }
 
     rankPaths(maxPaths, mCompletePaths, mPathRanks, continueCallback);
+
+    // The search is done; the pathfinder may be kept to rank extra paths.
+    m_loadEvent.reset();
 }
 
 static bool
@@ -490,7 +493,7 @@ Pathfinder::rankPaths(
     int maxPaths,
     STPathSet const& paths,
     std::vector<PathRank>& rankedPaths,
-    std::function<bool(void)> const& continueCallback)
+    std::function<bool(void)> const& continueCallback) const
 {
     JLOG(j_.trace()) << "rankPaths with " << paths.size() << " candidates, and "
                      << maxPaths << " maximum";
@@ -569,7 +572,7 @@ Pathfinder::getBestPaths(
     STPath& fullLiquidityPath,
     STPathSet const& extraPaths,
     AccountID const& srcIssuer,
-    std::function<bool(void)> const& continueCallback)
+    std::function<bool(void)> const& continueCallback) const
 {
     JLOG(j_.debug()) << "findPaths: " << mCompletePaths.size() << " paths and "
                      << extraPaths.size() << " extras";
@@ -721,7 +724,7 @@ Pathfinder::getPathsOut(
     if (!inserted)
         return it->second;
 
-    auto sleAccount = mLedger->read(keylet::account(account));
+    auto const sleAccount = mLedger->readFields(keylet::account(account));
 
     if (!sleAccount)
         return 0;
@@ -887,8 +890,8 @@ Pathfinder::isNoRipple(
     AccountID const& toAccount,
     Currency const& currency)
 {
-    auto sleRipple =
-        mLedger->read(keylet::line(toAccount, fromAccount, currency));
+    auto const sleRipple =
+        mLedger->readFields(keylet::line(toAccount, fromAccount, currency));
 
     auto const flag(
         (toAccount > fromAccount) ? lsfHighNoRipple : lsfLowNoRipple);
@@ -970,7 +973,8 @@ Pathfinder::addLink(
         else
         {
             // search for accounts to add
-            auto const sleEnd = mLedger->read(keylet::account(uEndAccount));
+            auto const sleEnd =
+                mLedger->readFields(keylet::account(uEndAccount));
 
             if (sleEnd)
             {
@@ -71,6 +71,8 @@ public:
 
        On return, if fullLiquidityPath is not empty, then it contains the best
        additional single path which can consume all the liquidity.
+
+       Once the paths are ranked, this may be called from several threads.
     */
     STPathSet
     getBestPaths(
@@ -78,7 +80,7 @@ public:
         STPath& fullLiquidityPath,
         STPathSet const& extraPaths,
         AccountID const& srcIssuer,
-        std::function<bool(void)> const& continueCallback = {});
+        std::function<bool(void)> const& continueCallback = {}) const;
 
     enum NodeType {
         nt_SOURCE,     // The source account: with an issuer account, if needed.
@@ -191,7 +193,7 @@ private:
         int maxPaths,
         STPathSet const& paths,
         std::vector<PathRank>& rankedPaths,
-        std::function<bool(void)> const& continueCallback);
+        std::function<bool(void)> const& continueCallback) const;
 
     AccountID mSrcAccount;
     AccountID mDstAccount;
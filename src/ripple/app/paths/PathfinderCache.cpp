@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/PathfinderCache.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/digest.h>
+
+namespace ripple {
+
+PathfinderCache::PathfinderCache(
+    std::shared_ptr<RippleLineCache> cache,
+    Application& app)
+    : cache_(std::move(cache)), app_(app)
+{
+}
+
+std::shared_ptr<Pathfinder const>
+PathfinderCache::getPathfinder(
+    AccountID const& srcAccount,
+    AccountID const& dstAccount,
+    Currency const& srcCurrency,
+    STAmount const& dstAmount,
+    std::optional<STAmount> const& srcAmount,
+    int searchLevel,
+    int maxPaths,
+    std::function<bool(void)> const& continueCallback)
+{
+    // The search depends on the amounts as well as on the accounts and
+    // currencies: paths are ranked by how much of the amount they carry.
+    Serializer s;
+    s.addBitString(srcAccount);
+    s.addBitString(dstAccount);
+    s.addBitString(srcCurrency);
+    dstAmount.add(s);
+    s.add8(srcAmount ? 1 : 0);
+    if (srcAmount)
+        srcAmount->add(s);
+    s.add32(searchLevel);
+    s.add32(maxPaths);
+    auto const key = sha512Half(s.slice());
+
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard lock(mutex_);
+        auto& e = entries_[key];
+        if (!e)
+            e = std::make_shared<Entry>();
+        entry = e;
+    }
+
+    std::lock_guard lock(entry->mutex);
+    if (entry->found)
+        return entry->pathfinder;
+
+    auto pathfinder = std::make_shared<Pathfinder>(
+        cache_,
+        srcAccount,
+        dstAccount,
+        srcCurrency,
+        std::nullopt,
+        dstAmount,
+        srcAmount,
+        app_);
+    if (pathfinder->findPaths(searchLevel, continueCallback))
+        pathfinder->computePathRanks(maxPaths, continueCallback);
+    else
+        pathfinder.reset();  // It's a bad request - clear it.
+
+    // A search that was abandoned may have missed paths, so the next
+    // request that needs it searches again.
+    entry->found = !continueCallback || continueCallback();
+    entry->pathfinder = pathfinder;
+    return pathfinder;
+}
+
+std::size_t
+PathfinderCache::size() const
+{
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+}  // namespace ripple
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_PATHS_PATHFINDERCACHE_H_INCLUDED
+#define RIPPLE_APP_PATHS_PATHFINDERCACHE_H_INCLUDED
+
+#include <ripple/app/paths/Pathfinder.h>
+#include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/basics/CountedObject.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/base_uint.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace ripple {
+
+/** Pathfinders shared by the path requests updated against one ledger.
+
+    Many clients ask for paths between the same accounts for the same
+    amount. The paths a pathfinder finds and ranks depend only on its
+    parameters and the ledger, so requests that agree on them share one
+    pathfinder and each picks its best paths from it.
+
+    Safe to use from several threads at once. Each pathfinder is built
+    once; other threads that need it wait until it is built.
+*/
+class PathfinderCache final : public CountedObject<PathfinderCache>
+{
+public:
+    PathfinderCache(std::shared_ptr<RippleLineCache> cache, Application& app);
+
+    std::shared_ptr<RippleLineCache> const&
+    getLineCache() const
+    {
+        return cache_;
+    }
+
+    /** Get a pathfinder that has found and ranked its paths.
+
+        @param srcAccount The account sending the payment.
+        @param dstAccount The account receiving the payment.
+        @param srcCurrency The currency the payment is sent in.
+        @param dstAmount The amount to deliver.
+        @param srcAmount The most the source is willing to send, if limited.
+        @param searchLevel The depth of the search.
+        @param maxPaths The number of paths to rank.
+        @param continueCallback Returns false if the caller no longer needs
+                                the paths.
+        @return The pathfinder, or nullptr if the request has no paths.
+    */
+    std::shared_ptr<Pathfinder const>
+    getPathfinder(
+        AccountID const& srcAccount,
+        AccountID const& dstAccount,
+        Currency const& srcCurrency,
+        STAmount const& dstAmount,
+        std::optional<STAmount> const& srcAmount,
+        int searchLevel,
+        int maxPaths,
+        std::function<bool(void)> const& continueCallback);
+
+    /** The number of distinct searches requested. */
+    std::size_t
+    size() const;
+
+private:
+    struct Entry
+    {
+        std::mutex mutex;
+        // False until a search runs to completion
+        bool found = false;
+        std::shared_ptr<Pathfinder const> pathfinder;
+    };
+
+    std::shared_ptr<RippleLineCache> const cache_;
+    Application& app_;
+
+    std::mutex mutable mutex_;
+    hash_map<uint256, std::shared_ptr<Entry>> entries_;
+};
+
+}  // namespace ripple
+
+#endif
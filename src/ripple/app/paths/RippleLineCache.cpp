@@ -25,10 +25,14 @@ namespace ripple {
 
 RippleLineCache::RippleLineCache(
     std::shared_ptr<ReadView const> const& ledger,
-    beast::Journal j)
-    : ledger_(ledger), journal_(j)
+    beast::Journal j,
+    std::shared_ptr<TrustLineGraph const> graph)
+    : ledger_(ledger), graph_(std::move(graph)), journal_(j)
 {
-    JLOG(journal_.debug()) << "created for ledger " << ledger_->info().seq;
+    assert(!graph_ || graph_->getLedger()->info().hash == ledger_->info().hash);
+    JLOG(journal_.debug()) << "created for ledger " << ledger_->info().seq
+                           << (graph_ ? " with" : " without")
+                           << " a trust line graph";
 }
 
 RippleLineCache::~RippleLineCache()
@@ -100,8 +104,9 @@ RippleLineCache::getRippleLines(
     if (inserted)
     {
         assert(it->second == nullptr);
-        auto lines =
-            PathFindTrustLine::getItems(accountID, *ledger_, direction);
+        auto lines = graph_
+            ? graph_->getItems(accountID, direction)
+            : PathFindTrustLine::getItems(accountID, *ledger_, direction);
         if (lines.size())
         {
             it->second = std::make_shared<std::vector<PathFindTrustLine>>(
@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/TrustLine.h>
+#include <ripple/app/paths/TrustLineGraph.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/hardened_hash.h>
 
@@ -36,9 +37,18 @@ namespace ripple {
 class RippleLineCache final : public CountedObject<RippleLineCache>
 {
 public:
+    /** Create a cache of the trust lines of a ledger.
+
+        @param l The ledger.
+        @param j The journal.
+        @param graph The trust line graph of the ledger, if there is one.
+                     Lines are then taken from the graph instead of being
+                     read from the ledger.
+    */
     explicit RippleLineCache(
         std::shared_ptr<ReadView const> const& l,
-        beast::Journal j);
+        beast::Journal j,
+        std::shared_ptr<TrustLineGraph const> graph = nullptr);
     ~RippleLineCache();
 
     std::shared_ptr<ReadView const> const&
@@ -67,6 +77,7 @@ private:
 
     ripple::hardened_hash<> hasher_;
     std::shared_ptr<ReadView const> ledger_;
+    std::shared_ptr<TrustLineGraph const> const graph_;
 
     beast::Journal journal_;
 
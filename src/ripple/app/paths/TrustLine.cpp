@@ -39,6 +39,24 @@ TrustLineBase::TrustLineBase(
         mBalance.negate();
 }
 
+TrustLineBase::TrustLineBase(
+    uint256 const& key,
+    STAmount const& lowLimit,
+    STAmount const& highLimit,
+    STAmount const& balance,
+    std::uint32_t flags,
+    AccountID const& viewAccount)
+    : key_(key)
+    , mLowLimit(lowLimit)
+    , mHighLimit(highLimit)
+    , mBalance(balance)
+    , mFlags(flags)
+    , mViewLowest(mLowLimit.getIssuer() == viewAccount)
+{
+    if (!mViewLowest)
+        mBalance.negate();
+}
+
 Json::Value
 TrustLineBase::getJson(int)
 {
@@ -48,6 +66,17 @@ TrustLineBase::getJson(int)
     return ret;
 }
 
+PathFindTrustLine::PathFindTrustLine(
+    uint256 const& key,
+    STAmount const& lowLimit,
+    STAmount const& highLimit,
+    STAmount const& balance,
+    std::uint32_t flags,
+    AccountID const& viewAccount)
+    : TrustLineBase(key, lowLimit, highLimit, balance, flags, viewAccount)
+{
+}
+
 std::optional<PathFindTrustLine>
 PathFindTrustLine::makeItem(
     AccountID const& accountID,
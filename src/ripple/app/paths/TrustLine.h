@@ -59,6 +59,14 @@ protected:
         std::shared_ptr<SLE const> const& sle,
         AccountID const& viewAccount);
 
+    TrustLineBase(
+        uint256 const& key,
+        STAmount const& lowLimit,
+        STAmount const& highLimit,
+        STAmount const& balance,
+        std::uint32_t flags,
+        AccountID const& viewAccount);
+
     ~TrustLineBase() = default;
     TrustLineBase(TrustLineBase const&) = default;
     TrustLineBase&
@@ -189,6 +197,19 @@ class PathFindTrustLine final : public TrustLineBase,
 public:
     PathFindTrustLine() = delete;
 
+    /** Create a trust line from the fields of its ledger entry.
+
+        The balance is the one stored in the entry, which is from the
+        perspective of the low account.
+    */
+    PathFindTrustLine(
+        uint256 const& key,
+        STAmount const& lowLimit,
+        STAmount const& highLimit,
+        STAmount const& balance,
+        std::uint32_t flags,
+        AccountID const& viewAccount);
+
     static std::optional<PathFindTrustLine>
     makeItem(AccountID const& accountID, std::shared_ptr<SLE const> const& sle);
 
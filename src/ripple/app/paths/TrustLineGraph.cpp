@@ -0,0 +1,315 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/TrustLineGraph.h>
+#include <ripple/basics/safe_cast.h>
+#include <ripple/protocol/STObjectView.h>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+
+namespace ripple {
+
+namespace {
+
+// Lines and accounts are each split into this many buckets. A ledger
+// changes a few hundred lines, so small buckets keep the cost of copying
+// the buckets they touch low.
+constexpr std::size_t bucketCount = 1 << 16;
+
+template <class Key>
+std::size_t
+bucketOf(Key const& key)
+{
+    return (std::size_t{key.data()[0]} << 8) | key.data()[1];
+}
+
+}  // namespace
+
+TrustLineGraph::TrustLineGraph(std::shared_ptr<Ledger const> ledger)
+    : ledger_(std::move(ledger)), lines_(bucketCount), accounts_(bucketCount)
+{
+}
+
+std::optional<TrustLineGraph::Line>
+TrustLineGraph::makeLine(SHAMapItem const& item)
+{
+    // Only the fields the path finder uses are decoded
+    STObjectView const view(item.slice(), nullptr);
+    if (safe_cast<LedgerEntryType>(view.getFieldU16(sfLedgerEntryType)) !=
+        ltRIPPLE_STATE)
+        return std::nullopt;
+
+    auto const lowLimit = view.getFieldAmount(sfLowLimit);
+    auto const highLimit = view.getFieldAmount(sfHighLimit);
+    return Line{
+        item.key(),
+        lowLimit.getIssuer(),
+        highLimit.getIssuer(),
+        lowLimit.getCurrency(),
+        lowLimit.iou(),
+        highLimit.iou(),
+        view.getFieldAmount(sfBalance).iou(),
+        view.getFieldU32(sfFlags)};
+}
+
+std::shared_ptr<TrustLineGraph::AccountBucket const>
+TrustLineGraph::makeBucket(std::vector<Edge> const& edges)
+{
+    if (edges.empty())
+        return nullptr;
+
+    auto bucket = std::make_shared<AccountBucket>();
+    bucket->keys.reserve(edges.size());
+    for (auto const& [account, key] : edges)
+    {
+        if (bucket->accounts.empty() || bucket->accounts.back() != account)
+        {
+            bucket->accounts.push_back(account);
+            bucket->offsets.push_back(
+                static_cast<std::uint32_t>(bucket->keys.size()));
+        }
+        bucket->keys.push_back(key);
+    }
+    bucket->offsets.push_back(static_cast<std::uint32_t>(bucket->keys.size()));
+    bucket->accounts.shrink_to_fit();
+    bucket->offsets.shrink_to_fit();
+    return bucket;
+}
+
+std::shared_ptr<TrustLineGraph const>
+TrustLineGraph::make(std::shared_ptr<Ledger const> const& ledger)
+{
+    std::shared_ptr<TrustLineGraph> graph(new TrustLineGraph(ledger));
+
+    std::vector<LineBucket> lines(bucketCount);
+    std::vector<std::vector<Edge>> edges(bucketCount);
+    ledger->stateMap().visitLeaves(
+        [&lines, &edges](boost::intrusive_ptr<SHAMapItem const> const& item) {
+            if (auto line = makeLine(*item))
+            {
+                edges[bucketOf(line->low)].emplace_back(line->low, line->key);
+                edges[bucketOf(line->high)].emplace_back(
+                    line->high, line->key);
+                lines[bucketOf(line->key)].push_back(std::move(*line));
+            }
+        });
+
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        if (!lines[i].empty())
+        {
+            std::sort(
+                lines[i].begin(),
+                lines[i].end(),
+                [](Line const& a, Line const& b) { return a.key < b.key; });
+            lines[i].shrink_to_fit();
+            graph->lineCount_ += lines[i].size();
+            graph->lines_[i] =
+                std::make_shared<LineBucket const>(std::move(lines[i]));
+        }
+
+        std::sort(edges[i].begin(), edges[i].end());
+        graph->accounts_[i] = makeBucket(edges[i]);
+        edges[i] = {};
+    }
+
+    return graph;
+}
+
+std::shared_ptr<TrustLineGraph const>
+TrustLineGraph::update(
+    std::shared_ptr<Ledger const> const& ledger,
+    int maxChanges) const
+{
+    SHAMap::Delta differences;
+    if (!ledger->stateMap().compare(
+            ledger_->stateMap(), differences, maxChanges))
+        return nullptr;
+
+    std::shared_ptr<TrustLineGraph> graph(new TrustLineGraph(ledger));
+    graph->lines_ = lines_;
+    graph->accounts_ = accounts_;
+    graph->lineCount_ = lineCount_;
+
+    // The changed lines, and the lines added to and removed from accounts,
+    // by bucket. Lines are visited in key order, so each bucket's changes
+    // are sorted.
+    std::map<std::size_t, std::vector<std::pair<uint256, std::optional<Line>>>>
+        changedLines;
+    std::map<std::size_t, std::vector<Edge>> addedEdges;
+    std::map<std::size_t, std::vector<Edge>> removedEdges;
+
+    for (auto const& [key, items] : differences)
+    {
+        // The first item is in the new ledger, the second in ours
+        auto line = items.first ? makeLine(*items.first) : std::nullopt;
+        auto const previous =
+            items.second ? makeLine(*items.second) : std::nullopt;
+        if (!line && !previous)
+            continue;
+
+        // A line's accounts are part of its key, so the lines of an account
+        // only change when a line is created or deleted.
+        if (!line || !previous)
+        {
+            auto const& changed = line ? *line : *previous;
+            auto& edges = line ? addedEdges : removedEdges;
+            edges[bucketOf(changed.low)].emplace_back(changed.low, key);
+            edges[bucketOf(changed.high)].emplace_back(changed.high, key);
+            if (line)
+                ++graph->lineCount_;
+            else
+                --graph->lineCount_;
+        }
+
+        changedLines[bucketOf(key)].emplace_back(key, std::move(line));
+    }
+
+    for (auto const& [index, changes] : changedLines)
+    {
+        LineBucket const none;
+        auto const& old = lines_[index] ? *lines_[index] : none;
+
+        LineBucket bucket;
+        bucket.reserve(old.size() + changes.size());
+        auto from = old.begin();
+        for (auto const& [key, line] : changes)
+        {
+            while (from != old.end() && from->key < key)
+                bucket.push_back(*from++);
+            if (from != old.end() && from->key == key)
+                ++from;
+            if (line)
+                bucket.push_back(*line);
+        }
+        bucket.insert(bucket.end(), from, old.end());
+
+        graph->lines_[index] = bucket.empty()
+            ? nullptr
+            : std::make_shared<LineBucket const>(std::move(bucket));
+    }
+
+    auto updateBucket = [&](std::size_t index) {
+        std::vector<Edge> edges;
+        if (auto const& old = accounts_[index])
+        {
+            edges.reserve(old->keys.size());
+            for (std::size_t i = 0; i < old->accounts.size(); ++i)
+            {
+                for (auto j = old->offsets[i]; j < old->offsets[i + 1]; ++j)
+                    edges.emplace_back(old->accounts[i], old->keys[j]);
+            }
+        }
+
+        if (auto const added = addedEdges.find(index);
+            added != addedEdges.end())
+            edges.insert(
+                edges.end(), added->second.begin(), added->second.end());
+        std::sort(edges.begin(), edges.end());
+
+        if (auto removed = removedEdges.find(index);
+            removed != removedEdges.end())
+        {
+            std::sort(removed->second.begin(), removed->second.end());
+            edges.erase(
+                std::remove_if(
+                    edges.begin(),
+                    edges.end(),
+                    [&removed](Edge const& edge) {
+                        return std::binary_search(
+                            removed->second.begin(),
+                            removed->second.end(),
+                            edge);
+                    }),
+                edges.end());
+        }
+
+        graph->accounts_[index] = makeBucket(edges);
+    };
+
+    for (auto const& [index, edges] : addedEdges)
+        updateBucket(index);
+    for (auto const& [index, edges] : removedEdges)
+    {
+        if (!addedEdges.count(index))
+            updateBucket(index);
+    }
+
+    return graph;
+}
+
+auto
+TrustLineGraph::findLine(uint256 const& key) const -> Line const*
+{
+    auto const& bucket = lines_[bucketOf(key)];
+    if (!bucket)
+        return nullptr;
+
+    auto const it = std::lower_bound(
+        bucket->begin(),
+        bucket->end(),
+        key,
+        [](Line const& line, uint256 const& key) { return line.key < key; });
+    if (it == bucket->end() || it->key != key)
+        return nullptr;
+    return &*it;
+}
+
+std::vector<PathFindTrustLine>
+TrustLineGraph::getItems(AccountID const& accountID, LineDirection direction)
+    const
+{
+    auto const& bucket = accounts_[bucketOf(accountID)];
+    if (!bucket)
+        return {};
+
+    auto const it = std::lower_bound(
+        bucket->accounts.begin(), bucket->accounts.end(), accountID);
+    if (it == bucket->accounts.end() || *it != accountID)
+        return {};
+    auto const i = std::distance(bucket->accounts.begin(), it);
+
+    std::vector<PathFindTrustLine> items;
+    items.reserve(bucket->offsets[i + 1] - bucket->offsets[i]);
+    for (auto j = bucket->offsets[i]; j < bucket->offsets[i + 1]; ++j)
+    {
+        auto const line = findLine(bucket->keys[j]);
+        assert(line);
+        if (!line)
+            continue;
+
+        PathFindTrustLine item(
+            line->key,
+            STAmount(line->lowLimit, {line->currency, line->low}),
+            STAmount(line->highLimit, {line->currency, line->high}),
+            STAmount(line->balance, {line->currency, noAccount()}),
+            line->flags,
+            accountID);
+        if (direction == LineDirection::outgoing || !item.getNoRipple())
+            items.push_back(std::move(item));
+    }
+    // Callers cache the lines, so free up any unneeded capacity
+    items.shrink_to_fit();
+
+    return items;
+}
+
+}  // namespace ripple
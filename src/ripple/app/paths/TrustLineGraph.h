@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_PATHS_TRUSTLINEGRAPH_H_INCLUDED
+#define RIPPLE_APP_PATHS_TRUSTLINEGRAPH_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/paths/TrustLine.h>
+#include <ripple/basics/CountedObject.h>
+#include <ripple/basics/IOUAmount.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/UintTypes.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace ripple {
+
+/** The trust lines of a closed ledger, indexed by account.
+
+    Reading the trust lines of an account from a ledger walks its owner
+    directory and decodes every entry in it, and a deep path search does
+    that for thousands of accounts. The graph holds the lines of every
+    account in compact arrays, so the path finder follows them without
+    reading the ledger.
+
+    A graph is immutable, so it can be shared by threads without locking.
+    Lines and accounts are split into buckets by the first bytes of their
+    keys. The graph of a later ledger is built from the entries that
+    changed since an earlier graph, and shares every bucket they did not
+    touch.
+*/
+class TrustLineGraph final : public CountedObject<TrustLineGraph>
+{
+public:
+    /** Build the graph of a ledger by reading all of its trust lines.
+
+        @throws SHAMapMissingNode if the ledger's state is incomplete.
+    */
+    static std::shared_ptr<TrustLineGraph const>
+    make(std::shared_ptr<Ledger const> const& ledger);
+
+    /** Build the graph of another ledger from this one.
+
+        @param ledger The ledger to build the graph of.
+        @param maxChanges The most state entries the ledgers may differ in.
+        @return The graph, or nullptr if the ledgers differ in more entries,
+                in which case calling make is cheaper.
+        @throws SHAMapMissingNode if either ledger's state is incomplete.
+    */
+    std::shared_ptr<TrustLineGraph const>
+    update(std::shared_ptr<Ledger const> const& ledger, int maxChanges) const;
+
+    /** The ledger the graph describes. */
+    std::shared_ptr<Ledger const> const&
+    getLedger() const
+    {
+        return ledger_;
+    }
+
+    /** The number of trust lines in the ledger. */
+    std::size_t
+    size() const
+    {
+        return lineCount_;
+    }
+
+    /** The trust lines of an account.
+
+        Returns the lines PathFindTrustLine::getItems would read from the
+        ledger, ordered by key rather than by their place in the account's
+        owner directory.
+    */
+    std::vector<PathFindTrustLine>
+    getItems(AccountID const& accountID, LineDirection direction) const;
+
+private:
+    // The fields of a trust line the path finder uses
+    struct Line
+    {
+        uint256 key;
+        AccountID low;
+        AccountID high;
+        Currency currency;
+        IOUAmount lowLimit;
+        IOUAmount highLimit;
+        // From the perspective of the low account, as in the ledger
+        IOUAmount balance;
+        std::uint32_t flags;
+    };
+
+    // Lines whose keys share their first bytes, sorted by key
+    using LineBucket = std::vector<Line>;
+
+    // The lines of accounts whose IDs share their first bytes. The keys
+    // of the lines of accounts[i] are keys[offsets[i]] up to, but not
+    // including, keys[offsets[i + 1]], in order.
+    struct AccountBucket
+    {
+        std::vector<AccountID> accounts;
+        std::vector<std::uint32_t> offsets;
+        std::vector<uint256> keys;
+    };
+
+    // One side of a trust line
+    using Edge = std::pair<AccountID, uint256>;
+
+    explicit TrustLineGraph(std::shared_ptr<Ledger const> ledger);
+
+    static std::optional<Line>
+    makeLine(SHAMapItem const& item);
+
+    // Build a bucket from edges sorted by account, then by key
+    static std::shared_ptr<AccountBucket const>
+    makeBucket(std::vector<Edge> const& edges);
+
+    Line const*
+    findLine(uint256 const& key) const;
+
+    std::shared_ptr<Ledger const> ledger_;
+    std::vector<std::shared_ptr<LineBucket const>> lines_;
+    std::vector<std::shared_ptr<AccountBucket const>> accounts_;
+    std::size_t lineCount_ = 0;
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_RDB_MIGRATETXDB_H_INCLUDED
+#define RIPPLE_APP_RDB_MIGRATETXDB_H_INCLUDED
+
+#include <ripple/core/DatabaseCon.h>
+
+namespace ripple {
+
+/**
+ * @brief doMigrateTxDB Converts the transaction database to the compact
+ *        layout. The transactions are copied into a separate database,
+ *        which can be done while the server is running. Repeating the
+ *        copy only copies the ledgers that changed since the last one.
+ * @param setup Path to the database and other opening parameters.
+ * @param finish True to replace the transaction database with the copy
+ *        once it is complete. The server must be stopped.
+ * @return True if the migration step completed successfully.
+ */
+bool
+doMigrateTxDB(DatabaseCon::Setup const& setup, bool finish);
+
+}  // namespace ripple
+
+#endif
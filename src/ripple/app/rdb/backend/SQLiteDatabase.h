@@ -112,6 +112,18 @@ public:
         std::shared_ptr<Ledger const> const& ledger,
         bool current) = 0;
 
+    /**
+     * @brief saveValidatedLedgers Saves ledgers into the database, writing
+     *        all of them in a single transaction.
+     * @param ledgers The ledgers.
+     * @param current True if the ledgers are current.
+     * @return For each ledger, in order, true if saving was successful.
+     */
+    virtual std::vector<bool>
+    saveValidatedLedgers(
+        std::vector<std::shared_ptr<Ledger const>> const& ledgers,
+        bool current) = 0;
+
     /**
      * @brief getLimitedOldestLedgerInfo Returns the info of the oldest ledger
      *        whose sequence number is greater than or equal to the given
@@ -35,13 +35,25 @@ namespace detail {
 enum class TableType { Ledgers, Transactions, AccountTransactions };
 constexpr int TableTypeCount = 3;
 
+/* Layout of the transaction tables: TxDBInit or TxDBInitCompact. */
+enum class TxSchema { legacy, compact };
+
 struct DatabasePairValid
 {
     std::unique_ptr<DatabaseCon> ledgerDb;
     std::unique_ptr<DatabaseCon> transactionDb;
     bool valid;
+    TxSchema txSchema = TxSchema::legacy;
 };
 
+/**
+ * @brief getTxSchema Returns the layout of an existing transaction database.
+ * @param session Session with the database.
+ * @return Layout of the tables, or none if they have not been created.
+ */
+std::optional<TxSchema>
+getTxSchema(soci::session& session);
+
 /**
  * @brief makeLedgerDBs Opens ledger and transactions databases.
  * @param config Config object.
@@ -121,21 +133,25 @@ RelationalDatabase::CountMinMax
 getRowsMinMax(soci::session& session, TableType type);
 
 /**
- * @brief saveValidatedLedger Saves ledger into database.
+ * @brief saveValidatedLedgers Saves ledgers into database. The rows of all
+ *        the ledgers are written in a single transaction on each database,
+ *        using statements prepared once for the whole batch.
  * @param lgrDB Link to ledgers database.
  * @param txnDB Link to transactions database.
  * @param app Application object.
- * @param ledger The ledger.
- * @param current True if ledger is current.
- * @return True is saving was successfull.
+ * @param ledgers The ledgers.
+ * @param current True if the ledgers are current.
+ * @param schema Layout of the transaction tables.
+ * @return For each ledger, in order, true if it was saved.
  */
-bool
-saveValidatedLedger(
+std::vector<bool>
+saveValidatedLedgers(
     DatabaseCon& ldgDB,
     DatabaseCon& txnDB,
     Application& app,
-    std::shared_ptr<Ledger const> const& ledger,
-    bool current);
+    std::vector<std::shared_ptr<Ledger const>> const& ledgers,
+    bool current,
+    TxSchema schema);
 
 /**
  * @brief getLedgerInfoByIndex Returns ledger by its sequence.
@@ -276,6 +292,7 @@ getTxHistory(
  *        to another shard databases, if shard databases are used.
  *        None if node database is used.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return Vector of pairs of found transactions and their metadata
  *         sorted in ascending order by account sequence.
  *         Also number of transactions processed or skipped.
@@ -291,7 +308,8 @@ getOldestAccountTxs(
     LedgerMaster& ledgerMaster,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j);
+    beast::Journal j,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief getNewestAccountTxs Returns newest transactions for given
@@ -307,6 +325,7 @@ getOldestAccountTxs(
  *        to another shard databases, if shard databases are used.
  *        None if node database is used.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return Vector of pairs of found transactions and their metadata
  *         sorted in descending order by account sequence.
  *         Also number of transactions processed or skipped.
@@ -322,7 +341,8 @@ getNewestAccountTxs(
     LedgerMaster& ledgerMaster,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j);
+    beast::Journal j,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief getOldestAccountTxsB Returns oldest transactions in binary form
@@ -338,6 +358,7 @@ getNewestAccountTxs(
  *        to another shard databases, if shard databases are used.
  *        None if node database is used.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return Vector of tuples of found transactions, their metadata and
  *         account sequences sorted in ascending order by account
  *         sequence. Also number of transactions processed or skipped.
@@ -352,7 +373,8 @@ getOldestAccountTxsB(
     Application& app,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j);
+    beast::Journal j,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief getNewestAccountTxsB Returns newest transactions in binary form
@@ -368,6 +390,7 @@ getOldestAccountTxsB(
  *        to another shard databases, if shard databases are used.
  *        None if node database is used.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return Vector of tuples of found transactions, their metadata and
  *         account sequences sorted in descending order by account
  *         sequence. Also number of transactions processed or skipped.
@@ -382,7 +405,8 @@ getNewestAccountTxsB(
     Application& app,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j);
+    beast::Journal j,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief oldestAccountTxPage Searches oldest transactions for given
@@ -399,6 +423,7 @@ getNewestAccountTxsB(
  * @param limit_used Number or transactions already returned in calls
  *        to another shard databases.
  * @param page_length Total number of transactions to return.
+ * @param schema Layout of the transaction tables.
  * @return Vector of tuples of found transactions, their metadata and
  *         account sequences sorted in ascending order by account
  *         sequence and marker for next search if search not finished.
@@ -413,7 +438,8 @@ oldestAccountTxPage(
         onTransaction,
     RelationalDatabase::AccountTxPageOptions const& options,
     int limit_used,
-    std::uint32_t page_length);
+    std::uint32_t page_length,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief newestAccountTxPage Searches newest transactions for given
@@ -430,6 +456,7 @@ oldestAccountTxPage(
  * @param limit_used Number or transactions already returned in calls
  *        to another shard databases.
  * @param page_length Total number of transactions to return.
+ * @param schema Layout of the transaction tables.
  * @return Vector of tuples of found transactions, their metadata and
  *         account sequences sorted in descending order by account
  *         sequence and marker for next search if search not finished.
@@ -444,7 +471,8 @@ newestAccountTxPage(
         onTransaction,
     RelationalDatabase::AccountTxPageOptions const& options,
     int limit_used,
-    std::uint32_t page_length);
+    std::uint32_t page_length,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief getTransaction Returns transaction with given hash. If not found
@@ -455,6 +483,7 @@ newestAccountTxPage(
  * @param id Hash of the transaction.
  * @param range Range of ledgers to check, if present.
  * @param ec Default value of error code.
+ * @param schema Layout of the transaction tables.
  * @return Transaction and its metadata if found, TxSearched::all if range
  *         given and all ledgers from range are present in the database,
  *         TxSearched::some if range given and not all ledgers are present,
@@ -468,7 +497,8 @@ getTransaction(
     Application& app,
     uint256 const& id,
     std::optional<ClosedInterval<uint32_t>> const& range,
-    error_code_i& ec);
+    error_code_i& ec,
+    TxSchema schema = TxSchema::legacy);
 
 /**
  * @brief dbHasSpace Checks if given database has available space.
@@ -30,6 +30,7 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/core/SociDB.h>
 #include <ripple/json/to_string.h>
+#include <ripple/protocol/TxFormats.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <soci/sqlite3/soci-sqlite3.h>
@@ -63,6 +64,228 @@ to_string(TableType type)
     }
 }
 
+/**
+ * @brief sqlTxID Returns an SQL literal for a transaction ID.
+ * @param id The transaction ID.
+ * @param schema Layout of the transaction tables.
+ * @return Literal to compare with or insert into a TransID column.
+ */
+static std::string
+sqlTxID(uint256 const& id, TxSchema schema)
+{
+    if (schema == TxSchema::compact)
+        return "X'" + strHex(id) + "'";
+    return "'" + to_string(id) + "'";
+}
+
+/**
+ * @brief sqlAccount Returns an SQL literal for an account.
+ * @param account The account.
+ * @param schema Layout of the transaction tables.
+ * @return Literal to compare with or insert into an Account column.
+ */
+static std::string
+sqlAccount(AccountID const& account, TxSchema schema)
+{
+    if (schema == TxSchema::compact)
+        return "X'" + strHex(account) + "'";
+    return "'" + toBase58(account) + "'";
+}
+
+/**
+ * @brief assign Replaces the contents of a blob bound to a statement.
+ * @param blob The blob.
+ * @param data The new contents.
+ */
+static void
+assign(soci::blob& blob, Blob const& data)
+{
+    // Writing does not shorten a blob
+    blob.trim(0);
+    if (!data.empty())
+        blob.write(0, reinterpret_cast<char const*>(data.data()), data.size());
+}
+
+/**
+ * @brief TextKeys Transaction IDs and accounts bound as text, in the
+ *        legacy layout.
+ */
+struct TextKeys
+{
+    explicit TextKeys(soci::session&)
+    {
+    }
+
+    void
+    setID(uint256 const& txID)
+    {
+        id = to_string(txID);
+    }
+
+    void
+    setAccount(std::string& to, AccountID const& account)
+    {
+        to = toBase58(account);
+    }
+
+    std::string id;
+    std::string account;
+    std::string from;
+};
+
+/**
+ * @brief BlobKeys Transaction IDs and accounts bound as blobs, in the
+ *        compact layout.
+ */
+struct BlobKeys
+{
+    explicit BlobKeys(soci::session& session)
+        : id(session), account(session), from(session)
+    {
+    }
+
+    void
+    setID(uint256 const& txID)
+    {
+        assign(id, Blob(txID.begin(), txID.end()));
+    }
+
+    void
+    setAccount(soci::blob& to, AccountID const& account)
+    {
+        assign(to, Blob(account.begin(), account.end()));
+    }
+
+    soci::blob id;
+    soci::blob account;
+    soci::blob from;
+};
+
+/**
+ * @brief TxWriter Writes the transactions of validated ledgers using
+ *        statements that are prepared once and executed for every row.
+ * @tparam Keys TextKeys or BlobKeys, depending on the layout.
+ */
+template <class Keys>
+class TxWriter
+{
+public:
+    explicit TxWriter(soci::session& session)
+        : keys_(session)
+        , rawTxn_(session)
+        , meta_(session)
+        , eraseTxs_(
+              (session.prepare
+                   << "DELETE FROM Transactions WHERE LedgerSeq = :seq;",
+               soci::use(seq_)))
+        , eraseAccts_(
+              (session.prepare
+                   << "DELETE FROM AccountTransactions WHERE LedgerSeq = :seq;",
+               soci::use(seq_)))
+        , eraseTxAccts_(
+              (session.prepare
+                   << "DELETE FROM AccountTransactions WHERE TransID = :id;",
+               soci::use(keys_.id)))
+        , insertAcct_(
+              (session.prepare << "INSERT INTO AccountTransactions "
+                                  "(TransID, Account, LedgerSeq, TxnSeq) "
+                                  "VALUES (:id, :account, :seq, :txnSeq);",
+               soci::use(keys_.id),
+               soci::use(keys_.account),
+               soci::use(seq_),
+               soci::use(txnSeq_)))
+        , insertTx_(
+              (session.prepare << "INSERT OR REPLACE INTO Transactions "
+                                  "(TransID, TransType, FromAcct, FromSeq, "
+                                  "LedgerSeq, Status, RawTxn, TxnMeta) "
+                                  "VALUES (:id, :type, :from, :fromSeq, "
+                                  ":seq, :status, :rawTxn, :meta);",
+               soci::use(keys_.id),
+               soci::use(type_),
+               soci::use(keys_.from),
+               soci::use(fromSeq_),
+               soci::use(seq_),
+               soci::use(status_),
+               soci::use(rawTxn_),
+               soci::use(meta_)))
+    {
+    }
+
+    /** Removes the rows previously saved for a ledger. */
+    void
+    erase(LedgerIndex seq)
+    {
+        seq_ = seq;
+        eraseTxs_.execute(true);
+        eraseAccts_.execute(true);
+    }
+
+    /** Saves a transaction and the accounts it affects. */
+    void
+    insert(AcceptedLedgerTx const& tx, LedgerIndex seq)
+    {
+        auto const& txn = *tx.getTxn();
+
+        seq_ = seq;
+        txnSeq_ = tx.getTxnSeq();
+        keys_.setID(tx.getTransactionID());
+        eraseTxAccts_.execute(true);
+
+        for (auto const& account : tx.getAffected())
+        {
+            keys_.setAccount(keys_.account, account);
+            insertAcct_.execute(true);
+        }
+
+        auto const format =
+            TxFormats::getInstance().findByType(txn.getTxnType());
+        assert(format != nullptr);
+
+        Serializer s;
+        txn.add(s);
+
+        type_ = format->getName();
+        keys_.setAccount(keys_.from, txn.getAccountID(sfAccount));
+        fromSeq_ = txn.getFieldU32(sfSequence);
+        assign(rawTxn_, s.peekData());
+        assign(meta_, tx.getRawMeta());
+        insertTx_.execute(true);
+    }
+
+private:
+    // Values bound to the statements
+    Keys keys_;
+    LedgerIndex seq_ = 0;
+    std::uint32_t txnSeq_ = 0;
+    std::string type_;
+    std::uint32_t fromSeq_ = 0;
+    std::string status_ = std::string(1, txnSqlValidated);
+    soci::blob rawTxn_;
+    soci::blob meta_;
+
+    soci::statement eraseTxs_;
+    soci::statement eraseAccts_;
+    soci::statement eraseTxAccts_;
+    soci::statement insertAcct_;
+    soci::statement insertTx_;
+};
+
+std::optional<TxSchema>
+getTxSchema(soci::session& session)
+{
+    // SOCI requires boost::optional (not std::optional) as the parameter.
+    boost::optional<std::string> type;
+    session << "SELECT type FROM pragma_table_info('Transactions') "
+               "WHERE name = 'TransID';",
+        soci::into(type);
+
+    if (!session.got_data() || !type)
+        return std::nullopt;
+
+    return boost::iequals(*type, "BLOB") ? TxSchema::compact
+                                         : TxSchema::legacy;
+}
+
 DatabasePairValid
 makeLedgerDBs(
     Config const& config,
@@ -78,16 +301,40 @@ makeLedgerDBs(
 
     if (config.useTxTables())
     {
+        bool const onDisk = !setup.standAlone ||
+            setup.startUp == Config::LOAD ||
+            setup.startUp == Config::LOAD_FILE ||
+            setup.startUp == Config::REPLAY;
+
+        // An existing database keeps the layout it was created with
+        auto schema = config.compactTxTables() ? TxSchema::compact
+                                               : TxSchema::legacy;
+
+        if (auto const path = setup.dataDir / TxDBName;
+            onDisk && boost::filesystem::exists(path))
+        {
+            soci::session session;
+            open(session, "sqlite", path.string());
+            if (auto const existing = getTxSchema(session))
+                schema = *existing;
+        }
+
         // transaction database
-        auto tx{std::make_unique<DatabaseCon>(
-            setup, TxDBName, TxDBPragma, TxDBInit, checkpointerSetup)};
+        auto tx = schema == TxSchema::compact
+            ? std::make_unique<DatabaseCon>(
+                  setup,
+                  TxDBName,
+                  TxDBPragma,
+                  TxDBInitCompact,
+                  checkpointerSetup)
+            : std::make_unique<DatabaseCon>(
+                  setup, TxDBName, TxDBPragma, TxDBInit, checkpointerSetup);
         tx->getSession() << boost::str(
             boost::format("PRAGMA cache_size=-%d;") %
             kilobytes(config.getValueFor(SizedItem::txnDBCache)));
 
-        if (!setup.standAlone || setup.startUp == Config::LOAD ||
-            setup.startUp == Config::LOAD_FILE ||
-            setup.startUp == Config::REPLAY)
+        // The compact layout's AccountTransactions has a primary key
+        if (onDisk && schema == TxSchema::legacy)
         {
             // Check if AccountTransactions has primary key
             std::string cid, name, type;
@@ -108,12 +355,12 @@ makeLedgerDBs(
             {
                 if (pk == 1)
                 {
-                    return {std::move(lgr), std::move(tx), false};
+                    return {std::move(lgr), std::move(tx), false, schema};
                 }
             }
         }
 
-        return {std::move(lgr), std::move(tx), true};
+        return {std::move(lgr), std::move(tx), true, schema};
     }
     else
         return {std::move(lgr), {}, true};
@@ -183,200 +430,224 @@ getRowsMinMax(soci::session& session, TableType type)
     return res;
 }
 
-bool
-saveValidatedLedger(
-    DatabaseCon& ldgDB,
-    DatabaseCon& txnDB,
+/**
+ * @brief saveTransactions Writes the transactions of ledgers.
+ * @tparam Keys TextKeys or BlobKeys, depending on the layout.
+ * @param session Session with the transactions database.
+ * @param app Application object.
+ * @param ledgers The ledgers, with their accepted transactions.
+ */
+template <class Keys>
+static void
+saveTransactions(
+    soci::session& session,
     Application& app,
-    std::shared_ptr<Ledger const> const& ledger,
-    bool current)
+    std::vector<std::pair<LedgerIndex, AcceptedLedger const*>> const&
+        ledgers)
 {
     auto j = app.journal("Ledger");
-    auto seq = ledger->info().seq;
+    TxWriter<Keys> writer(session);
 
-    // TODO(tom): Fix this hard-coded SQL!
-    JLOG(j.trace()) << "saveValidatedLedger " << (current ? "" : "fromAcquire ")
-                    << seq;
-
-    if (!ledger->info().accountHash.isNonZero())
+    for (auto const& [seq, aLedger] : ledgers)
     {
-        JLOG(j.fatal()) << "AH is zero: " << getJson({*ledger, {}});
-        assert(false);
-    }
-
-    if (ledger->info().accountHash != ledger->stateMap().getHash().as_uint256())
-    {
-        JLOG(j.fatal()) << "sAL: " << ledger->info().accountHash
-                        << " != " << ledger->stateMap().getHash();
-        JLOG(j.fatal()) << "saveAcceptedLedger: seq=" << seq
-                        << ", current=" << current;
-        assert(false);
-    }
+        writer.erase(seq);
 
-    assert(ledger->info().txHash == ledger->txMap().getHash().as_uint256());
+        for (auto const& acceptedLedgerTx : *aLedger)
+        {
+            if (acceptedLedgerTx->getAffected().empty())
+            {
+                if (auto const& sleTxn = acceptedLedgerTx->getTxn();
+                    !isPseudoTx(*sleTxn))
+                {
+                    // It's okay for pseudo transactions to not affect any
+                    // accounts.  But otherwise...
+                    JLOG(j.warn()) << "Transaction in ledger " << seq
+                                   << " affects no accounts";
+                    JLOG(j.warn()) << sleTxn->getJson(JsonOptions::none);
+                }
+            }
 
-    // Save the ledger header in the hashed object store
-    {
-        Serializer s(128);
-        s.add32(HashPrefix::ledgerMaster);
-        addRaw(ledger->info(), s);
-        app.getNodeStore().store(
-            hotLEDGER, std::move(s.modData()), ledger->info().hash, seq);
-    }
+            writer.insert(*acceptedLedgerTx, seq);
 
-    std::shared_ptr<AcceptedLedger> aLedger;
-    try
-    {
-        aLedger = app.getAcceptedLedgerCache().fetch(ledger->info().hash);
-        if (!aLedger)
-        {
-            aLedger = std::make_shared<AcceptedLedger>(ledger, app);
-            app.getAcceptedLedgerCache().canonicalize_replace_client(
-                ledger->info().hash, aLedger);
+            app.getMasterTransaction().inLedger(
+                acceptedLedgerTx->getTransactionID(), seq);
         }
     }
-    catch (std::exception const&)
-    {
-        JLOG(j.warn()) << "An accepted ledger was missing nodes";
-        app.getLedgerMaster().failedSave(seq, ledger->info().hash);
-        // Clients can now trust the database for information about this
-        // ledger sequence.
-        app.pendingSaves().finishWork(seq);
-        return false;
-    }
+}
 
+std::vector<bool>
+saveValidatedLedgers(
+    DatabaseCon& ldgDB,
+    DatabaseCon& txnDB,
+    Application& app,
+    std::vector<std::shared_ptr<Ledger const>> const& ledgers,
+    bool current,
+    TxSchema schema)
+{
+    auto j = app.journal("Ledger");
+
+    std::vector<bool> saved(ledgers.size(), false);
+    std::vector<std::shared_ptr<AcceptedLedger>> accepted(ledgers.size());
+
+    for (std::size_t i = 0; i < ledgers.size(); ++i)
     {
-        static boost::format deleteLedger(
-            "DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-        static boost::format deleteTrans1(
-            "DELETE FROM Transactions WHERE LedgerSeq = %u;");
-        static boost::format deleteTrans2(
-            "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-        static boost::format deleteAcctTrans(
-            "DELETE FROM AccountTransactions WHERE TransID = '%s';");
+        auto const& ledger = ledgers[i];
+        auto const seq = ledger->info().seq;
+
+        JLOG(j.trace()) << "saveValidatedLedger "
+                        << (current ? "" : "fromAcquire ") << seq;
 
+        if (!ledger->info().accountHash.isNonZero())
         {
-            auto db = ldgDB.checkoutDb();
-            *db << boost::str(deleteLedger % seq);
+            JLOG(j.fatal()) << "AH is zero: " << getJson({*ledger, {}});
+            assert(false);
         }
 
-        if (app.config().useTxTables())
+        if (ledger->info().accountHash !=
+            ledger->stateMap().getHash().as_uint256())
         {
-            auto db = txnDB.checkoutDb();
-
-            soci::transaction tr(*db);
+            JLOG(j.fatal()) << "sAL: " << ledger->info().accountHash
+                            << " != " << ledger->stateMap().getHash();
+            JLOG(j.fatal()) << "saveAcceptedLedger: seq=" << seq
+                            << ", current=" << current;
+            assert(false);
+        }
 
-            *db << boost::str(deleteTrans1 % seq);
-            *db << boost::str(deleteTrans2 % seq);
+        assert(
+            ledger->info().txHash == ledger->txMap().getHash().as_uint256());
 
-            std::string const ledgerSeq(std::to_string(seq));
+        // Save the ledger header in the hashed object store
+        {
+            Serializer s(128);
+            s.add32(HashPrefix::ledgerMaster);
+            addRaw(ledger->info(), s);
+            app.getNodeStore().store(
+                hotLEDGER, std::move(s.modData()), ledger->info().hash, seq);
+        }
 
-            for (auto const& acceptedLedgerTx : *aLedger)
+        try
+        {
+            accepted[i] =
+                app.getAcceptedLedgerCache().fetch(ledger->info().hash);
+            if (!accepted[i])
             {
-                uint256 transactionID = acceptedLedgerTx->getTransactionID();
+                accepted[i] = std::make_shared<AcceptedLedger>(ledger, app);
+                app.getAcceptedLedgerCache().canonicalize_replace_client(
+                    ledger->info().hash, accepted[i]);
+            }
+        }
+        catch (std::exception const&)
+        {
+            JLOG(j.warn()) << "An accepted ledger was missing nodes";
+            app.getLedgerMaster().failedSave(seq, ledger->info().hash);
+            // Clients can now trust the database for information about this
+            // ledger sequence.
+            app.pendingSaves().finishWork(seq, false);
+            continue;
+        }
 
-                std::string const txnId(to_string(transactionID));
-                std::string const txnSeq(
-                    std::to_string(acceptedLedgerTx->getTxnSeq()));
+        saved[i] = true;
+    }
 
-                *db << boost::str(deleteAcctTrans % transactionID);
+    if (std::find(saved.begin(), saved.end(), true) == saved.end())
+        return saved;
 
-                auto const& accts = acceptedLedgerTx->getAffected();
+    {
+        auto db = ldgDB.checkoutDb();
+        soci::transaction tr(*db);
 
-                if (!accts.empty())
-                {
-                    std::string sql(
-                        "INSERT INTO AccountTransactions "
-                        "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
-
-                    // Try to make an educated guess on how much space we'll
-                    // need for our arguments. In argument order we have: 64
-                    // + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                    sql.reserve(sql.length() + (accts.size() * 128));
-
-                    bool first = true;
-                    for (auto const& account : accts)
-                    {
-                        if (!first)
-                            sql += ", ('";
-                        else
-                        {
-                            sql += "('";
-                            first = false;
-                        }
-
-                        sql += txnId;
-                        sql += "','";
-                        sql += toBase58(account);
-                        sql += "',";
-                        sql += ledgerSeq;
-                        sql += ",";
-                        sql += txnSeq;
-                        sql += ")";
-                    }
-                    sql += ";";
-                    JLOG(j.trace()) << "ActTx: " << sql;
-                    *db << sql;
-                }
-                else if (auto const& sleTxn = acceptedLedgerTx->getTxn();
-                         !isPseudoTx(*sleTxn))
-                {
-                    // It's okay for pseudo transactions to not affect any
-                    // accounts.  But otherwise...
-                    JLOG(j.warn()) << "Transaction in ledger " << seq
-                                   << " affects no accounts";
-                    JLOG(j.warn()) << sleTxn->getJson(JsonOptions::none);
-                }
+        LedgerIndex seq = 0;
+        soci::statement st =
+            (db->prepare << "DELETE FROM Ledgers WHERE LedgerSeq = :seq;",
+             soci::use(seq));
 
-                *db
-                    << (STTx::getMetaSQLInsertReplaceHeader() +
-                        acceptedLedgerTx->getTxn()->getMetaSQL(
-                            seq, acceptedLedgerTx->getEscMeta()) +
-                        ";");
+        for (std::size_t i = 0; i < ledgers.size(); ++i)
+        {
+            if (!saved[i])
+                continue;
+            seq = ledgers[i]->info().seq;
+            st.execute(true);
+        }
 
-                app.getMasterTransaction().inLedger(transactionID, seq);
-            }
+        tr.commit();
+    }
 
-            tr.commit();
+    if (app.config().useTxTables())
+    {
+        std::vector<std::pair<LedgerIndex, AcceptedLedger const*>> txs;
+        txs.reserve(ledgers.size());
+        for (std::size_t i = 0; i < ledgers.size(); ++i)
+        {
+            if (saved[i])
+                txs.emplace_back(ledgers[i]->info().seq, accepted[i].get());
         }
 
-        {
-            static std::string addLedger(
-                R"sql(INSERT OR REPLACE INTO Ledgers
+        auto db = txnDB.checkoutDb();
+        soci::transaction tr(*db);
+
+        if (schema == TxSchema::compact)
+            saveTransactions<BlobKeys>(*db, app, txs);
+        else
+            saveTransactions<TextKeys>(*db, app, txs);
+
+        tr.commit();
+    }
+
+    {
+        static std::string const addLedger(
+            R"sql(INSERT OR REPLACE INTO Ledgers
                 (LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,
                 CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash)
             VALUES
                 (:ledgerHash,:ledgerSeq,:prevHash,:totalCoins,:closingTime,:prevClosingTime,
                 :closeTimeRes,:closeFlags,:accountSetHash,:transSetHash);)sql");
 
-            auto db(ldgDB.checkoutDb());
-
-            soci::transaction tr(*db);
-
-            auto const hash = to_string(ledger->info().hash);
-            auto const parentHash = to_string(ledger->info().parentHash);
-            auto const drops = to_string(ledger->info().drops);
-            auto const closeTime =
-                ledger->info().closeTime.time_since_epoch().count();
-            auto const parentCloseTime =
-                ledger->info().parentCloseTime.time_since_epoch().count();
-            auto const closeTimeResolution =
-                ledger->info().closeTimeResolution.count();
-            auto const closeFlags = ledger->info().closeFlags;
-            auto const accountHash = to_string(ledger->info().accountHash);
-            auto const txHash = to_string(ledger->info().txHash);
-
-            *db << addLedger, soci::use(hash), soci::use(seq),
-                soci::use(parentHash), soci::use(drops), soci::use(closeTime),
-                soci::use(parentCloseTime), soci::use(closeTimeResolution),
-                soci::use(closeFlags), soci::use(accountHash),
-                soci::use(txHash);
-
-            tr.commit();
+        auto db(ldgDB.checkoutDb());
+
+        soci::transaction tr(*db);
+
+        std::string hash, parentHash, drops, accountHash, txHash;
+        LedgerIndex seq = 0;
+        NetClock::rep closeTime = 0, parentCloseTime = 0;
+        NetClock::rep closeTimeResolution = 0;
+        int closeFlags = 0;
+
+        soci::statement st =
+            (db->prepare << addLedger,
+             soci::use(hash),
+             soci::use(seq),
+             soci::use(parentHash),
+             soci::use(drops),
+             soci::use(closeTime),
+             soci::use(parentCloseTime),
+             soci::use(closeTimeResolution),
+             soci::use(closeFlags),
+             soci::use(accountHash),
+             soci::use(txHash));
+
+        for (std::size_t i = 0; i < ledgers.size(); ++i)
+        {
+            if (!saved[i])
+                continue;
+
+            auto const& info = ledgers[i]->info();
+            hash = to_string(info.hash);
+            seq = info.seq;
+            parentHash = to_string(info.parentHash);
+            drops = to_string(info.drops);
+            closeTime = info.closeTime.time_since_epoch().count();
+            parentCloseTime = info.parentCloseTime.time_since_epoch().count();
+            closeTimeResolution = info.closeTimeResolution.count();
+            closeFlags = info.closeFlags;
+            accountHash = to_string(info.accountHash);
+            txHash = to_string(info.txHash);
+            st.execute(true);
         }
+
+        tr.commit();
     }
 
-    return true;
+    return saved;
 }
 
 /**
@@ -693,6 +964,7 @@ getTxHistory(
  * @param count True for counting the number of transactions, false for
  *        selecting them.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return SQL query string.
  */
 static std::string
@@ -704,7 +976,8 @@ transactionsSQL(
     bool descending,
     bool binary,
     bool count,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
     constexpr std::uint32_t NONBINARY_PAGE_LENGTH = 200;
     constexpr std::uint32_t BINARY_PAGE_LENGTH = 500;
@@ -759,8 +1032,9 @@ transactionsSQL(
     if (count)
         sql = boost::str(
             boost::format("SELECT %s FROM AccountTransactions "
-                          "WHERE Account = '%s' %s %s LIMIT %u, %u;") %
-            selection % toBase58(options.account) % maxClause % minClause %
+                          "WHERE Account = %s %s %s LIMIT %u, %u;") %
+            selection % sqlAccount(options.account, schema) % maxClause %
+            minClause %
             beast::lexicalCastThrow<std::string>(options.offset) %
             beast::lexicalCastThrow<std::string>(numberOfResults));
     else
@@ -769,11 +1043,12 @@ transactionsSQL(
                 "SELECT %s FROM "
                 "AccountTransactions INNER JOIN Transactions "
                 "ON Transactions.TransID = AccountTransactions.TransID "
-                "WHERE Account = '%s' %s %s "
+                "WHERE Account = %s %s %s "
                 "ORDER BY AccountTransactions.LedgerSeq %s, "
                 "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
                 "LIMIT %u, %u;") %
-            selection % toBase58(options.account) % maxClause % minClause %
+            selection % sqlAccount(options.account, schema) % maxClause %
+            minClause %
             (descending ? "DESC" : "ASC") % (descending ? "DESC" : "ASC") %
             (descending ? "DESC" : "ASC") %
             beast::lexicalCastThrow<std::string>(options.offset) %
@@ -798,6 +1073,7 @@ transactionsSQL(
  *        No value if the node database is used.
  * @param descending True for descending order, false for ascending.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return Vector of pairs of found transactions and their metadata sorted by
  *         account sequence in the specified order along with the number of
  *         transactions processed or skipped. If this number is >= 0, then it
@@ -814,7 +1090,8 @@ getAccountTxs(
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
     bool descending,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
     RelationalDatabase::AccountTxs ret;
 
@@ -826,7 +1103,8 @@ getAccountTxs(
         descending,
         false,
         false,
-        j);
+        j,
+        schema);
     if (sql == "")
         return {ret, 0};
 
@@ -889,7 +1167,15 @@ getAccountTxs(
             RelationalDatabase::AccountTxOptions opt = options;
             opt.offset = 0;
             std::string sql1 = transactionsSQL(
-                app, "COUNT(*)", opt, limit_used, descending, false, false, j);
+                app,
+                "COUNT(*)",
+                opt,
+                limit_used,
+                descending,
+                false,
+                false,
+                j,
+                schema);
 
             session << sql1, soci::into(total);
 
@@ -907,10 +1193,11 @@ getOldestAccountTxs(
     LedgerMaster& ledgerMaster,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
     return getAccountTxs(
-        session, app, ledgerMaster, options, limit_used, false, j);
+        session, app, ledgerMaster, options, limit_used, false, j, schema);
 }
 
 std::pair<RelationalDatabase::AccountTxs, int>
@@ -920,10 +1207,11 @@ getNewestAccountTxs(
     LedgerMaster& ledgerMaster,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
     return getAccountTxs(
-        session, app, ledgerMaster, options, limit_used, true, j);
+        session, app, ledgerMaster, options, limit_used, true, j, schema);
 }
 
 /**
@@ -941,6 +1229,7 @@ getNewestAccountTxs(
  *        database is used.
  * @param descending True for descending order, false for ascending.
  * @param j Journal.
+ * @param schema Layout of the transaction tables.
  * @return Vector of tuples each containing (the found transactions, their
  *         metadata, and their account sequences) sorted by account sequence in
  *         the specified order along with the number of transactions processed
@@ -956,7 +1245,8 @@ getAccountTxsB(
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
     bool descending,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
     std::vector<RelationalDatabase::txnMetaLedgerType> ret;
 
@@ -968,7 +1258,8 @@ getAccountTxsB(
         descending,
         true /*binary*/,
         false,
-        j);
+        j,
+        schema);
     if (sql == "")
         return {ret, 0};
 
@@ -1010,7 +1301,15 @@ getAccountTxsB(
             RelationalDatabase::AccountTxOptions opt = options;
             opt.offset = 0;
             std::string sql1 = transactionsSQL(
-                app, "COUNT(*)", opt, limit_used, descending, true, false, j);
+                app,
+                "COUNT(*)",
+                opt,
+                limit_used,
+                descending,
+                true,
+                false,
+                j,
+                schema);
 
             session << sql1, soci::into(total);
 
@@ -1027,9 +1326,11 @@ getOldestAccountTxsB(
     Application& app,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
-    return getAccountTxsB(session, app, options, limit_used, false, j);
+    return getAccountTxsB(
+        session, app, options, limit_used, false, j, schema);
 }
 
 std::pair<std::vector<RelationalDatabase::txnMetaLedgerType>, int>
@@ -1038,9 +1339,11 @@ getNewestAccountTxsB(
     Application& app,
     RelationalDatabase::AccountTxOptions const& options,
     std::optional<int> const& limit_used,
-    beast::Journal j)
+    beast::Journal j,
+    TxSchema schema)
 {
-    return getAccountTxsB(session, app, options, limit_used, true, j);
+    return getAccountTxsB(
+        session, app, options, limit_used, true, j, schema);
 }
 
 /**
@@ -1059,6 +1362,7 @@ getNewestAccountTxsB(
  *        to other shard databases.
  * @param page_length Total number of transactions to return.
  * @param forward True for ascending order, false for descending.
+ * @param schema Layout of the transaction tables.
  * @return Vector of tuples of found transactions, their metadata and account
  *         sequences sorted in the specified order by account sequence, a marker
  *         for the next search if the search was not finished and the number of
@@ -1074,7 +1378,8 @@ accountTxPage(
     RelationalDatabase::AccountTxPageOptions const& options,
     int limit_used,
     std::uint32_t page_length,
-    bool forward)
+    bool forward,
+    TxSchema schema)
 {
     int total = 0;
 
@@ -1115,7 +1420,7 @@ accountTxPage(
           Status,RawTxn,TxnMeta
           FROM AccountTransactions INNER JOIN Transactions
           ON Transactions.TransID = AccountTransactions.TransID
-          AND AccountTransactions.Account = '%s' WHERE
+          AND AccountTransactions.Account = %s WHERE
           )");
 
     std::string sql;
@@ -1132,37 +1437,30 @@ accountTxPage(
              ORDER BY AccountTransactions.LedgerSeq %s,
              AccountTransactions.TxnSeq %s
              LIMIT %u;)")) %
-            toBase58(options.account) % options.minLedger % options.maxLedger %
-            order % order % queryLimit);
+            sqlAccount(options.account, schema) % options.minLedger %
+            options.maxLedger % order % order % queryLimit);
     }
     else
     {
+        // Seek to the marker with a row value comparison. SQLite answers
+        // it with a range scan of the (Account, LedgerSeq, TxnSeq) index,
+        // so the first row read is the marker and the cost of a page does
+        // not grow with its depth into the account's history.
         const char* const compare = forward ? ">=" : "<=";
-        const std::uint32_t minLedger =
-            forward ? findLedger + 1 : options.minLedger;
-        const std::uint32_t maxLedger =
-            forward ? options.maxLedger : findLedger - 1;
+        const char* const bound = forward ? "<=" : ">=";
+        const std::uint32_t lastLedger =
+            forward ? options.maxLedger : options.minLedger;
 
-        auto b58acct = toBase58(options.account);
         sql = boost::str(
-            boost::format((
-                R"(SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,
-            Status,RawTxn,TxnMeta
-            FROM AccountTransactions, Transactions WHERE
-            (AccountTransactions.TransID = Transactions.TransID AND
-            AccountTransactions.Account = '%s' AND
-            AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u')
-            OR
-            (AccountTransactions.TransID = Transactions.TransID AND
-            AccountTransactions.Account = '%s' AND
-            AccountTransactions.LedgerSeq = '%u' AND
-            AccountTransactions.TxnSeq %s '%u')
-            ORDER BY AccountTransactions.LedgerSeq %s,
-            AccountTransactions.TxnSeq %s
-            LIMIT %u;
-            )")) %
-            b58acct % minLedger % maxLedger % b58acct % findLedger % compare %
-            findSeq % order % order % queryLimit);
+            boost::format(
+                prefix + (R"((AccountTransactions.LedgerSeq,
+             AccountTransactions.TxnSeq) %s (%u, %u)
+             AND AccountTransactions.LedgerSeq %s %u
+             ORDER BY AccountTransactions.LedgerSeq %s,
+             AccountTransactions.TxnSeq %s
+             LIMIT %u;)")) %
+            sqlAccount(options.account, schema) % compare % findLedger %
+            findSeq % bound % lastLedger % order % order % queryLimit);
     }
 
     {
@@ -1253,7 +1551,8 @@ oldestAccountTxPage(
         onTransaction,
     RelationalDatabase::AccountTxPageOptions const& options,
     int limit_used,
-    std::uint32_t page_length)
+    std::uint32_t page_length,
+    TxSchema schema)
 {
     return accountTxPage(
         session,
@@ -1262,7 +1561,8 @@ oldestAccountTxPage(
         options,
         limit_used,
         page_length,
-        true);
+        true,
+        schema);
 }
 
 std::pair<std::optional<RelationalDatabase::AccountTxMarker>, int>
@@ -1274,7 +1574,8 @@ newestAccountTxPage(
         onTransaction,
     RelationalDatabase::AccountTxPageOptions const& options,
     int limit_used,
-    std::uint32_t page_length)
+    std::uint32_t page_length,
+    TxSchema schema)
 {
     return accountTxPage(
         session,
@@ -1283,7 +1584,8 @@ newestAccountTxPage(
         options,
         limit_used,
         page_length,
-        false);
+        false,
+        schema);
 }
 
 std::variant<RelationalDatabase::AccountTx, TxSearched>
@@ -1292,14 +1594,15 @@ getTransaction(
     Application& app,
     uint256 const& id,
     std::optional<ClosedInterval<uint32_t>> const& range,
-    error_code_i& ec)
+    error_code_i& ec,
+    TxSchema schema)
 {
     std::string sql =
         "SELECT LedgerSeq,Status,RawTxn,TxnMeta "
-        "FROM Transactions WHERE TransID='";
+        "FROM Transactions WHERE TransID=";
 
-    sql.append(to_string(id));
-    sql.append("';");
+    sql.append(sqlTxID(id, schema));
+    sql.append(";");
 
     // SOCI requires boost::optional (not std::optional) as parameters.
     boost::optional<std::uint64_t> ledgerSeq;
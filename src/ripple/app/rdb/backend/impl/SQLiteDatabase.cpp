@@ -27,6 +27,7 @@
 #include <ripple/app/rdb/backend/detail/Node.h>
 #include <ripple/app/rdb/backend/detail/Shard.h>
 #include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/core/SociDB.h>
@@ -112,6 +113,11 @@ public:
         std::shared_ptr<Ledger const> const& ledger,
         bool current) override;
 
+    std::vector<bool>
+    saveValidatedLedgers(
+        std::vector<std::shared_ptr<Ledger const>> const& ledgers,
+        bool current) override;
+
     std::optional<LedgerInfo>
     getLedgerInfoByIndex(LedgerIndex ledgerSeq) override;
 
@@ -195,6 +201,7 @@ private:
     bool const useTxTables_;
     beast::Journal j_;
     std::unique_ptr<DatabaseCon> lgrdb_, txdb_;
+    detail::TxSchema txSchema_ = detail::TxSchema::legacy;
     std::unique_ptr<DatabaseCon> lgrMetaDB_, txMetaDB_;
 
     /**
@@ -446,10 +453,11 @@ SQLiteDatabaseImp::makeLedgerDBs(
     DatabaseCon::Setup const& setup,
     DatabaseCon::CheckpointerSetup const& checkpointerSetup)
 {
-    auto [lgr, tx, res] =
+    auto [lgr, tx, res, schema] =
         detail::makeLedgerDBs(config, setup, checkpointerSetup);
     txdb_ = std::move(tx);
     lgrdb_ = std::move(lgr);
+    txSchema_ = schema;
     return res;
 }
 
@@ -764,35 +772,57 @@ SQLiteDatabaseImp::saveValidatedLedger(
     std::shared_ptr<Ledger const> const& ledger,
     bool current)
 {
+    return saveValidatedLedgers({ledger}, current).front();
+}
+
+std::vector<bool>
+SQLiteDatabaseImp::saveValidatedLedgers(
+    std::vector<std::shared_ptr<Ledger const>> const& ledgers,
+    bool current)
+{
+    auto const start = std::chrono::steady_clock::now();
+    std::vector<bool> saved(ledgers.size(), true);
+
     if (existsLedger())
     {
-        if (!detail::saveValidatedLedger(
-                *lgrdb_, *txdb_, app_, ledger, current))
-            return false;
+        saved = detail::saveValidatedLedgers(
+            *lgrdb_, *txdb_, app_, ledgers, current, txSchema_);
     }
 
     if (auto shardStore = app_.getShardStore(); shardStore)
     {
-        if (ledger->info().seq < shardStore->earliestLedgerSeq())
-            // For the moment return false only when the ShardStore
-            // should accept the ledger, but fails when attempting
-            // to do so, i.e. when saveLedgerMeta fails. Later when
-            // the ShardStore supercedes the NodeStore, change this
-            // line to return false if the ledger is too early.
-            return true;
-
         auto lgrMetaSession = lgrMetaDB_->checkoutDb();
         auto txMetaSession = txMetaDB_->checkoutDb();
 
-        return detail::saveLedgerMeta(
-            ledger,
-            app_,
-            *lgrMetaSession,
-            *txMetaSession,
-            shardStore->seqToShardIndex(ledger->info().seq));
+        for (std::size_t i = 0; i < ledgers.size(); ++i)
+        {
+            auto const& ledger = ledgers[i];
+            if (!saved[i])
+                continue;
+
+            if (ledger->info().seq < shardStore->earliestLedgerSeq())
+                // For the moment return false only when the ShardStore
+                // should accept the ledger, but fails when attempting
+                // to do so, i.e. when saveLedgerMeta fails. Later when
+                // the ShardStore supercedes the NodeStore, change this
+                // line to return false if the ledger is too early.
+                continue;
+
+            saved[i] = detail::saveLedgerMeta(
+                ledger,
+                app_,
+                *lgrMetaSession,
+                *txMetaSession,
+                shardStore->seqToShardIndex(ledger->info().seq));
+        }
     }
 
-    return true;
+    app_.getPerfLog().ledgerPhase(
+        perf::LedgerPhase::save,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+
+    return saved;
 }
 
 std::optional<LedgerInfo>
@@ -1093,7 +1123,7 @@ SQLiteDatabaseImp::getOldestAccountTxs(AccountTxOptions const& options)
     {
         auto db = checkoutTransaction();
         return detail::getOldestAccountTxs(
-                   *db, app_, ledgerMaster, options, {}, j_)
+                   *db, app_, ledgerMaster, options, {}, j_, txSchema_)
             .first;
     }
 
@@ -1153,7 +1183,7 @@ SQLiteDatabaseImp::getNewestAccountTxs(AccountTxOptions const& options)
     {
         auto db = checkoutTransaction();
         return detail::getNewestAccountTxs(
-                   *db, app_, ledgerMaster, options, {}, j_)
+                   *db, app_, ledgerMaster, options, {}, j_, txSchema_)
             .first;
     }
 
@@ -1210,7 +1240,9 @@ SQLiteDatabaseImp::getOldestAccountTxsB(AccountTxOptions const& options)
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
-        return detail::getOldestAccountTxsB(*db, app_, options, {}, j_).first;
+        return detail::getOldestAccountTxsB(
+                   *db, app_, options, {}, j_, txSchema_)
+            .first;
     }
 
     if (shardStoreExists())
@@ -1266,7 +1298,9 @@ SQLiteDatabaseImp::getNewestAccountTxsB(AccountTxOptions const& options)
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
-        return detail::getNewestAccountTxsB(*db, app_, options, {}, j_).first;
+        return detail::getNewestAccountTxsB(
+                   *db, app_, options, {}, j_, txSchema_)
+            .first;
     }
 
     if (shardStoreExists())
@@ -1339,7 +1373,13 @@ SQLiteDatabaseImp::oldestAccountTxPage(AccountTxPageOptions const& options)
         auto db = checkoutTransaction();
         auto newmarker =
             detail::oldestAccountTxPage(
-                *db, onUnsavedLedger, onTransaction, options, 0, page_length)
+                *db,
+                onUnsavedLedger,
+                onTransaction,
+                options,
+                0,
+                page_length,
+                txSchema_)
                 .first;
         return {ret, newmarker};
     }
@@ -1401,7 +1441,13 @@ SQLiteDatabaseImp::newestAccountTxPage(AccountTxPageOptions const& options)
         auto db = checkoutTransaction();
         auto newmarker =
             detail::newestAccountTxPage(
-                *db, onUnsavedLedger, onTransaction, options, 0, page_length)
+                *db,
+                onUnsavedLedger,
+                onTransaction,
+                options,
+                0,
+                page_length,
+                txSchema_)
                 .first;
         return {ret, newmarker};
     }
@@ -1462,7 +1508,13 @@ SQLiteDatabaseImp::oldestAccountTxPageB(AccountTxPageOptions const& options)
         auto db = checkoutTransaction();
         auto newmarker =
             detail::oldestAccountTxPage(
-                *db, onUnsavedLedger, onTransaction, options, 0, page_length)
+                *db,
+                onUnsavedLedger,
+                onTransaction,
+                options,
+                0,
+                page_length,
+                txSchema_)
                 .first;
         return {ret, newmarker};
     }
@@ -1523,7 +1575,13 @@ SQLiteDatabaseImp::newestAccountTxPageB(AccountTxPageOptions const& options)
         auto db = checkoutTransaction();
         auto newmarker =
             detail::newestAccountTxPage(
-                *db, onUnsavedLedger, onTransaction, options, 0, page_length)
+                *db,
+                onUnsavedLedger,
+                onTransaction,
+                options,
+                0,
+                page_length,
+                txSchema_)
                 .first;
         return {ret, newmarker};
     }
@@ -1571,7 +1629,7 @@ SQLiteDatabaseImp::getTransaction(
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
-        return detail::getTransaction(*db, app_, id, range, ec);
+        return detail::getTransaction(*db, app_, id, range, ec, txSchema_);
     }
 
     if (auto shardStore = app_.getShardStore(); shardStore)
@@ -0,0 +1,315 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/rdb/MigrateTxDB.h>
+#include <ripple/app/rdb/backend/detail/Node.h>
+#include <ripple/basics/RangeSet.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/protocol/AccountID.h>
+#include <soci/sqlite3/soci-sqlite3.h>
+#include <algorithm>
+#include <iostream>
+
+namespace ripple {
+
+// Number of ledgers copied in each database transaction
+static constexpr std::uint32_t batchLedgers = 1000;
+
+/**
+ * @brief hexToBlob SQL function converting hex text, such as a transaction
+ *        ID in the legacy layout, to a blob.
+ */
+static void
+hexToBlob(
+    sqlite_api::sqlite3_context* context,
+    int,
+    sqlite_api::sqlite3_value** argv)
+{
+    using namespace sqlite_api;
+
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL)
+        return sqlite3_result_null(context);
+
+    auto const text =
+        reinterpret_cast<char const*>(sqlite3_value_text(argv[0]));
+    auto const blob = strUnHex(std::string(text));
+    if (!blob)
+        return sqlite3_result_error(context, "invalid hex", -1);
+
+    sqlite3_result_blob(
+        context, blob->data(), blob->size(), SQLITE_TRANSIENT);
+}
+
+/**
+ * @brief accountToBlob SQL function converting a base58 account, as stored
+ *        in the legacy layout, to a blob.
+ */
+static void
+accountToBlob(
+    sqlite_api::sqlite3_context* context,
+    int,
+    sqlite_api::sqlite3_value** argv)
+{
+    using namespace sqlite_api;
+
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL)
+        return sqlite3_result_null(context);
+
+    auto const text =
+        reinterpret_cast<char const*>(sqlite3_value_text(argv[0]));
+    auto const account = parseBase58<AccountID>(text);
+    if (!account)
+        return sqlite3_result_error(context, "invalid account", -1);
+
+    sqlite3_result_blob(
+        context, account->data(), account->size(), SQLITE_TRANSIENT);
+}
+
+/**
+ * @brief registerFunctions Makes the conversion functions available to
+ *        the SQL statements of a session.
+ * @param session Session with the database.
+ */
+static void
+registerFunctions(soci::session& session)
+{
+    using namespace sqlite_api;
+
+    auto const backend =
+        dynamic_cast<soci::sqlite3_session_backend*>(session.get_backend());
+    if (!backend)
+        Throw<std::logic_error>("Didn't get a database connection.");
+
+    for (auto const& [name, function] :
+         {std::pair{"txdb_hex_to_blob", &hexToBlob},
+          std::pair{"txdb_account_to_blob", &accountToBlob}})
+    {
+        if (sqlite3_create_function(
+                backend->conn_,
+                name,
+                1,
+                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                nullptr,
+                function,
+                nullptr,
+                nullptr) != SQLITE_OK)
+            Throw<std::runtime_error>(
+                std::string("Unable to register SQL function ") + name);
+    }
+}
+
+/**
+ * @brief findChanged Compares the number of transactions in each ledger of
+ *        the attached legacy database with the compact one.
+ * @param session Session with the compact database.
+ * @return Ledgers that must be copied again.
+ */
+static RangeSet<std::uint32_t>
+findChanged(soci::session& session)
+{
+    RangeSet<std::uint32_t> changed;
+
+    std::uint32_t fromSeq = 0, toSeq = 0;
+    std::uint64_t fromCount = 0, toCount = 0;
+
+    soci::statement from =
+        (session.prepare << "SELECT LedgerSeq, COUNT(*) "
+                            "FROM legacy.Transactions "
+                            "GROUP BY LedgerSeq ORDER BY LedgerSeq;",
+         soci::into(fromSeq),
+         soci::into(fromCount));
+    soci::statement to =
+        (session.prepare << "SELECT LedgerSeq, COUNT(*) "
+                            "FROM main.Transactions "
+                            "GROUP BY LedgerSeq ORDER BY LedgerSeq;",
+         soci::into(toSeq),
+         soci::into(toCount));
+
+    from.execute();
+    to.execute();
+
+    bool haveFrom = from.fetch();
+    bool haveTo = to.fetch();
+
+    while (haveFrom || haveTo)
+    {
+        if (haveFrom && (!haveTo || fromSeq < toSeq))
+        {
+            // Not copied yet
+            changed.insert(fromSeq);
+            haveFrom = from.fetch();
+        }
+        else if (!haveFrom || toSeq < fromSeq)
+        {
+            // Deleted since it was copied
+            changed.insert(toSeq);
+            haveTo = to.fetch();
+        }
+        else
+        {
+            // Saved again since it was copied
+            if (fromCount != toCount)
+                changed.insert(fromSeq);
+            haveFrom = from.fetch();
+            haveTo = to.fetch();
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * @brief copyLedgers Replaces the transactions of a range of ledgers in
+ *        the compact database with those in the attached legacy database.
+ * @param session Session with the compact database.
+ * @param first First ledger of the range.
+ * @param last Last ledger of the range.
+ */
+static void
+copyLedgers(soci::session& session, std::uint32_t first, std::uint32_t last)
+{
+    soci::transaction tr(session);
+
+    session << "DELETE FROM main.Transactions "
+               "WHERE LedgerSeq BETWEEN :first AND :last;",
+        soci::use(first), soci::use(last);
+    session << "DELETE FROM main.AccountTransactions "
+               "WHERE LedgerSeq BETWEEN :first AND :last;",
+        soci::use(first), soci::use(last);
+
+    session << "INSERT OR REPLACE INTO main.Transactions "
+               "(TransID, TransType, FromAcct, FromSeq, LedgerSeq, Status, "
+               "RawTxn, TxnMeta) "
+               "SELECT txdb_hex_to_blob(TransID), TransType, "
+               "txdb_account_to_blob(FromAcct), FromSeq, LedgerSeq, Status, "
+               "RawTxn, TxnMeta "
+               "FROM legacy.Transactions "
+               "WHERE LedgerSeq BETWEEN :first AND :last;",
+        soci::use(first), soci::use(last);
+
+    // The legacy table has no key, so it may hold duplicate rows
+    session << "INSERT OR REPLACE INTO main.AccountTransactions "
+               "(Account, LedgerSeq, TxnSeq, TransID) "
+               "SELECT txdb_account_to_blob(Account), LedgerSeq, TxnSeq, "
+               "txdb_hex_to_blob(TransID) "
+               "FROM legacy.AccountTransactions "
+               "WHERE LedgerSeq BETWEEN :first AND :last;",
+        soci::use(first), soci::use(last);
+
+    tr.commit();
+}
+
+bool
+doMigrateTxDB(DatabaseCon::Setup const& setup, bool finish)
+{
+    using namespace boost::filesystem;
+
+    path const legacyPath = setup.dataDir / TxDBName;
+    path const compactPath = setup.dataDir / TxDBMigrationName;
+
+    if (!exists(legacyPath))
+    {
+        std::cerr << "There is no transaction database at "
+                  << legacyPath.string() << ".\n";
+        return false;
+    }
+
+    {
+        soci::session session;
+        open(session, "sqlite", legacyPath.string());
+        if (detail::getTxSchema(session) == detail::TxSchema::compact)
+        {
+            std::cout << legacyPath.string()
+                      << " already uses the compact layout." << std::endl;
+            return true;
+        }
+    }
+
+    {
+        auto compactDB = std::make_unique<DatabaseCon>(
+            setup, TxDBMigrationName, TxDBPragma, TxDBInitCompact);
+        auto& session = compactDB->getSession();
+
+        registerFunctions(session);
+        session << "ATTACH DATABASE :path AS legacy;",
+            soci::use(legacyPath.string());
+
+        auto const changed = findChanged(session);
+
+        std::cout << "Copying " << length(changed) << " ledgers from "
+                  << legacyPath.string() << " to " << compactPath.string()
+                  << std::endl;
+
+        for (auto const& range : changed)
+        {
+            for (std::uint32_t first = range.first();;)
+            {
+                auto const last = range.last() - first < batchLedgers
+                    ? range.last()
+                    : first + batchLedgers - 1;
+
+                copyLedgers(session, first, last);
+                std::cout << "Copied ledgers " << first << " to " << last
+                          << std::endl;
+
+                if (last == range.last())
+                    break;
+                first = last + 1;
+            }
+        }
+
+        session << "DETACH DATABASE legacy;";
+    }
+
+    if (!finish)
+    {
+        std::cout << "Copy complete. To finish the migration, stop rippled "
+                     "and run it again with --migrate_txdb=finish."
+                  << std::endl;
+        return true;
+    }
+
+    // Leaving write-ahead logging moves whatever is left in the log into
+    // the database, which SQLite refuses to do while another connection
+    // has the database open.
+    try
+    {
+        soci::session session;
+        open(session, "sqlite", legacyPath.string());
+        session << "PRAGMA journal_mode=DELETE;";
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << legacyPath.string() << " is in use (" << e.what()
+                  << "). Stop rippled before finishing the migration.\n";
+        return false;
+    }
+
+    path const oldPath = legacyPath.string() + ".legacy";
+    rename(legacyPath, oldPath);
+    rename(compactPath, legacyPath);
+
+    std::cout << "Migration finished. The previous transaction database was "
+                 "moved to "
+              << oldPath.string() << ", and can be deleted." << std::endl;
+
+    return true;
+}
+
+}  // namespace ripple
@@ -27,6 +27,7 @@
 #include <ripple/protocol/TER.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -66,6 +67,22 @@ checkValidity(
     Rules const& rules,
     Config const& config);
 
+/** Checks the signatures of several transactions together.
+
+    The outcome for each transaction is cached the same way
+    `checkValidity` caches it, so a later `checkValidity` call
+    for one of these transactions does not check its signature
+    again. Transactions whose signature state is already cached
+    are skipped.
+
+    @see checkValidity, STTx::checkSignBatch
+*/
+void
+checkSignatures(
+    HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    Rules const& rules);
+
 /** Sets the validity of a given transaction in the cache.
 
     @warning Use with extreme care.
@@ -85,6 +85,38 @@ checkValidity(
     return {Validity::Valid, ""};
 }
 
+void
+checkSignatures(
+    HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    Rules const& rules)
+{
+    std::vector<std::shared_ptr<STTx const>> unknown;
+    unknown.reserve(txs.size());
+    for (auto const& tx : txs)
+    {
+        if (!(router.getFlags(tx->getTransactionID()) &
+              (SF_SIGBAD | SF_SIGGOOD)))
+            unknown.push_back(tx);
+    }
+
+    if (unknown.empty())
+        return;
+
+    auto const requireCanonicalSig =
+        rules.enabled(featureRequireFullyCanonicalSig)
+        ? STTx::RequireFullyCanonicalSig::yes
+        : STTx::RequireFullyCanonicalSig::no;
+
+    auto const results =
+        STTx::checkSignBatch(unknown, requireCanonicalSig, rules);
+
+    for (std::size_t i = 0; i < unknown.size(); ++i)
+        router.setFlags(
+            unknown[i]->getTransactionID(),
+            results[i] ? SF_SIGGOOD : SF_SIGBAD);
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid, Validity validity)
 {
@@ -24,8 +24,10 @@
 #include <algorithm>
 #include <cstdint>
 #include <lz4.h>
+#include <memory>
 #include <stdexcept>
 #include <vector>
+#include <zstd.h>
 
 namespace ripple {
 
@@ -96,23 +98,24 @@ lz4Decompress(
     return decompressedSize;
 }
 
-/** LZ4 block decompression.
+namespace detail {
+
+/** Get the next inSize bytes of an input stream as a contiguous range.
+ * The first chunk is used in place if it holds all of the bytes, otherwise
+ * the bytes are copied into the staging buffer. Unused bytes are put back.
  * @tparam InputStream ZeroCopyInputStream
  * @param in Input source stream
- * @param inSize Size of compressed data
- * @param decompressed Buffer to hold decompressed data
- * @param decompressedSize Size of the decompressed buffer
- * @return size of the decompressed data
+ * @param inSize Number of bytes to get
+ * @param staging Buffer to copy the bytes into if they span chunks
+ * @return Pointer to the bytes
  */
 template <typename InputStream>
-std::size_t
-lz4Decompress(
+std::uint8_t const*
+contiguousInput(
     InputStream& in,
     std::size_t inSize,
-    std::uint8_t* decompressed,
-    std::size_t decompressedSize)
+    std::vector<std::uint8_t>& staging)
 {
-    std::vector<std::uint8_t> compressed;
     std::uint8_t const* chunk = nullptr;
     int chunkSize = 0;
     int copiedInSize = 0;
@@ -130,20 +133,20 @@ lz4Decompress(
                 copiedInSize = inSize;
                 break;
             }
-            compressed.resize(inSize);
+            staging.resize(inSize);
         }
 
         chunkSize = chunkSize < (inSize - copiedInSize)
             ? chunkSize
             : (inSize - copiedInSize);
 
-        std::copy(chunk, chunk + chunkSize, compressed.data() + copiedInSize);
+        std::copy(chunk, chunk + chunkSize, staging.data() + copiedInSize);
 
         copiedInSize += chunkSize;
 
         if (copiedInSize == inSize)
         {
-            chunk = compressed.data();
+            chunk = staging.data();
             break;
         }
     }
@@ -154,11 +157,121 @@ lz4Decompress(
 
     if ((copiedInSize == 0 && chunkSize < inSize) ||
         (copiedInSize > 0 && copiedInSize != inSize))
-        Throw<std::runtime_error>("lz4 decompress: insufficient input size");
+        Throw<std::runtime_error>("decompress: insufficient input size");
 
+    return chunk;
+}
+
+}  // namespace detail
+
+/** LZ4 block decompression.
+ * @tparam InputStream ZeroCopyInputStream
+ * @param in Input source stream
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @return size of the decompressed data
+ */
+template <typename InputStream>
+std::size_t
+lz4Decompress(
+    InputStream& in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize)
+{
+    std::vector<std::uint8_t> compressed;
+    auto const chunk = detail::contiguousInput(in, inSize, compressed);
     return lz4Decompress(chunk, inSize, decompressed, decompressedSize);
 }
 
+/** Zstd compression level used for peer messages. Low levels compress
+ * several times faster than the default while keeping most of the ratio.
+ */
+int constexpr zstdLevel = 1;
+
+/** Zstd frame compression.
+ * @tparam BufferFactory Callable object or lambda.
+ *     Takes the requested buffer size and returns allocated buffer pointer.
+ * @param in Data to compress
+ * @param inSize Size of the data
+ * @param bf Compressed buffer allocator
+ * @return Size of compressed data, or zero if failed to compress
+ */
+template <typename BufferFactory>
+std::size_t
+zstdCompress(void const* in, std::size_t inSize, BufferFactory&& bf)
+{
+    if (inSize > UINT32_MAX)
+        Throw<std::runtime_error>("zstd compress: invalid size");
+
+    // Creating a context is expensive, so each thread keeps one.
+    thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx{
+        ZSTD_createCCtx(), &ZSTD_freeCCtx};
+
+    auto const outCapacity = ZSTD_compressBound(inSize);
+
+    // Request the caller to allocate and return the buffer to hold compressed
+    // data
+    auto compressed = bf(outCapacity);
+
+    auto const compressedSize = ZSTD_compressCCtx(
+        ctx.get(), compressed, outCapacity, in, inSize, zstdLevel);
+    if (ZSTD_isError(compressedSize))
+        Throw<std::runtime_error>("zstd compress: failed");
+
+    return compressedSize;
+}
+
+/**
+ * @param in Compressed data
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @return size of the decompressed data
+ */
+inline std::size_t
+zstdDecompress(
+    std::uint8_t const* in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize)
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx{
+        ZSTD_createDCtx(), &ZSTD_freeDCtx};
+
+    if (inSize == 0)
+        Throw<std::runtime_error>("zstdDecompress: empty input");
+
+    if (ZSTD_decompressDCtx(
+            ctx.get(), decompressed, decompressedSize, in, inSize) !=
+        decompressedSize)
+        Throw<std::runtime_error>("zstdDecompress: failed");
+
+    return decompressedSize;
+}
+
+/** Zstd frame decompression.
+ * @tparam InputStream ZeroCopyInputStream
+ * @param in Input source stream
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @return size of the decompressed data
+ */
+template <typename InputStream>
+std::size_t
+zstdDecompress(
+    InputStream& in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize)
+{
+    std::vector<std::uint8_t> compressed;
+    auto const chunk = detail::contiguousInput(in, inSize, compressed);
+    return zstdDecompress(chunk, inSize, decompressed, decompressedSize);
+}
+
 }  // namespace compression_algorithms
 
 }  // namespace ripple
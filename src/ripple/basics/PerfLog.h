@@ -25,6 +25,7 @@
 #include <ripple/json/json_value.h>
 #include <boost/filesystem.hpp>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -38,6 +39,27 @@ namespace ripple {
 class Application;
 namespace perf {
 
+/**
+ * Phases of closing, validating and publishing a ledger whose latencies
+ * are tracked by PerfLog.
+ */
+enum class LedgerPhase {
+    establish,
+    build,
+    flush,
+    save,
+    publish,
+    orderBook,
+    rotate,
+};
+
+/** The number of distinct LedgerPhase values. */
+constexpr std::size_t ledgerPhaseCount = 7;
+
+/** Name used to report a ledger phase. */
+char const*
+ledgerPhaseName(LedgerPhase phase);
+
 /**
  * Singleton class that maintains performance counters and optionally
  * writes Json-formatted data to a distinct log. It should exist prior
@@ -138,6 +160,23 @@ public:
     virtual void
     jobFinish(JobType const type, microseconds dur, int instance) = 0;
 
+    /**
+     * Log completion of a ledger phase
+     *
+     * @param phase Ledger phase
+     * @param dur Duration of the phase in microseconds
+     */
+    virtual void
+    ledgerPhase(LedgerPhase const phase, microseconds dur) = 0;
+
+    /**
+     * Render ledger phase latency histograms in Json
+     *
+     * @return Ledger phase counts and latency percentiles
+     */
+    virtual Json::Value
+    ledgerPhasesJson() const = 0;
+
     /**
      * Render performance counters in Json
      *
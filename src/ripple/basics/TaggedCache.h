@@ -27,6 +27,7 @@
 #include <ripple/beast/insight/Insight.h>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
@@ -45,6 +46,14 @@ namespace ripple {
 
     @note Callers must not modify data objects that are stored in the cache
           unless they hold their own lock over all cache operations.
+
+    By default every operation is serialized on a single mutex, which callers
+    may also hold across several operations through peekMutex(). A cache
+    constructed with partitioned locking instead guards each partition of
+    the underlying map with its own mutex: lookups and insertions only
+    contend with operations on keys in the same partition, and sweep() never
+    holds more than one partition lock at a time. In that mode peekMutex()
+    guards only the cache configuration, not its contents.
 */
 template <
     class Key,
@@ -69,7 +78,8 @@ public:
         clock_type& clock,
         beast::Journal journal,
         beast::insight::Collector::ptr const& collector =
-            beast::insight::NullCollector::New())
+            beast::insight::NullCollector::New(),
+        bool partitionedLocking = false)
         : m_journal(journal)
         , m_clock(clock)
         , m_stats(
@@ -80,6 +90,9 @@ public:
         , m_target_size(size)
         , m_target_age(expiration)
         , m_cache_count(0)
+        , m_partitioned(partitionedLocking)
+        , m_partitionMutexes(
+              std::make_unique<mutex_type[]>(m_cache.partitions()))
         , m_hits(0)
         , m_misses(0)
     {
@@ -93,29 +106,40 @@ public:
         return m_clock;
     }
 
+    /** Returns `true` if each partition is guarded by its own lock. */
+    bool
+    partitionedLocking() const
+    {
+        return m_partitioned;
+    }
+
     /** Returns the number of items in the container. */
     std::size_t
     size() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache.size();
+        std::size_t ret = 0;
+        forEachPartition(
+            [&ret](auto const& partition) { ret += partition.size(); });
+        return ret;
     }
 
     void
     setTargetSize(int s)
     {
-        std::lock_guard lock(m_mutex);
-        m_target_size = s;
+        {
+            std::lock_guard lock(m_mutex);
+            m_target_size = s;
+        }
 
         if (s > 0)
         {
-            for (auto& partition : m_cache.map())
-            {
+            auto const partitions = m_cache.partitions();
+            forEachPartition([s, partitions](auto& partition) {
                 partition.rehash(static_cast<std::size_t>(
                     (s + (s >> 2)) /
-                        (partition.max_load_factor() * m_cache.partitions()) +
+                        (partition.max_load_factor() * partitions) +
                     1));
-            }
+            });
         }
 
         JLOG(m_journal.debug()) << m_name << " target size set to " << s;
@@ -140,39 +164,34 @@ public:
     int
     getCacheSize() const
     {
-        std::lock_guard lock(m_mutex);
         return m_cache_count;
     }
 
     int
     getTrackSize() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache.size();
+        return size();
     }
 
     float
     getHitRate()
     {
-        std::lock_guard lock(m_mutex);
-        auto const total = static_cast<float>(m_hits + m_misses);
-        return m_hits * (100.0f / std::max(1.0f, total));
+        auto const hits = m_hits.load();
+        auto const total = static_cast<float>(hits + m_misses);
+        return hits * (100.0f / std::max(1.0f, total));
     }
 
     void
     clear()
     {
-        std::lock_guard lock(m_mutex);
-        m_cache.clear();
+        forEachPartition([](auto& partition) { partition.clear(); });
         m_cache_count = 0;
     }
 
     void
     reset()
     {
-        std::lock_guard lock(m_mutex);
-        m_cache.clear();
-        m_cache_count = 0;
+        clear();
         m_hits = 0;
         m_misses = 0;
     }
@@ -184,7 +203,7 @@ public:
     bool
     touch_if_exists(KeyComparable const& key)
     {
-        std::lock_guard lock(m_mutex);
+        std::lock_guard lock(mutexFor(key));
         auto const iter(m_cache.find(key));
         if (iter == m_cache.end())
         {
@@ -209,51 +228,29 @@ public:
         std::vector<SweptPointersVector> allStuffToSweep(m_cache.partitions());
 
         clock_type::time_point const now(m_clock.now());
-        clock_type::time_point when_expire;
+
+        auto const [targetSize, targetAge] = [this]() {
+            std::lock_guard lock(m_mutex);
+            return std::make_pair(m_target_size, m_target_age);
+        }();
 
         auto const start = std::chrono::steady_clock::now();
+        if (m_partitioned)
+        {
+            // Each worker takes only its own partition's lock, so the rest
+            // of the cache stays available while the sweep is running.
+            sweepPartitions(
+                expiration(now, size(), targetSize, targetAge),
+                now,
+                allStuffToSweep);
+        }
+        else
         {
             std::lock_guard lock(m_mutex);
-
-            if (m_target_size == 0 ||
-                (static_cast<int>(m_cache.size()) <= m_target_size))
-            {
-                when_expire = now - m_target_age;
-            }
-            else
-            {
-                when_expire =
-                    now - m_target_age * m_target_size / m_cache.size();
-
-                clock_type::duration const minimumAge(std::chrono::seconds(1));
-                if (when_expire > (now - minimumAge))
-                    when_expire = now - minimumAge;
-
-                JLOG(m_journal.trace())
-                    << m_name << " is growing fast " << m_cache.size() << " of "
-                    << m_target_size << " aging at "
-                    << (now - when_expire).count() << " of "
-                    << m_target_age.count();
-            }
-
-            std::vector<std::thread> workers;
-            workers.reserve(m_cache.partitions());
-            std::atomic<int> allRemovals = 0;
-
-            for (std::size_t p = 0; p < m_cache.partitions(); ++p)
-            {
-                workers.push_back(sweepHelper(
-                    when_expire,
-                    now,
-                    m_cache.map()[p],
-                    allStuffToSweep[p],
-                    allRemovals,
-                    lock));
-            }
-            for (std::thread& worker : workers)
-                worker.join();
-
-            m_cache_count -= allRemovals;
+            sweepPartitions(
+                expiration(now, m_cache.size(), targetSize, targetAge),
+                now,
+                allStuffToSweep);
         }
         // At this point allStuffToSweep will go out of scope outside the lock
         // and decrement the reference count on each strong pointer.
@@ -270,7 +267,7 @@ public:
     {
         // Remove from cache, if !valid, remove from map too. Returns true if
         // removed from cache
-        std::lock_guard lock(m_mutex);
+        std::lock_guard lock(mutexFor(key));
 
         auto cit = m_cache.find(key);
 
@@ -289,7 +286,7 @@ public:
         }
 
         if (!valid || entry.isExpired())
-            m_cache.erase(cit);
+            eraseEntry(cit);
 
         return ret;
     }
@@ -316,7 +313,7 @@ public:
     {
         // Return canonical value, store if needed, refresh in cache
         // Return values: true=we had the data already
-        std::lock_guard lock(m_mutex);
+        std::lock_guard lock(mutexFor(key));
 
         auto cit = m_cache.find(key);
 
@@ -395,7 +392,7 @@ public:
     std::shared_ptr<T>
     fetch(const key_type& key)
     {
-        std::lock_guard<mutex_type> l(m_mutex);
+        std::lock_guard<mutex_type> l(mutexFor(key));
         auto ret = initialFetch(key, l);
         if (!ret)
             ++m_misses;
@@ -419,7 +416,7 @@ public:
     auto
     insert(key_type const& key) -> std::enable_if_t<IsKeyCache, ReturnType>
     {
-        std::lock_guard lock(m_mutex);
+        std::lock_guard lock(mutexFor(key));
         clock_type::time_point const now(m_clock.now());
         auto [it, inserted] = m_cache.emplace(
             std::piecewise_construct,
@@ -459,12 +456,11 @@ public:
     {
         std::vector<key_type> v;
 
-        {
-            std::lock_guard lock(m_mutex);
-            v.reserve(m_cache.size());
-            for (auto const& _ : m_cache)
+        forEachPartition([&v](auto const& partition) {
+            v.reserve(v.size() + partition.size());
+            for (auto const& _ : partition)
                 v.push_back(_.first);
-        }
+        });
 
         return v;
     }
@@ -474,11 +470,11 @@ public:
     double
     rate() const
     {
-        std::lock_guard lock(m_mutex);
-        auto const tot = m_hits + m_misses;
+        auto const hits = m_hits.load();
+        auto const tot = hits + m_misses;
         if (tot == 0)
             return 0;
-        return double(m_hits) / tot;
+        return double(hits) / tot;
     }
 
     /** Fetch an item from the cache.
@@ -491,7 +487,7 @@ public:
     fetch(key_type const& digest, Handler const& h)
     {
         {
-            std::lock_guard l(m_mutex);
+            std::lock_guard l(mutexFor(digest));
             if (auto ret = initialFetch(digest, l))
                 return ret;
         }
@@ -500,7 +496,7 @@ public:
         if (!sle)
             return {};
 
-        std::lock_guard l(m_mutex);
+        std::lock_guard l(mutexFor(digest));
         ++m_misses;
         auto const [it, inserted] =
             m_cache.emplace(digest, Entry(m_clock.now(), std::move(sle)));
@@ -511,6 +507,111 @@ public:
     // End CachedSLEs functions.
 
 private:
+    /** Return the mutex that guards the partition holding key. */
+    mutex_type&
+    mutexFor(key_type const& key) const
+    {
+        if (!m_partitioned)
+            return m_mutex;
+        return m_partitionMutexes[m_cache.partition(key)];
+    }
+
+    /** Invoke f on every partition while holding the lock guarding it. */
+    template <class Function>
+    void
+    forEachPartition(Function&& f)
+    {
+        if (!m_partitioned)
+        {
+            std::lock_guard lock(m_mutex);
+            for (auto& partition : m_cache.map())
+                f(partition);
+            return;
+        }
+
+        auto& partitions = m_cache.map();
+        for (std::size_t p = 0; p < partitions.size(); ++p)
+        {
+            std::lock_guard lock(m_partitionMutexes[p]);
+            f(partitions[p]);
+        }
+    }
+
+    template <class Function>
+    void
+    forEachPartition(Function&& f) const
+    {
+        if (!m_partitioned)
+        {
+            std::lock_guard lock(m_mutex);
+            for (auto const& partition : m_cache.map())
+                f(partition);
+            return;
+        }
+
+        auto const& partitions = m_cache.map();
+        for (std::size_t p = 0; p < partitions.size(); ++p)
+        {
+            std::lock_guard lock(m_partitionMutexes[p]);
+            f(partitions[p]);
+        }
+    }
+
+    /** Return the last access time at or before which entries expire. */
+    clock_type::time_point
+    expiration(
+        clock_type::time_point const& now,
+        std::size_t trackSize,
+        int targetSize,
+        clock_type::duration targetAge) const
+    {
+        if (targetSize == 0 || (static_cast<int>(trackSize) <= targetSize))
+            return now - targetAge;
+
+        clock_type::time_point when_expire =
+            now - targetAge * targetSize / trackSize;
+
+        clock_type::duration const minimumAge(std::chrono::seconds(1));
+        if (when_expire > (now - minimumAge))
+            when_expire = now - minimumAge;
+
+        JLOG(m_journal.trace())
+            << m_name << " is growing fast " << trackSize << " of "
+            << targetSize << " aging at " << (now - when_expire).count()
+            << " of " << targetAge.count();
+
+        return when_expire;
+    }
+
+    /** Sweep every partition on its own worker thread.
+        Unless locking is partitioned, the caller must hold m_mutex.
+    */
+    void
+    sweepPartitions(
+        clock_type::time_point const& when_expire,
+        clock_type::time_point const& now,
+        std::vector<SweptPointersVector>& allStuffToSweep)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(m_cache.partitions());
+        std::atomic<int> allRemovals = 0;
+
+        for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+        {
+            workers.push_back(sweepHelper(
+                when_expire,
+                now,
+                m_cache.map()[p],
+                allStuffToSweep[p],
+                allRemovals,
+                m_partitioned ? &m_partitionMutexes[p] : nullptr));
+        }
+        for (std::thread& worker : workers)
+            worker.join();
+
+        m_cache_count -= allRemovals;
+    }
+
     std::shared_ptr<T>
     initialFetch(key_type const& key, std::lock_guard<mutex_type> const& l)
     {
@@ -534,7 +635,7 @@ private:
             return entry.ptr;
         }
 
-        m_cache.erase(cit);
+        eraseEntry(cit);
         return {};
     }
 
@@ -546,10 +647,10 @@ private:
         {
             beast::insight::Gauge::value_type hit_rate(0);
             {
-                std::lock_guard lock(m_mutex);
-                auto const total(m_hits + m_misses);
+                auto const hits = m_hits.load();
+                auto const total(hits + m_misses);
                 if (total != 0)
-                    hit_rate = (m_hits * 100) / total;
+                    hit_rate = (hits * 100) / total;
             }
             m_stats.hit_rate.set(hit_rate);
         }
@@ -575,8 +676,8 @@ private:
         beast::insight::Gauge size;
         beast::insight::Gauge hit_rate;
 
-        std::size_t hits;
-        std::size_t misses;
+        std::atomic<std::size_t> hits;
+        std::atomic<std::size_t> misses;
     };
 
     class KeyOnlyEntry
@@ -650,6 +751,18 @@ private:
     using cache_type =
         hardened_partitioned_hash_map<key_type, Entry, Hash, KeyEqual>;
 
+    /** Erase an entry while holding only the lock guarding its key.
+
+        m_cache.erase moves on to find the next entry, which may be in a
+        partition guarded by another mutex, so the entry is erased from
+        its own partition instead.
+    */
+    void
+    eraseEntry(typename cache_type::iterator const& cit)
+    {
+        cit.ait_->erase(cit.mit_);
+    }
+
     [[nodiscard]] std::thread
     sweepHelper(
         clock_type::time_point const& when_expire,
@@ -657,9 +770,13 @@ private:
         typename KeyValueCacheType::map_type& partition,
         SweptPointersVector& stuffToSweep,
         std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        mutex_type* partitionMutex)
     {
-        return std::thread([&, this]() {
+        return std::thread([&, partitionMutex, this]() {
+            std::unique_lock<mutex_type> lock;
+            if (partitionMutex)
+                lock = std::unique_lock<mutex_type>(*partitionMutex);
+
             int cacheRemovals = 0;
             int mapRemovals = 0;
 
@@ -731,9 +848,13 @@ private:
         typename KeyOnlyCacheType::map_type& partition,
         SweptPointersVector&,
         std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        mutex_type* partitionMutex)
     {
-        return std::thread([&, this]() {
+        return std::thread([&, partitionMutex, this]() {
+            std::unique_lock<mutex_type> lock;
+            if (partitionMutex)
+                lock = std::unique_lock<mutex_type>(*partitionMutex);
+
             int cacheRemovals = 0;
             int mapRemovals = 0;
 
@@ -787,10 +908,15 @@ private:
     clock_type::duration m_target_age;
 
     // Number of items cached
-    int m_cache_count;
+    std::atomic<int> m_cache_count;
     cache_type m_cache;  // Hold strong reference to recent objects
-    std::uint64_t m_hits;
-    std::uint64_t m_misses;
+
+    // Whether each partition of m_cache is guarded by its own mutex
+    bool const m_partitioned;
+    std::unique_ptr<mutex_type[]> const m_partitionMutexes;
+
+    std::atomic<std::uint64_t> m_hits;
+    std::atomic<std::uint64_t> m_misses;
 };
 
 }  // namespace ripple
@@ -130,6 +130,12 @@ private:
 
     bool USE_TX_TABLES = true;
 
+    /** Whether a new transaction database uses the compact layout.
+
+        An existing database keeps the layout it was created with.
+    */
+    bool COMPACT_TX_TABLES = false;
+
     /** Determines if the server will sign a tx, given an account's secret seed.
 
         In the past, this was allowed, but this functionality can have security
@@ -236,9 +242,14 @@ public:
     std::chrono::seconds AMENDMENT_MAJORITY_TIME = defaultAmendmentMajorityTime;
 
     // Thread pool configuration (0 = choose for me)
-    int WORKERS = 0;           // jobqueue thread count. default: upto 6
-    int IO_WORKERS = 0;        // io svc thread count. default: 2
-    int PREFETCH_WORKERS = 0;  // prefetch thread count. default: 4
+    int WORKERS = 0;               // jobqueue thread count. default: upto 6
+    int IO_WORKERS = 0;            // io svc thread count. default: 2
+    int PREFETCH_WORKERS = 0;      // prefetch thread count. default: 4
+    int LEDGER_FLUSH_WORKERS = 0;  // ledger flush thread count. default: 4
+    int LEDGER_APPLY_WORKERS = 0;  // consensus tx apply threads. default: 1
+
+    // Schedule jobqueue jobs without a global lock
+    bool LOCKFREE_JOB_QUEUE = false;
 
     // Can only be set in code, specifically unit tests
     bool FORCE_MULTI_THREAD = false;
@@ -345,6 +356,12 @@ public:
         return USE_TX_TABLES;
     }
 
+    bool
+    compactTxTables() const
+    {
+        return COMPACT_TX_TABLES;
+    }
+
     bool
     reportingReadOnly() const
     {
@@ -55,6 +55,8 @@ enum JobType {
     jtVALIDATION_ut,      // A validation from an untrusted source
     jtMANIFEST,           // A validator's manifest
     jtUPDATE_PF,          // Update pathfinding requests
+    jtPATH_UPDATE,        // Help update pathfinding requests
+    jtPATH_GRAPH,         // Build the trust line graph for pathfinding
     jtTRANSACTION_l,      // A local transaction
     jtREPLAY_REQ,         // Peer request a ledger delta or a skip list
     jtLEDGER_REQ,         // Peer request ledger/txnset data
@@ -72,6 +74,8 @@ enum JobType {
     jtVALIDATION_t,       // A validation from a trusted source
     jtWRITE,              // Write out hashed objects
     jtACCEPT,             // Accept a consensus ledger
+    jtLEDGER_FLUSH,       // Help write the nodes of a built ledger
+    jtLEDGER_APPLY,       // Help apply the transactions of a ledger
     jtPROPOSAL_t,         // A proposal from a trusted source
     jtNETOP_CLUSTER,      // NetworkOPs cluster peer report
     jtNETOP_TIMER,        // NetworkOPs net timer processing
@@ -51,6 +51,14 @@ struct Coro_create_t
 
     When the JobQueue stops, it waits for all jobs
     and coroutines to finish.
+
+    Jobs run in order of JobType priority, and in the order they were added
+    within a type, subject to the limit on running jobs of each type. By
+    default the pending jobs are kept in a single set guarded by a mutex.
+    The lock-free scheduler instead keeps a lock-free queue for each
+    JobType, and the counts of waiting, running and deferred jobs of each
+    type in a single atomic word, so that adding and starting jobs never
+    takes a lock.
 */
 class JobQueue : private Workers::Callback
 {
@@ -145,7 +153,8 @@ public:
         beast::insight::Collector::ptr const& collector,
         beast::Journal journal,
         Logs& logs,
-        perf::PerfLog& perfLog);
+        perf::PerfLog& perfLog,
+        bool lockFree = false);
     ~JobQueue();
 
     /** Adds a job to the JobQueue.
@@ -186,6 +195,31 @@ public:
     std::shared_ptr<Coro>
     postCoro(JobType t, std::string const& name, F&& f);
 
+    /** Calls a function once for each index below a count, in parallel.
+
+        The calling thread works through the indexes together with up to
+        `helpers` jobs of the given type. A job that starts after the work
+        is done returns at once, so this only waits for the jobs that
+        started in time, even if the queue is too busy to run any.
+
+        @param type The type of the helper jobs.
+        @param name Name of the helper jobs.
+        @param count The number of indexes.
+        @param helpers The most jobs to add.
+        @param f Called with each index, possibly on several threads at
+                 once. If a call throws, no more calls are started and
+                 the exception is rethrown once the others have returned.
+        @param stop If set, no more calls are started once it returns true.
+    */
+    void
+    forEach(
+        JobType type,
+        std::string const& name,
+        std::size_t count,
+        std::size_t helpers,
+        std::function<void(std::size_t)> const& f,
+        std::function<bool(void)> const& stop = {});
+
     /** Jobs waiting at this priority.
      */
     int
@@ -244,7 +278,7 @@ private:
 
     beast::Journal m_journal;
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
+    std::atomic<std::uint64_t> m_lastJob;
     std::set<Job> m_jobSet;
     JobCounter jobCounter_;
     std::atomic_bool stopping_{false};
@@ -253,7 +287,16 @@ private:
     JobTypeData m_invalidJobData;
 
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic<int> m_processCount;
+
+    // Whether the lock-free scheduler is used
+    bool const lockFree_;
+
+    // The number of jobs queued by the lock-free scheduler
+    std::atomic<std::size_t> queued_{0};
+
+    // The lock-free scheduler's job types, highest priority first
+    std::vector<JobTypeData*> byPriority_;
 
     // The number of suspended coroutines
     int nSuspend_ = 0;
@@ -273,6 +316,18 @@ private:
     JobTypeData&
     getJobTypeData(JobType type);
 
+    // Returns the number of jobs of a type waiting and running.
+    //
+    // Invariants:
+    //  The calling thread owns the JobLock, unless using the lock-free
+    //  scheduler
+    std::pair<int, int>
+    getCounts(JobTypeData const& data) const;
+
+    // Returns true if no jobs are queued or running.
+    bool
+    isIdle() const;
+
     // Adds a reference counted job to the JobQueue.
     //
     //    param type The type of job.
@@ -323,6 +378,21 @@ private:
     void
     finishJob(JobType type);
 
+    // The lock-free scheduler's equivalents of addRefCountedJob, getNextJob
+    // and finishJob, with the same pre- and post-conditions. None of them
+    // require the JobLock.
+    void
+    addLockFreeJob(
+        JobTypeData& data,
+        std::string const& name,
+        JobFunction const& func);
+
+    void
+    getNextLockFreeJob(Job& job);
+
+    void
+    finishLockFreeJob(JobType type);
+
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
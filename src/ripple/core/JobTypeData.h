@@ -23,6 +23,9 @@
 #include <ripple/basics/Log.h>
 #include <ripple/beast/insight/Collector.h>
 #include <ripple/core/JobTypeInfo.h>
+#include <boost/lockfree/queue.hpp>
+#include <atomic>
+#include <cstdint>
 
 namespace ripple {
 
@@ -51,6 +54,13 @@ public:
     beast::insight::Event dequeue;
     beast::insight::Event execute;
 
+    /* The lock-free scheduler's waiting, running and deferred counts,
+       packed into one word so that they change together. */
+    std::atomic<std::uint64_t> counts;
+
+    /* The lock-free scheduler's queue of jobs waiting to run */
+    boost::lockfree::queue<Job*> jobs;
+
     JobTypeData(
         JobTypeInfo const& info_,
         beast::insight::Collector::ptr const& collector,
@@ -61,6 +71,8 @@ public:
         , waiting(0)
         , running(0)
         , deferred(0)
+        , counts(0)
+        , jobs(0)
     {
         m_load.setTargetLatency(
             info.getAverageLatency(), info.getPeakLatency());
@@ -77,6 +89,13 @@ public:
     JobTypeData&
     operator=(JobTypeData const& other) = delete;
 
+    ~JobTypeData()
+    {
+        Job* job;
+        while (jobs.pop(job))
+            delete job;
+    }
+
     std::string
     name() const
     {
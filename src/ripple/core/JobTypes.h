@@ -89,6 +89,8 @@ private:
         add(jtCLIENT_WEBSOCKET,  "clientWebsocket",      maxLimit,  2000ms,  5000ms);
         add(jtRPC,               "RPC",                  maxLimit,     0ms,     0ms);
         add(jtUPDATE_PF,         "updatePaths",                 1,     0ms,     0ms);
+        add(jtPATH_UPDATE,       "updatePathRequests",          3,     0ms,     0ms);
+        add(jtPATH_GRAPH,        "buildTrustLineGraph",         1,     0ms,     0ms);
         add(jtTRANSACTION,       "transaction",          maxLimit,   250ms,  1000ms);
         add(jtBATCH,             "batch",                maxLimit,   250ms,  1000ms);
         add(jtADVANCE,           "advanceLedger",        maxLimit,     0ms,     0ms);
@@ -98,6 +100,8 @@ private:
         add(jtVALIDATION_t,      "trustedValidation",    maxLimit,   500ms,  1500ms);
         add(jtWRITE,             "writeObjects",         maxLimit,  1750ms,  2500ms);
         add(jtACCEPT,            "acceptLedger",         maxLimit,     0ms,     0ms);
+        add(jtLEDGER_FLUSH,      "flushLedgerNodes",     maxLimit,     0ms,     0ms);
+        add(jtLEDGER_APPLY,      "applyLedgerTxns",      maxLimit,     0ms,     0ms);
         add(jtPROPOSAL_t,        "trustedProposal",      maxLimit,   100ms,   500ms);
         add(jtSWEEP,             "sweep",                       1,     0ms,     0ms);
         add(jtNETOP_CLUSTER,     "clusterReport",               1,  9999ms,  9999ms);
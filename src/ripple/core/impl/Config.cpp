@@ -426,6 +426,8 @@ Config::setup(
     std::string ledgerTxDbType;
     Section ledgerTxTablesSection = section("ledger_tx_tables");
     get_if_exists(ledgerTxTablesSection, "use_tx_tables", USE_TX_TABLES);
+    get_if_exists(
+        ledgerTxTablesSection, "compact_tx_tables", COMPACT_TX_TABLES);
 
     Section& nodeDbSection{section(ConfigSection::nodeDatabase())};
     get_if_exists(nodeDbSection, "fast_load", FAST_LOAD);
@@ -690,6 +692,9 @@ Config::loadFromString(std::string const& fileContents)
                 ": must be between 1 and 1024 inclusive.");
     }
 
+    if (getSingleSection(secConfig, SECTION_LOCKFREE_JOB_QUEUE, strTemp, j_))
+        LOCKFREE_JOB_QUEUE = beast::lexicalCastThrow<bool>(strTemp);
+
     if (getSingleSection(secConfig, SECTION_IO_WORKERS, strTemp, j_))
     {
         IO_WORKERS = beast::lexicalCastThrow<int>(strTemp);
@@ -710,6 +715,26 @@ Config::loadFromString(std::string const& fileContents)
                 ": must be between 1 and 1024 inclusive.");
     }
 
+    if (getSingleSection(secConfig, SECTION_LEDGER_FLUSH_WORKERS, strTemp, j_))
+    {
+        LEDGER_FLUSH_WORKERS = beast::lexicalCastThrow<int>(strTemp);
+
+        if (LEDGER_FLUSH_WORKERS < 1 || LEDGER_FLUSH_WORKERS > 16)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_LEDGER_FLUSH_WORKERS
+                ": must be between 1 and 16 inclusive.");
+    }
+
+    if (getSingleSection(secConfig, SECTION_LEDGER_APPLY_WORKERS, strTemp, j_))
+    {
+        LEDGER_APPLY_WORKERS = beast::lexicalCastThrow<int>(strTemp);
+
+        if (LEDGER_APPLY_WORKERS < 1 || LEDGER_APPLY_WORKERS > 16)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_LEDGER_APPLY_WORKERS
+                ": must be between 1 and 16 inclusive.");
+    }
+
     if (getSingleSection(secConfig, SECTION_COMPRESSION, strTemp, j_))
         COMPRESSION = beast::lexicalCastThrow<bool>(strTemp);
 
@@ -20,25 +20,62 @@
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 namespace ripple {
 
+namespace {
+
+// The lock-free scheduler packs the waiting, deferred and running counts of
+// a job type into one 64 bit word, in fields of 24, 24 and 16 bits.
+constexpr std::uint64_t oneWaiting = 1;
+constexpr std::uint64_t oneDeferred = oneWaiting << 24;
+constexpr std::uint64_t oneRunning = oneDeferred << 24;
+constexpr std::uint64_t fieldMask = oneDeferred - 1;
+
+int
+waitingCount(std::uint64_t counts)
+{
+    return static_cast<int>(counts & fieldMask);
+}
+
+int
+deferredCount(std::uint64_t counts)
+{
+    return static_cast<int>((counts / oneDeferred) & fieldMask);
+}
+
+int
+runningCount(std::uint64_t counts)
+{
+    return static_cast<int>(counts / oneRunning);
+}
+
+}  // namespace
+
 JobQueue::JobQueue(
     int threadCount,
     beast::insight::Collector::ptr const& collector,
     beast::Journal journal,
     Logs& logs,
-    perf::PerfLog& perfLog)
+    perf::PerfLog& perfLog,
+    bool lockFree)
     : m_journal(journal)
     , m_lastJob(0)
     , m_invalidJobData(JobTypes::instance().getInvalid(), collector, logs)
     , m_processCount(0)
+    , lockFree_(lockFree)
     , m_workers(*this, &perfLog, "JobQueue", threadCount)
     , perfLog_(perfLog)
     , m_collector(collector)
 {
-    JLOG(m_journal.info()) << "Using " << threadCount << "  threads";
+    JLOG(m_journal.info()) << "Using " << threadCount << "  threads"
+                           << (lockFree_ ? " and the lock-free scheduler" : "");
 
     hook = m_collector->make_hook(std::bind(&JobQueue::collect, this));
     job_count = m_collector->make_gauge("job_count");
@@ -59,6 +96,9 @@ JobQueue::JobQueue(
             (void)result.second;
         }
     }
+
+    for (auto iter = m_jobData.rbegin(); iter != m_jobData.rend(); ++iter)
+        byPriority_.push_back(&iter->second);
 }
 
 JobQueue::~JobQueue()
@@ -71,7 +111,7 @@ void
 JobQueue::collect()
 {
     std::lock_guard lock(m_mutex);
-    job_count = m_jobSet.size();
+    job_count = lockFree_ ? queued_.load() : m_jobSet.size();
 }
 
 bool
@@ -97,6 +137,12 @@ JobQueue::addRefCountedJob(
         (type >= jtCLIENT && type <= jtCLIENT_WEBSOCKET) ||
         m_workers.getNumberOfThreads() > 0);
 
+    if (lockFree_)
+    {
+        addLockFreeJob(data, name, func);
+        return true;
+    }
+
     {
         std::lock_guard lock(m_mutex);
         auto result =
@@ -131,7 +177,7 @@ JobQueue::getJobCount(JobType t) const
 
     JobDataMap::const_iterator c = m_jobData.find(t);
 
-    return (c == m_jobData.end()) ? 0 : c->second.waiting;
+    return (c == m_jobData.end()) ? 0 : getCounts(c->second).first;
 }
 
 int
@@ -141,7 +187,11 @@ JobQueue::getJobCountTotal(JobType t) const
 
     JobDataMap::const_iterator c = m_jobData.find(t);
 
-    return (c == m_jobData.end()) ? 0 : (c->second.waiting + c->second.running);
+    if (c == m_jobData.end())
+        return 0;
+
+    auto const [waiting, running] = getCounts(c->second);
+    return waiting + running;
 }
 
 int
@@ -155,12 +205,80 @@ JobQueue::getJobCountGE(JobType t) const
     for (auto const& x : m_jobData)
     {
         if (x.first >= t)
-            ret += x.second.waiting;
+            ret += getCounts(x.second).first;
     }
 
     return ret;
 }
 
+void
+JobQueue::forEach(
+    JobType type,
+    std::string const& name,
+    std::size_t count,
+    std::size_t helpers,
+    std::function<void(std::size_t)> const& f,
+    std::function<bool(void)> const& stop)
+{
+    if (count == 0)
+        return;
+
+    // Helper jobs may start after the work is done, or not at all, so the
+    // calling thread also works and only waits for the helpers that
+    // started before it finished. Late helpers must not touch f.
+    struct State
+    {
+        std::atomic<std::size_t> next = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+        int running = 0;
+        bool closed = false;
+        std::exception_ptr error;
+    };
+    auto const state = std::make_shared<State>();
+
+    auto work = [state, count, &f, &stop]() {
+        try
+        {
+            for (std::size_t i;
+                 !(stop && stop()) && (i = state->next++) < count;)
+                f(i);
+        }
+        catch (...)
+        {
+            state->next = count;
+            std::lock_guard lock(state->mutex);
+            if (!state->error)
+                state->error = std::current_exception();
+        }
+    };
+
+    helpers = std::min(helpers, count - 1);
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        addJob(type, name, [state, work]() {
+            {
+                std::lock_guard lock(state->mutex);
+                if (state->closed)
+                    return;
+                ++state->running;
+            }
+            work();
+            std::lock_guard lock(state->mutex);
+            if (--state->running == 0)
+                state->cv.notify_all();
+        });
+    }
+
+    work();
+
+    std::unique_lock lock(state->mutex);
+    state->closed = true;
+    state->cv.wait(lock, [&state] { return state->running == 0; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
 std::unique_ptr<LoadEvent>
 JobQueue::makeLoadEvent(JobType t, std::string const& name)
 {
@@ -215,8 +333,7 @@ JobQueue::getJson(int c)
 
         LoadMonitor::Stats stats(data.stats());
 
-        int waiting(data.waiting);
-        int running(data.running);
+        auto const [waiting, running] = getCounts(data);
 
         if ((stats.count != 0) || (waiting != 0) ||
             (stats.latencyPeak != 0ms) || (running != 0))
@@ -254,7 +371,7 @@ void
 JobQueue::rendezvous()
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    cv_.wait(lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+    cv_.wait(lock, [this] { return isIdle(); });
 }
 
 JobTypeData&
@@ -271,6 +388,22 @@ JobQueue::getJobTypeData(JobType type)
     return c->second;
 }
 
+std::pair<int, int>
+JobQueue::getCounts(JobTypeData const& data) const
+{
+    if (!lockFree_)
+        return {data.waiting, data.running};
+
+    auto const counts = data.counts.load();
+    return {waitingCount(counts), runningCount(counts)};
+}
+
+bool
+JobQueue::isIdle() const
+{
+    return m_processCount == 0 && m_jobSet.empty() && queued_ == 0;
+}
+
 void
 JobQueue::stop()
 {
@@ -284,10 +417,10 @@ JobQueue::stop()
         // `Job::doJob` and the return of `JobQueue::processTask`. That is why
         // we must wait on the condition variable to make these assertions.
         std::unique_lock<std::mutex> lock(m_mutex);
-        cv_.wait(
-            lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+        cv_.wait(lock, [this] { return isIdle(); });
         assert(m_processCount == 0);
         assert(m_jobSet.empty());
+        assert(queued_ == 0);
         assert(nSuspend_ == 0);
         stopped_ = true;
     }
@@ -347,6 +480,99 @@ JobQueue::finishJob(JobType type)
     --data.running;
 }
 
+void
+JobQueue::addLockFreeJob(
+    JobTypeData& data,
+    std::string const& name,
+    JobFunction const& func)
+{
+    JobType const type = data.type();
+    int const limit = data.info.limit();
+
+    // Count the job as queued before any worker can see it, so the
+    // JobQueue never appears idle while it is in flight.
+    ++queued_;
+    auto job =
+        std::make_unique<Job>(type, name, ++m_lastJob, data.load(), func);
+    data.jobs.push(job.get());
+    job.release();
+    perfLog_.jobQueue(type);
+
+    // The job is queued before it is counted as waiting, so a worker that
+    // claims a waiting job always finds one in the queue.
+    auto counts = data.counts.load();
+    bool defer;
+    do
+    {
+        defer = waitingCount(counts) + runningCount(counts) >= limit;
+    } while (!data.counts.compare_exchange_weak(
+        counts, counts + oneWaiting + (defer ? oneDeferred : 0)));
+
+    if (!defer)
+        m_workers.addTask();
+}
+
+void
+JobQueue::getNextLockFreeJob(Job& job)
+{
+    // Each task added for the lock-free scheduler leaves one more job
+    // waiting than deferred, for a type below its limit, until a worker
+    // claims it. So a runnable job exists, though other workers may claim
+    // the ones seen first.
+    for (;;)
+    {
+        for (JobTypeData* data : byPriority_)
+        {
+            int const limit = data->info.limit();
+            auto counts = data->counts.load();
+            while (waitingCount(counts) > 0 && runningCount(counts) < limit)
+            {
+                if (!data->counts.compare_exchange_weak(
+                        counts, counts - oneWaiting + oneRunning))
+                    continue;
+
+                ++m_processCount;
+                --queued_;
+
+                Job* p = nullptr;
+                while (!data->jobs.pop(p))
+                    ;
+                std::unique_ptr<Job> claimed(p);
+                job = std::move(*claimed);
+                return;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void
+JobQueue::finishLockFreeJob(JobType type)
+{
+    assert(type != jtINVALID);
+
+    JobTypeData& data = getJobTypeData(type);
+
+    auto counts = data.counts.load();
+    bool undefer;
+    do
+    {
+        assert(runningCount(counts) > 0);
+        undefer = deferredCount(counts) > 0;
+    } while (!data.counts.compare_exchange_weak(
+        counts, counts - oneRunning - (undefer ? oneDeferred : 0)));
+
+    // Queue a deferred task if there was one
+    if (undefer)
+        m_workers.addTask();
+
+    if (--m_processCount == 0 && queued_ == 0)
+    {
+        std::lock_guard lock(m_mutex);
+        cv_.notify_all();
+    }
+}
+
 void
 JobQueue::processTask(int instance)
 {
@@ -357,6 +583,11 @@ JobQueue::processTask(int instance)
         Job::clock_type::time_point const start_time(Job::clock_type::now());
         {
             Job job;
+            if (lockFree_)
+            {
+                getNextLockFreeJob(job);
+            }
+            else
             {
                 std::lock_guard lock(m_mutex);
                 getNextJob(job);
@@ -386,6 +617,11 @@ JobQueue::processTask(int instance)
         }
     }
 
+    if (lockFree_)
+    {
+        finishLockFreeJob(type);
+    }
+    else
     {
         std::lock_guard lock(m_mutex);
         // Job should be destroyed before stopping
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_VALUESTREAM_H_INCLUDED
+#define RIPPLE_JSON_VALUESTREAM_H_INCLUDED
+
+#include <ripple/json/Output.h>
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Json {
+
+/** Writes a Json::Value in compact form, a piece at a time.
+
+    The output is the same as that of Json::stream and FastWriter, but each
+    call to write() returns once it has produced at least the requested
+    number of bytes, so that a large value can be sent while it is still
+    being serialized.
+
+    The stream owns the value, and releases each array and object as soon
+    as it has been written, so the memory held by the value shrinks as the
+    output grows.
+*/
+class ValueStream
+{
+public:
+    explicit ValueStream(Value&& value);
+
+    ValueStream(ValueStream&&) = default;
+    ValueStream&
+    operator=(ValueStream&&) = default;
+
+    /** Write the next part of the value.
+
+        @param output Where to write.
+        @param bytes Stop once at least this many bytes have been written.
+        @return `true` if the value has been written completely.
+    */
+    bool
+    write(Output const& output, std::size_t bytes);
+
+    /** Returns `true` if the value has been written completely. */
+    bool
+    done() const
+    {
+        return started_ && stack_.empty();
+    }
+
+private:
+    // An array or object being written
+    struct Frame
+    {
+        Value* value;
+        ValueIterator next;
+        ValueIterator end;
+        // For arrays, the index of the next element
+        Value::UInt index = 0;
+        bool first = true;
+    };
+
+    // Write a scalar, or open a collection and push its frame.
+    std::size_t
+    writeValue(Value& value, Output const& output);
+
+    // Write the next element of the collection on top of the stack.
+    std::size_t
+    step(Output const& output);
+
+    // Held by pointer so that the frames stay valid when moved
+    std::unique_ptr<Value> value_;
+    bool started_ = false;
+    std::vector<Frame> stack_;
+};
+
+}  // namespace Json
+
+#endif
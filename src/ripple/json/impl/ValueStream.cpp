@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/json/ValueStream.h>
+#include <ripple/json/json_writer.h>
+
+namespace Json {
+
+namespace {
+
+std::size_t
+put(Output const& output, std::string const& s)
+{
+    output(s);
+    return s.size();
+}
+
+std::size_t
+put(Output const& output, char const* s, std::size_t n)
+{
+    output({s, n});
+    return n;
+}
+
+}  // namespace
+
+ValueStream::ValueStream(Value&& value)
+    : value_(std::make_unique<Value>(std::move(value)))
+{
+}
+
+bool
+ValueStream::write(Output const& output, std::size_t bytes)
+{
+    std::size_t written = 0;
+
+    if (!started_)
+    {
+        started_ = true;
+        written += writeValue(*value_, output);
+    }
+
+    while (!stack_.empty() && written < bytes)
+        written += step(output);
+
+    return done();
+}
+
+std::size_t
+ValueStream::writeValue(Value& value, Output const& output)
+{
+    // The formatting here must match detail::write_value in json_writer.h
+    switch (value.type())
+    {
+        case nullValue:
+            return put(output, "null", 4);
+
+        case intValue:
+            return put(output, valueToString(value.asInt()));
+
+        case uintValue:
+            return put(output, valueToString(value.asUInt()));
+
+        case realValue:
+            return put(output, valueToString(value.asDouble()));
+
+        case stringValue:
+            return put(output, valueToQuotedString(value.asCString()));
+
+        case booleanValue:
+            return put(output, valueToString(value.asBool()));
+
+        case arrayValue:
+            stack_.push_back({&value, {}, {}});
+            return put(output, "[", 1);
+
+        case objectValue:
+            stack_.push_back({&value, value.begin(), value.end()});
+            return put(output, "{", 1);
+    }
+
+    return 0;
+}
+
+std::size_t
+ValueStream::step(Output const& output)
+{
+    // Note that writeValue may push a frame, which invalidates f
+    auto& f = stack_.back();
+    std::size_t written = 0;
+
+    if (f.value->isArray())
+    {
+        if (f.index < f.value->size())
+        {
+            if (!f.first)
+                written += put(output, ",", 1);
+            f.first = false;
+
+            // Missing elements of a sparse array are written as null
+            Value& element = (*f.value)[f.index++];
+            return written + writeValue(element, output);
+        }
+
+        written += put(output, "]", 1);
+    }
+    else
+    {
+        if (f.next != f.end)
+        {
+            if (!f.first)
+                written += put(output, ",", 1);
+            f.first = false;
+
+            written += put(output, valueToQuotedString(f.next.memberName()));
+            written += put(output, ":", 1);
+
+            Value& member = *f.next;
+            ++f.next;
+            return written + writeValue(member, output);
+        }
+
+        written += put(output, "}", 1);
+    }
+
+    // Release the contents of the collection just written
+    *f.value = Value();
+    stack_.pop_back();
+    return written;
+}
+
+}  // namespace Json
@@ -64,6 +64,9 @@ public:
     std::shared_ptr<SLE const>
     read(Keylet const& k) const override;
 
+    std::optional<STObjectView>
+    readFields(Keylet const& k) const override;
+
     bool
     open() const override
     {
@@ -97,6 +97,7 @@ private:
     detail::RawStateTable items_;
     std::shared_ptr<void const> hold_;
     bool open_ = true;
+    std::size_t baseTxCount_ = 0;
 
 public:
     OpenView() = delete;
@@ -170,6 +171,20 @@ public:
     */
     OpenView(ReadView const* base, std::shared_ptr<void const> hold = nullptr);
 
+    /** Construct a view of transactions that follow others.
+
+        Effects:
+
+            As for a new last closed ledger, except that
+            the apply ordinal of the first tx inserted is
+            `baseTxCount` rather than zero.
+
+        This allows transactions to be applied to a view
+        of their own and later applied, in order, to a
+        view that already holds `baseTxCount` tx.
+    */
+    OpenView(ReadView const* base, std::size_t baseTxCount);
+
     /** Returns true if this reflects an open ledger. */
     bool
     open() const override
@@ -180,7 +195,8 @@ public:
     /** Return the number of tx inserted since creation.
 
         This is used to set the "apply ordinal"
-        when calculating transaction metadata.
+        when calculating transaction metadata. It
+        includes the base count given on construction.
     */
     std::size_t
     txCount() const;
@@ -211,6 +227,9 @@ public:
     std::shared_ptr<SLE const>
     read(Keylet const& k) const override;
 
+    std::optional<STObjectView>
+    readFields(Keylet const& k) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
@@ -32,6 +32,7 @@
 #include <ripple/protocol/Rules.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STObjectView.h>
 #include <ripple/protocol/STTx.h>
 #include <cassert>
 #include <cstdint>
@@ -244,6 +245,18 @@ public:
     virtual std::shared_ptr<SLE const>
     read(Keylet const& k) const = 0;
 
+    /** Return a view of the fields of the state item associated with a key.
+
+        The fields are decoded only as they are read, which costs less
+        than read() for callers that need a few of them. The default
+        implementation serializes the SLE returned by read().
+
+        @return `std::nullopt` if the key is not present or
+                if the type does not match.
+    */
+    virtual std::optional<STObjectView>
+    readFields(Keylet const& k) const;
+
     // Accounts in a payment are not allowed to use assets acquired during that
     // payment. The PaymentSandbox tracks the debits, credits, and owner count
     // changes that accounts make during a payment. `balanceHook` adjusts
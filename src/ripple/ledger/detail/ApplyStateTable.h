@@ -20,6 +20,7 @@
 #ifndef RIPPLE_LEDGER_APPLYSTATETABLE_H_INCLUDED
 #define RIPPLE_LEDGER_APPLYSTATETABLE_H_INCLUDED
 
+#include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/XRPAmount.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/ledger/OpenView.h>
@@ -38,6 +39,11 @@ class ApplyStateTable
 public:
     using key_type = ReadView::key_type;
 
+    // Initial size of the arena that holds the fields of the metadata
+    // built for a transaction. Metadata for a typical transaction fits,
+    // so building it costs a single allocation.
+    static constexpr size_t initialMetaBufferSize = kilobytes(16);
+
 private:
     enum class Action {
         cache,
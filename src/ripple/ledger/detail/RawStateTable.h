@@ -86,6 +86,9 @@ public:
     std::shared_ptr<SLE const>
     read(ReadView const& base, Keylet const& k) const;
 
+    std::optional<STObjectView>
+    readFields(ReadView const& base, Keylet const& k) const;
+
     void
     destroyXRP(XRPAmount const& fee);
 
@@ -22,6 +22,7 @@
 #include <ripple/ledger/detail/ApplyStateTable.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/st.h>
+#include <boost/container/pmr/monotonic_buffer_resource.hpp>
 #include <cassert>
 
 namespace ripple {
@@ -123,7 +124,11 @@ ApplyStateTable::apply(
     std::shared_ptr<Serializer> sMeta;
     if (!to.open())
     {
-        TxMeta meta(tx.getTransactionID(), to.seq());
+        // The metadata is serialized before this returns, so the fields
+        // of its nodes can live in an arena that is released all at once.
+        boost::container::pmr::monotonic_buffer_resource arena{
+            initialMetaBufferSize};
+        TxMeta meta(tx.getTransactionID(), to.seq(), &arena);
         if (deliver)
             meta.setDeliveredAmount(*deliver);
         Mods newMod;
@@ -158,7 +163,7 @@ ApplyStateTable::apply(
                 assert(origNode && curNode);
                 threadOwners(to, meta, origNode, newMod, j);
 
-                STObject prevs(sfPreviousFields);
+                STObject prevs(sfPreviousFields, &arena);
                 for (auto const& obj : *origNode)
                 {
                     // go through the original node for
@@ -172,7 +177,7 @@ ApplyStateTable::apply(
                     meta.getAffectedNode(item.first)
                         .emplace_back(std::move(prevs));
 
-                STObject finals(sfFinalFields);
+                STObject finals(sfFinalFields, &arena);
                 for (auto const& obj : *curNode)
                 {
                     // go through the final node for final fields
@@ -193,7 +198,7 @@ ApplyStateTable::apply(
                                                 // item modified
                     threadItem(meta, curNode);
 
-                STObject prevs(sfPreviousFields);
+                STObject prevs(sfPreviousFields, &arena);
                 for (auto const& obj : *origNode)
                 {
                     // search the original node for values saved on modify
@@ -206,7 +211,7 @@ ApplyStateTable::apply(
                     meta.getAffectedNode(item.first)
                         .emplace_back(std::move(prevs));
 
-                STObject finals(sfFinalFields);
+                STObject finals(sfFinalFields, &arena);
                 for (auto const& obj : *curNode)
                 {
                     // search the final node for values saved always
@@ -227,7 +232,7 @@ ApplyStateTable::apply(
                 if (curNode->isThreadedType())  // always thread to self
                     threadItem(meta, curNode);
 
-                STObject news(sfNewFields);
+                STObject news(sfNewFields, &arena);
                 for (auto const& obj : *curNode)
                 {
                     // save non-default values
@@ -65,5 +65,13 @@ CachedViewImpl::read(Keylet const& k) const
     return iter->second;
 }
 
+std::optional<STObjectView>
+CachedViewImpl::readFields(Keylet const& k) const
+{
+    // Reading the fields in place from the base is cheaper than
+    // materializing the SLE to share it through the cache.
+    return base_.readFields(k);
+}
+
 }  // namespace detail
 }  // namespace ripple
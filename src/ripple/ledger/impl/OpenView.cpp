@@ -86,7 +86,8 @@ OpenView::OpenView(OpenView const& rhs)
     , base_{rhs.base_}
     , items_{rhs.items_}
     , hold_{rhs.hold_}
-    , open_{rhs.open_} {};
+    , open_{rhs.open_}
+    , baseTxCount_{rhs.baseTxCount_} {};
 
 OpenView::OpenView(
     open_ledger_t,
@@ -120,10 +121,16 @@ OpenView::OpenView(ReadView const* base, std::shared_ptr<void const> hold)
 {
 }
 
+OpenView::OpenView(ReadView const* base, std::size_t baseTxCount)
+    : OpenView(base)
+{
+    baseTxCount_ = baseTxCount;
+}
+
 std::size_t
 OpenView::txCount() const
 {
-    return txs_.size();
+    return baseTxCount_ + txs_.size();
 }
 
 void
@@ -173,6 +180,12 @@ OpenView::read(Keylet const& k) const
     return items_.read(*base_, k);
 }
 
+std::optional<STObjectView>
+OpenView::readFields(Keylet const& k) const
+{
+    return items_.readFields(*base_, k);
+}
+
 auto
 OpenView::slesBegin() const -> std::unique_ptr<sles_type::iter_base>
 {
@@ -319,6 +319,18 @@ RawStateTable::read(ReadView const& base, Keylet const& k) const
     return sle;
 }
 
+std::optional<STObjectView>
+RawStateTable::readFields(ReadView const& base, Keylet const& k) const
+{
+    auto const iter = items_.find(k.key);
+    if (iter == items_.end())
+        return base.readFields(k);
+    auto const& item = iter->second;
+    if (item.action == Action::erase || !k.check(*item.sle))
+        return std::nullopt;
+    return STObjectView(*item.sle);
+}
+
 void
 RawStateTable::destroyXRP(XRPAmount const& fee)
 {
@@ -65,6 +65,15 @@ ReadView::txs_type::end() const -> iterator
     return iterator(view_, view_->txsEnd());
 }
 
+std::optional<STObjectView>
+ReadView::readFields(Keylet const& k) const
+{
+    auto const sle = read(k);
+    if (!sle)
+        return std::nullopt;
+    return STObjectView(*sle);
+}
+
 Rules
 makeRulesGivenLedger(DigestAwareReadView const& ledger, Rules const& current)
 {
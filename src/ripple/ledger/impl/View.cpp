@@ -378,7 +378,7 @@ forEachItem(
 
     while (true)
     {
-        auto sle = view.read(pos);
+        auto sle = view.readFields(pos);
         if (!sle)
             return;
         for (auto const& key : sle->getFieldV256(sfIndexes))
@@ -411,7 +411,7 @@ forEachItemAfter(
     {
         auto const hintIndex = keylet::page(root, hint);
 
-        if (auto hintDir = view.read(hintIndex))
+        if (auto hintDir = view.readFields(hintIndex))
         {
             for (auto const& key : hintDir->getFieldV256(sfIndexes))
             {
@@ -427,7 +427,7 @@ forEachItemAfter(
         bool found = false;
         for (;;)
         {
-            auto const ownerDir = view.read(currentIndex);
+            auto const ownerDir = view.readFields(currentIndex);
             if (!ownerDir)
                 return found;
             for (auto const& key : ownerDir->getFieldV256(sfIndexes))
@@ -453,7 +453,7 @@ forEachItemAfter(
     {
         for (;;)
         {
-            auto const ownerDir = view.read(currentIndex);
+            auto const ownerDir = view.readFields(currentIndex);
             if (!ownerDir)
                 return true;
             for (auto const& key : ownerDir->getFieldV256(sfIndexes))
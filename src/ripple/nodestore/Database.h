@@ -27,6 +27,7 @@
 #include <ripple/protocol/SystemParameters.h>
 
 #include <condition_variable>
+#include <deque>
 #include <thread>
 
 namespace ripple {
@@ -162,6 +163,39 @@ public:
         std::uint32_t ledgerSeq,
         std::function<void(std::shared_ptr<NodeObject> const&)>&& callback);
 
+    /** Fetch a batch of objects without waiting.
+        The objects are read together by one of the read threads, so
+        backends that support batch reads can service the whole batch with
+        a single request.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve
+        @param ledgerSeq The sequence of the ledger where the
+                objects are stored, used by the shard store.
+        @param callback Callback function invoked once when all the reads
+                complete, with the objects in the same order as `hashes`.
+                Objects that could not be retrieved are `nullptr`.
+    */
+    virtual void
+    asyncFetchBatch(
+        std::vector<uint256>&& hashes,
+        std::uint32_t ledgerSeq,
+        std::function<void(std::vector<std::shared_ptr<NodeObject>> const&)>&&
+            callback);
+
+    /** Fetch a batch of node objects.
+        The default implementation fetches each object individually.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @param ledgerSeq The sequence of the ledger where the objects are
+                stored.
+        @return The objects, in the same order as `hashes`, with `nullptr`
+                for each object that couldn't be retrieved.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(std::vector<uint256> const& hashes, std::uint32_t ledgerSeq);
+
     /** Store a ledger from a different database.
 
         @param srcLedger The ledger to store.
@@ -371,6 +405,16 @@ private:
             std::function<void(std::shared_ptr<NodeObject> const&)>>>>
         read_;
 
+    // batches of reads to do
+    struct BatchRead
+    {
+        std::vector<uint256> hashes;
+        std::uint32_t ledgerSeq;
+        std::function<void(std::vector<std::shared_ptr<NodeObject>> const&)>
+            callback;
+    };
+    std::deque<BatchRead> readBatch_;
+
     std::atomic<bool> readStopping_ = false;
     std::atomic<int> readThreads_ = 0;
     std::atomic<int> runningThreads_ = 0;
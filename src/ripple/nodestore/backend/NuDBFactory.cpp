@@ -23,6 +23,7 @@
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
 #include <ripple/nodestore/impl/codec.h>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 #include <cassert>
 #include <chrono>
@@ -52,6 +53,11 @@ public:
     std::atomic<bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Objects written with zstd can be read back whichever codec is
+    // selected, so the zstd codec always exists.
+    bool const useZstd_;
+    ZstdCodec zstd_;
+
     NuDBBackend(
         size_t keyBytes,
         Section const& keyValues,
@@ -64,6 +70,13 @@ public:
         , name_(get(keyValues, "path"))
         , deletePath_(false)
         , scheduler_(scheduler)
+        , useZstd_(useZstd(keyValues))
+        , zstd_(
+              get<int>(keyValues, "zstd_level", 3),
+              get<bool>(keyValues, "zstd_dictionary", true),
+              name_,
+              scheduler,
+              journal)
     {
         if (name_.empty())
             Throw<std::runtime_error>(
@@ -84,12 +97,32 @@ public:
         , db_(context)
         , deletePath_(false)
         , scheduler_(scheduler)
+        , useZstd_(useZstd(keyValues))
+        , zstd_(
+              get<int>(keyValues, "zstd_level", 3),
+              get<bool>(keyValues, "zstd_dictionary", true),
+              name_,
+              scheduler,
+              journal)
     {
         if (name_.empty())
             Throw<std::runtime_error>(
                 "nodestore: Missing path in NuDB backend");
     }
 
+    static bool
+    useZstd(Section const& keyValues)
+    {
+        auto const compression = get(keyValues, "compression", "lz4");
+        if (boost::iequals(compression, "zstd"))
+            return true;
+        if (!boost::iequals(compression, "lz4"))
+            Throw<std::runtime_error>(
+                "nodestore: Unknown compression '" + compression +
+                "' in NuDB backend");
+        return false;
+    }
+
     ~NuDBBackend() override
     {
         try
@@ -209,9 +242,10 @@ public:
         nudb::error_code ec;
         db_.fetch(
             key,
-            [key, pno, &status](void const* data, std::size_t size) {
+            [this, key, pno, &status](void const* data, std::size_t size) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, &zstd_);
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
@@ -253,7 +287,8 @@ public:
         EncodedBlob e(no);
         nudb::error_code ec;
         nudb::detail::buffer bf;
-        auto const result = nodeobject_compress(e.getData(), e.getSize(), bf);
+        auto const result = nodeobject_compress(
+            e.getData(), e.getSize(), bf, useZstd_ ? &zstd_ : nullptr);
         db_.insert(e.getKey(), result.first, result.second, ec);
         if (ec && ec != nudb::error::key_exists)
             Throw<nudb::system_error>(ec);
@@ -308,7 +343,8 @@ public:
                 std::size_t size,
                 nudb::error_code&) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, &zstd_);
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
@@ -325,16 +325,44 @@ public:
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
+        assert(m_db);
+
         std::vector<std::shared_ptr<NodeObject>> results;
         results.reserve(hashes.size());
+        if (hashes.empty())
+            return {results, ok};
+
+        // Look up all the keys with a single MultiGet so that RocksDB can
+        // batch the block reads instead of servicing each key on its own.
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(hashes.size());
         for (auto const& h : hashes)
+            keys.emplace_back(
+                reinterpret_cast<char const*>(h->data()), m_keyBytes);
+
+        std::vector<std::string> values;
+        auto const statuses =
+            m_db->MultiGet(rocksdb::ReadOptions(), keys, &values);
+
+        for (std::size_t i = 0; i < hashes.size(); ++i)
         {
-            std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+            if (statuses[i].ok())
+            {
+                DecodedBlob decoded(
+                    hashes[i]->data(), values[i].data(), values[i].size());
+
+                if (decoded.wasOk())
+                {
+                    results.push_back(decoded.createObject());
+                    continue;
+                }
+            }
+            else if (!statuses[i].IsNotFound())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString();
+            }
+
+            results.push_back({});
         }
 
         return {results, ok};
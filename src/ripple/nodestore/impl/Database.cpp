@@ -67,6 +67,7 @@ Database::Database(
                     "db prefetch #" + std::to_string(i));
 
                 decltype(read_) read;
+                decltype(readBatch_) readBatch;
 
                 while (true)
                 {
@@ -76,7 +77,7 @@ Database::Database(
                         if (isStopping())
                             break;
 
-                        if (read_.empty())
+                        if (read_.empty() && readBatch_.empty())
                         {
                             runningThreads_--;
                             readCondVar_.wait(lock);
@@ -92,6 +93,14 @@ Database::Database(
                              !read_.empty() && cnt != requestBundle_;
                              ++cnt)
                             read.insert(read_.extract(read_.begin()));
+
+                        // a batch is already a bundle of requests, so take
+                        // one at a time to spread batches across threads.
+                        if (!readBatch_.empty())
+                        {
+                            readBatch.push_back(std::move(readBatch_.front()));
+                            readBatch_.pop_front();
+                        }
                     }
 
                     for (auto it = read.begin(); it != read.end(); ++it)
@@ -121,6 +130,12 @@ Database::Database(
                     }
 
                     read.clear();
+
+                    for (auto const& batch : readBatch)
+                        batch.callback(
+                            fetchBatch(batch.hashes, batch.ledgerSeq));
+
+                    readBatch.clear();
                 }
 
                 --runningThreads_;
@@ -171,6 +186,7 @@ Database::stop()
         {
             JLOG(j_.debug()) << "Clearing read queue because of stop request";
             read_.clear();
+            readBatch_.clear();
             readCondVar_.notify_all();
         }
     }
@@ -209,6 +225,31 @@ Database::asyncFetch(
     }
 }
 
+void
+Database::asyncFetchBatch(
+    std::vector<uint256>&& hashes,
+    std::uint32_t ledgerSeq,
+    std::function<void(std::vector<std::shared_ptr<NodeObject>> const&)>&& cb)
+{
+    std::lock_guard lock(readLock_);
+
+    if (!isStopping())
+    {
+        readBatch_.push_back({std::move(hashes), ledgerSeq, std::move(cb)});
+        readCondVar_.notify_one();
+    }
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatch(std::vector<uint256> const& hashes, std::uint32_t ledgerSeq)
+{
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(hashes.size());
+    for (auto const& hash : hashes)
+        results.push_back(fetchNodeObject(hash, ledgerSeq, FetchType::async));
+    return results;
+}
+
 void
 Database::importInternal(Backend& dstBackend, Database& srcDB)
 {
@@ -382,6 +423,7 @@ Database::getCountsJson(Json::Value& obj)
     {
         std::unique_lock<std::mutex> lock(readLock_);
         obj["read_queue"] = static_cast<Json::UInt>(read_.size());
+        obj["read_batch_queue"] = static_cast<Json::UInt>(readBatch_.size());
     }
 
     obj["read_threads_total"] = readThreads_.load();
@@ -144,7 +144,9 @@ DatabaseNodeImp::fetchNodeObject(
 }
 
 std::vector<std::shared_ptr<NodeObject>>
-DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
+DatabaseNodeImp::fetchBatch(
+    std::vector<uint256> const& hashes,
+    std::uint32_t)
 {
     std::vector<std::shared_ptr<NodeObject>> results{hashes.size()};
     using namespace std::chrono;
@@ -192,7 +194,7 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         }
         else
         {
-            JLOG(j_.error())
+            JLOG(j_.debug())
                 << "fetchBatch - "
                 << "record not found in db or cache. hash = " << strHex(hash);
             if (cache_)
@@ -73,7 +73,9 @@ public:
                 cacheSize.value_or(0),
                 std::chrono::minutes(cacheAge.value_or(0)),
                 stopwatch(),
-                j);
+                j,
+                beast::insight::NullCollector::New(),
+                true);
         }
 
         assert(backend_);
@@ -119,7 +121,8 @@ public:
     }
 
     std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch(std::vector<uint256> const& hashes);
+    fetchBatch(std::vector<uint256> const& hashes, std::uint32_t ledgerSeq)
+        override;
 
     void
     asyncFetch(
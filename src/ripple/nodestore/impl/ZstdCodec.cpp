@@ -0,0 +1,327 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/FileUtilities.h>
+#include <ripple/basics/Log.h>
+#include <ripple/nodestore/impl/ZstdCodec.h>
+#include <boost/filesystem.hpp>
+#include <boost/predef.h>
+#include <cerrno>
+#include <cstdio>
+#include <zdict.h>
+
+#if BOOST_OS_WINDOWS
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+// Compression and decompression contexts are expensive to create, so each
+// thread keeps its own.
+
+ZSTD_CCtx*
+compressionContext()
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx{
+        ZSTD_createCCtx(), &ZSTD_freeCCtx};
+    return ctx.get();
+}
+
+ZSTD_DCtx*
+decompressionContext()
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx{
+        ZSTD_createDCtx(), &ZSTD_freeDCtx};
+    return ctx.get();
+}
+
+// Write a file and sync it to storage, so that it survives a crash once
+// this returns without an error.
+void
+writeDurably(
+    boost::system::error_code& ec,
+    boost::filesystem::path const& file,
+    Blob const& data)
+{
+    using namespace boost::system::errc;
+
+    auto fail = [&ec]() {
+        ec = make_error_code(static_cast<errc_t>(errno));
+    };
+
+    // Write and sync a temporary file, then rename it into place, so that
+    // a crash never leaves a partial dictionary behind
+    auto const temp = boost::filesystem::path(file).concat(".tmp");
+    std::FILE* f = std::fopen(temp.string().c_str(), "wb");
+    if (!f)
+        return fail();
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size() &&
+        std::fflush(f) == 0;
+#if BOOST_OS_WINDOWS
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && ::fsync(::fileno(f)) == 0;
+#endif
+    if (!ok)
+        fail();
+    if (std::fclose(f) != 0 && ok)
+        return fail();
+    if (!ok)
+        return;
+
+    boost::filesystem::rename(temp, file, ec);
+    if (ec)
+        return;
+
+#if !BOOST_OS_WINDOWS
+    // The rename is only durable once the directory is synced
+    int const dir = ::open(file.parent_path().string().c_str(), O_RDONLY);
+    if (dir < 0)
+        return fail();
+    if (::fsync(dir) != 0)
+        fail();
+    ::close(dir);
+#endif
+}
+
+}  // namespace
+
+ZstdCodec::Dictionary::Dictionary(Blob const& data, int level)
+    : cdict(ZSTD_createCDict(data.data(), data.size(), level))
+    , ddict(ZSTD_createDDict(data.data(), data.size()))
+{
+    if (!cdict || !ddict)
+    {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+        Throw<std::runtime_error>("zstd: unable to load dictionary");
+    }
+}
+
+ZstdCodec::Dictionary::~Dictionary()
+{
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+}
+
+ZstdCodec::ZstdCodec(
+    int level,
+    bool useDictionaries,
+    boost::filesystem::path dictionaryPath,
+    Scheduler& scheduler,
+    beast::Journal journal,
+    std::size_t trainingBytes)
+    : level_(level)
+    , useDictionaries_(useDictionaries && !dictionaryPath.empty())
+    , dictionaryPath_(std::move(dictionaryPath))
+    , scheduler_(scheduler)
+    , j_(journal)
+    , trainingBytes_(trainingBytes)
+{
+    if (level_ < ZSTD_minCLevel() || level_ > ZSTD_maxCLevel())
+        Throw<std::runtime_error>(
+            "zstd: compression level must be between " +
+            std::to_string(ZSTD_minCLevel()) + " and " +
+            std::to_string(ZSTD_maxCLevel()));
+
+    if (dictionaryPath_.empty())
+        return;
+
+    for (std::size_t type = 1; type < byType_.size(); ++type)
+    {
+        auto const file = dictionaryFile(type);
+        if (!boost::filesystem::exists(file))
+            continue;
+
+        boost::system::error_code ec;
+        auto const contents = getFileContents(ec, file);
+        if (ec || contents.empty())
+            Throw<std::runtime_error>(
+                "zstd: unable to read dictionary " + file.string());
+
+        publish(type, Blob(contents.begin(), contents.end()));
+        JLOG(j_.info()) << "Loaded zstd dictionary " << file.string();
+    }
+}
+
+ZstdCodec::~ZstdCodec()
+{
+    std::unique_lock lock(mutex_);
+    trainingCondition_.wait(lock, [this] { return !trainingPending_; });
+}
+
+std::size_t
+ZstdCodec::compressFrame(
+    void* out,
+    std::size_t out_max,
+    void const* in,
+    std::size_t in_size,
+    Dictionary const* dict) const
+{
+    auto const ctx = compressionContext();
+    auto const n = dict
+        ? ZSTD_compress_usingCDict(ctx, out, out_max, in, in_size, dict->cdict)
+        : ZSTD_compressCCtx(ctx, out, out_max, in, in_size, level_);
+    if (ZSTD_isError(n))
+        Throw<std::runtime_error>(
+            std::string("zstd_compress: ") + ZSTD_getErrorName(n));
+    return n;
+}
+
+void
+ZstdCodec::decompressFrame(
+    void* out,
+    std::size_t out_size,
+    void const* in,
+    std::size_t in_size,
+    Dictionary const* dict) const
+{
+    auto const ctx = decompressionContext();
+    auto const n = dict
+        ? ZSTD_decompress_usingDDict(
+              ctx, out, out_size, in, in_size, dict->ddict)
+        : ZSTD_decompressDCtx(ctx, out, out_size, in, in_size);
+    if (ZSTD_isError(n))
+        Throw<std::runtime_error>(
+            std::string("zstd_decompress: ") + ZSTD_getErrorName(n));
+    if (n != out_size)
+        Throw<std::runtime_error>("zstd_decompress: size mismatch");
+}
+
+void
+ZstdCodec::sample(std::uint8_t type, void const* in, std::size_t in_size)
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto& s = samples_[type];
+        if (s.done)
+            return;
+
+        auto const p = static_cast<std::uint8_t const*>(in);
+        s.data.insert(s.data.end(), p, p + in_size);
+        s.sizes.push_back(in_size);
+        if (s.data.size() < trainingBytes_)
+            return;
+
+        // Training takes a while, so it is not done by the caller storing
+        // objects. Later objects of this type are compressed without a
+        // dictionary until training completes.
+        training_.emplace_back(type, std::move(s));
+        s = Samples{};
+        s.done = true;
+
+        if (trainingPending_)
+            return;
+        trainingPending_ = true;
+    }
+
+    scheduler_.scheduleTask(*this);
+}
+
+void
+ZstdCodec::performScheduledTask()
+{
+    for (;;)
+    {
+        std::pair<std::uint8_t, Samples> next;
+        {
+            std::lock_guard lock(mutex_);
+            if (training_.empty())
+            {
+                trainingPending_ = false;
+                trainingCondition_.notify_all();
+                return;
+            }
+            next = std::move(training_.front());
+            training_.pop_front();
+        }
+
+        try
+        {
+            train(next.first, next.second);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.warn()) << "Unable to train zstd dictionary for type "
+                            << static_cast<int>(next.first) << ": "
+                            << e.what();
+        }
+    }
+}
+
+void
+ZstdCodec::train(std::uint8_t type, Samples const& samples)
+{
+    Blob dict(dictionarySize);
+    auto const n = ZDICT_trainFromBuffer(
+        dict.data(),
+        dict.size(),
+        samples.data.data(),
+        samples.sizes.data(),
+        static_cast<unsigned>(samples.sizes.size()));
+    if (ZDICT_isError(n))
+    {
+        JLOG(j_.warn()) << "Unable to train zstd dictionary for type "
+                        << static_cast<int>(type) << ": "
+                        << ZDICT_getErrorName(n);
+        return;
+    }
+    dict.resize(n);
+
+    // The dictionary must be durable before any object depends on it.
+    auto const file = dictionaryFile(type);
+    boost::system::error_code ec;
+    writeDurably(ec, file, dict);
+    if (ec)
+    {
+        JLOG(j_.warn()) << "Unable to write zstd dictionary " << file.string()
+                        << ": " << ec.message();
+        return;
+    }
+
+    publish(type, dict);
+    JLOG(j_.info()) << "Trained zstd dictionary " << file.string() << " from "
+                    << samples.sizes.size() << " objects";
+}
+
+boost::filesystem::path
+ZstdCodec::dictionaryFile(std::uint8_t type) const
+{
+    return dictionaryPath_ / ("zstd." + std::to_string(type) + ".dict");
+}
+
+void
+ZstdCodec::publish(std::uint8_t type, Blob const& data)
+{
+    auto dict = std::make_unique<Dictionary>(data, level_);
+
+    std::lock_guard lock(mutex_);
+    samples_[type].done = true;
+    byType_[type].store(dict.get(), std::memory_order_release);
+    dictionaries_.push_back(std::move(dict));
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
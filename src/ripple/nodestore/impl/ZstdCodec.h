@@ -0,0 +1,235 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_ZSTDCODEC_H_INCLUDED
+#define RIPPLE_NODESTORE_ZSTDCODEC_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/contract.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/nodestore/Scheduler.h>
+#include <ripple/nodestore/Task.h>
+#include <boost/filesystem/path.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <deque>
+#include <utility>
+#include <vector>
+#include <zstd.h>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Zstandard compression of node objects, with per-type dictionaries.
+
+    Node objects are small and compressed one at a time, which leaves a
+    general purpose compressor little history to work with. When
+    dictionaries are enabled, the codec samples the first objects of each
+    NodeObjectType it compresses, trains a dictionary for that type with a
+    scheduled task, and uses it for every later object of the type.
+
+    Each dictionary is written to the dictionary directory, and synced to
+    storage, before it is first used. Dictionaries are loaded from there
+    when the codec is constructed, so that every object remains readable.
+    A compressed object consists of one byte naming the NodeObjectType
+    whose dictionary was used (zero if none) followed by a zstd frame.
+
+    @note The input to compress() and the output of decompress() are in
+          the format produced by EncodedBlob.
+*/
+class ZstdCodec : private Task
+{
+public:
+    /** Size of each trained dictionary. */
+    static constexpr std::size_t dictionarySize = 16 * 1024;
+
+    /** Number of sample bytes collected per type before training. */
+    static constexpr std::size_t defaultTrainingBytes = 100 * dictionarySize;
+
+    /** Create a codec.
+
+        @param level The zstd compression level.
+        @param useDictionaries Whether to train and use dictionaries when
+                               compressing. Existing dictionaries are loaded
+                               for decompression either way.
+        @param dictionaryPath Directory where dictionaries are stored. If
+                              empty, no dictionaries are loaded or trained.
+        @param scheduler Runs the task that trains dictionaries.
+        @param journal Destination for logging output.
+        @param trainingBytes Sample bytes to collect before training.
+    */
+    ZstdCodec(
+        int level,
+        bool useDictionaries,
+        boost::filesystem::path dictionaryPath,
+        Scheduler& scheduler,
+        beast::Journal journal,
+        std::size_t trainingBytes = defaultTrainingBytes);
+
+    /** Waits for any dictionary being trained. */
+    ~ZstdCodec();
+
+    ZstdCodec(ZstdCodec const&) = delete;
+    ZstdCodec&
+    operator=(ZstdCodec const&) = delete;
+
+    /** Returns `true` if compress() uses a dictionary for the given type. */
+    bool
+    hasDictionary(std::uint8_t type) const
+    {
+        return byType_[type].load(std::memory_order_acquire) != nullptr;
+    }
+
+    template <class BufferFactory>
+    std::pair<void const*, std::size_t>
+    compress(void const* in, std::size_t in_size, BufferFactory&& bf)
+    {
+        // The object type follows the 8 byte prefix of an encoded blob
+        std::uint8_t const type =
+            in_size > 8 ? static_cast<std::uint8_t const*>(in)[8] : 0;
+
+        Dictionary const* dict = nullptr;
+        if (useDictionaries_ && type != 0)
+        {
+            dict = byType_[type].load(std::memory_order_acquire);
+            if (!dict)
+                sample(type, in, in_size);
+        }
+
+        auto const out_max = ZSTD_compressBound(in_size);
+        std::uint8_t* out = reinterpret_cast<std::uint8_t*>(bf(1 + out_max));
+        out[0] = dict ? type : 0;
+        auto const out_size =
+            compressFrame(out + 1, out_max, in, in_size, dict);
+        return {out, 1 + out_size};
+    }
+
+    template <class BufferFactory>
+    std::pair<void const*, std::size_t>
+    decompress(void const* in, std::size_t in_size, BufferFactory&& bf) const
+    {
+        if (in_size < 2)
+            Throw<std::runtime_error>("zstd_decompress: invalid blob");
+
+        auto const p = static_cast<std::uint8_t const*>(in);
+
+        Dictionary const* dict = nullptr;
+        if (p[0] != 0)
+        {
+            dict = byType_[p[0]].load(std::memory_order_acquire);
+            if (!dict)
+                Throw<std::runtime_error>(
+                    "zstd_decompress: missing dictionary for type " +
+                    std::to_string(p[0]));
+        }
+
+        auto const outSize = ZSTD_getFrameContentSize(p + 1, in_size - 1);
+        if (outSize == ZSTD_CONTENTSIZE_ERROR ||
+            outSize == ZSTD_CONTENTSIZE_UNKNOWN)
+            Throw<std::runtime_error>("zstd_decompress: invalid frame");
+
+        if (outSize > std::numeric_limits<std::int32_t>::max())
+            Throw<std::runtime_error>(
+                "zstd_decompress: integer overflow (output)");
+
+        void* const out = bf(outSize);
+        decompressFrame(out, outSize, p + 1, in_size - 1, dict);
+        return {out, outSize};
+    }
+
+private:
+    void
+    performScheduledTask() override;
+
+    struct Dictionary
+    {
+        ZSTD_CDict* cdict;
+        ZSTD_DDict* ddict;
+
+        Dictionary(Blob const& data, int level);
+        ~Dictionary();
+    };
+
+    struct Samples
+    {
+        Blob data;
+        std::vector<std::size_t> sizes;
+        bool done = false;
+    };
+
+    std::size_t
+    compressFrame(
+        void* out,
+        std::size_t out_max,
+        void const* in,
+        std::size_t in_size,
+        Dictionary const* dict) const;
+
+    void
+    decompressFrame(
+        void* out,
+        std::size_t out_size,
+        void const* in,
+        std::size_t in_size,
+        Dictionary const* dict) const;
+
+    // Collect a sample, scheduling training once there are enough
+    void
+    sample(std::uint8_t type, void const* in, std::size_t in_size);
+
+    void
+    train(std::uint8_t type, Samples const& samples);
+
+    boost::filesystem::path
+    dictionaryFile(std::uint8_t type) const;
+
+    void
+    publish(std::uint8_t type, Blob const& data);
+
+    int const level_;
+    bool const useDictionaries_;
+    boost::filesystem::path const dictionaryPath_;
+    Scheduler& scheduler_;
+    beast::Journal const j_;
+    std::size_t const trainingBytes_;
+
+    std::array<std::atomic<Dictionary const*>, 256> byType_{};
+
+    std::mutex mutex_;
+    std::map<std::uint8_t, Samples> samples_;
+    std::vector<std::unique_ptr<Dictionary>> dictionaries_;
+
+    // Samples waiting to be trained, and whether the task is scheduled
+    std::deque<std::pair<std::uint8_t, Samples>> training_;
+    bool trainingPending_ = false;
+    std::condition_variable trainingCondition_;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -26,6 +26,7 @@
 #include <ripple/basics/contract.h>
 #include <ripple/basics/safe_cast.h>
 #include <ripple/nodestore/NodeObject.h>
+#include <ripple/nodestore/impl/ZstdCodec.h>
 #include <ripple/nodestore/impl/varint.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <cstddef>
@@ -101,11 +102,19 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    4 = zstd compressed
+
+    Objects of type 4 can only be decompressed with the ZstdCodec, and
+    hence the dictionaries, that compressed them.
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_decompress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    ZstdCodec const* zstd = nullptr)
 {
     using namespace nudb::detail;
 
@@ -199,6 +208,14 @@ nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
             write(os, is(512), 512);
             break;
         }
+        case 4:  // zstd
+        {
+            if (!zstd)
+                Throw<std::runtime_error>(
+                    "nodeobject codec: zstd object without a zstd codec");
+            result = zstd->decompress(p, in_size, bf);
+            break;
+        }
         default:
             Throw<std::runtime_error>(
                 "nodeobject codec: bad type=" + std::to_string(type));
@@ -214,9 +231,18 @@ zero32()
     return v.data();
 }
 
+/** Compress a node object for storage.
+
+    Inner nodes are always stored in the compact v1 formats. Other objects
+    are compressed with zstd if a codec is given, and with lz4 otherwise.
+*/
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_compress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    ZstdCodec* zstd = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
@@ -280,7 +306,7 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
 
     std::array<std::uint8_t, varint_traits<std::size_t>::max> vi;
 
-    constexpr std::size_t codecType = 1;
+    std::size_t const codecType = zstd ? 4 : 1;
     auto const vn = write_varint(vi.data(), codecType);
     std::pair<void const*, std::size_t> result;
     switch (codecType)
@@ -299,6 +325,19 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
             result.second = vn + lzr.second;
             break;
         }
+        case 4:  // zstd
+        {
+            std::uint8_t* p;
+            auto const zr =
+                zstd->compress(in, in_size, [&p, &vn, &bf](std::size_t n) {
+                    p = reinterpret_cast<std::uint8_t*>(bf(vn + n));
+                    return p + vn;
+                });
+            std::memcpy(p, vi.data(), vn);
+            result.first = p;
+            result.second = vn + zr.second;
+            break;
+        }
         default:
             Throw<std::logic_error>(
                 "nodeobject codec: unknown=" + std::to_string(codecType));
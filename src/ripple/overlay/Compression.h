@@ -33,7 +33,7 @@ std::size_t constexpr headerBytesCompressed = 10;
 
 // All values other than 'none' must have the high bit. The low order four bits
 // must be 0.
-enum class Algorithm : std::uint8_t { None = 0x00, LZ4 = 0x90 };
+enum class Algorithm : std::uint8_t { None = 0x00, LZ4 = 0x90, Zstd = 0xA0 };
 
 enum class Compressed : std::uint8_t { On, Off };
 
@@ -59,6 +59,47 @@ decompress(
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Decompress(
                 in, inSize, decompressed, decompressedSize);
+        else if (algorithm == Algorithm::Zstd)
+            return ripple::compression_algorithms::zstdDecompress(
+                in, inSize, decompressed, decompressedSize);
+        else
+        {
+            JLOG(debugLog().warn())
+                << "decompress: invalid compression algorithm "
+                << static_cast<int>(algorithm);
+            assert(0);
+        }
+    }
+    catch (...)
+    {
+    }
+    return 0;
+}
+
+/** Decompress contiguous input.
+ * @param in Compressed data
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed message
+ * @param decompressedSize Size of the decompressed message
+ * @param algorithm Compression algorithm type
+ * @return Size of decompressed data or zero if failed to decompress
+ */
+inline std::size_t
+decompress(
+    std::uint8_t const* in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize,
+    Algorithm algorithm = Algorithm::LZ4)
+{
+    try
+    {
+        if (algorithm == Algorithm::LZ4)
+            return ripple::compression_algorithms::lz4Decompress(
+                in, inSize, decompressed, decompressedSize);
+        else if (algorithm == Algorithm::Zstd)
+            return ripple::compression_algorithms::zstdDecompress(
+                in, inSize, decompressed, decompressedSize);
         else
         {
             JLOG(debugLog().warn())
@@ -95,6 +136,9 @@ compress(
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Compress(
                 in, inSize, std::forward<BufferFactory>(bf));
+        else if (algorithm == Algorithm::Zstd)
+            return ripple::compression_algorithms::zstdCompress(
+                in, inSize, std::forward<BufferFactory>(bf));
         else
         {
             JLOG(debugLog().warn()) << "compress: invalid compression algorithm"
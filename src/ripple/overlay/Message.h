@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 
 namespace ripple {
@@ -86,6 +87,29 @@ public:
     std::vector<uint8_t> const&
     getBuffer(Compressed tryCompressed);
 
+    /** Retrieve the packed message data for a peer.
+     * The message is compressed with the algorithm that compressionFor
+     * selects for it, once per algorithm, however many peers request it.
+     * @param negotiated The compression algorithm negotiated with the peer
+     * @return Payload buffer
+     */
+    std::vector<uint8_t> const&
+    getBuffer(Algorithm negotiated);
+
+    /** Select the compression algorithm for a message.
+     * Bulk messages (ledger data, object replies, transaction batches) are
+     * compressed with the negotiated algorithm once they are large enough
+     * for zstd to pay off. Other compressible messages use LZ4, and
+     * messages that are small or do not compress, such as validations and
+     * proposals, are sent uncompressed.
+     * @param type Protocol message type
+     * @param messageBytes Size of the uncompressed payload
+     * @param negotiated The compression algorithm negotiated with the peer
+     * @return Compression algorithm, None if the message is not compressed
+     */
+    static Algorithm
+    compressionFor(int type, std::size_t messageBytes, Algorithm negotiated);
+
     /** Get the traffic category */
     std::size_t
     getCategory() const
@@ -101,10 +125,22 @@ public:
     }
 
 private:
+    // A buffer compressed with one algorithm
+    struct CompressedBuffer
+    {
+        std::once_flag once;
+        std::vector<uint8_t> buffer;
+    };
+
+    /** Bulk messages use zstd at least this large; smaller ones compress
+     * about as well and faster with LZ4.
+     */
+    static constexpr std::size_t zstdMinimumBytes = 1024;
+
     std::vector<uint8_t> buffer_;
-    std::vector<uint8_t> bufferCompressed_;
+    // Indexed by compressedIndex
+    std::array<CompressedBuffer, 2> compressed_;
     std::size_t category_;
-    std::once_flag once_flag_;
     std::optional<PublicKey> validatorKey_;
 
     /** Set the payload header
@@ -112,7 +148,7 @@ private:
      * @param payloadBytes Size of the payload excluding the header size
      * @param type Protocol message type
      * @param compression Compression algorithm used in compression,
-     *   currently LZ4 only. If None then the message is uncompressed.
+     *   LZ4 or Zstd. If None then the message is uncompressed.
      * @param uncompressedBytes Size of the uncompressed message
      */
     void
@@ -124,11 +160,20 @@ private:
         std::uint32_t uncompressedBytes);
 
     /** Try to compress the payload.
-     * Can be called concurrently by multiple peers but is compressed once.
-     * If the message is not compressible then the serialized buffer_ is used.
+     * Can be called concurrently by multiple peers but is compressed once
+     * per algorithm. If the message is not compressible then the serialized
+     * buffer_ is used.
+     * @param algorithm Compression algorithm, LZ4 or Zstd
+     * @param compressed Buffer to hold the compressed message
      */
     void
-    compress();
+    compress(Algorithm algorithm, std::vector<uint8_t>& compressed);
+
+    static std::size_t
+    compressedIndex(Algorithm algorithm)
+    {
+        return algorithm == Algorithm::Zstd ? 1 : 0;
+    }
 
     /** Get the message type from the payload header.
      * First four bytes are the compression/algorithm flag and the payload size.
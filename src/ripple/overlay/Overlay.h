@@ -74,6 +74,10 @@ public:
         std::uint32_t crawlOptions = 0;
         std::optional<std::uint32_t> networkID;
         bool vlEnabled = true;
+        // The most bytes of queued messages gathered into one write to a
+        // peer. The default matches the buffer that the SSL stream
+        // flattens writes into.
+        std::size_t maxWriteBytes = 64 * 1024;
     };
 
     using PeerSequence = std::vector<std::shared_ptr<Peer>>;
@@ -70,6 +70,21 @@ featureEnabled(
     return isFeatureValue(headers, feature, "1");
 }
 
+char const*
+compressionName(compression::Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+        case compression::Algorithm::LZ4:
+            return "lz4";
+        case compression::Algorithm::Zstd:
+            return "zstd";
+        case compression::Algorithm::None:
+            break;
+    }
+    return "none";
+}
+
 std::string
 makeFeaturesRequestHeader(
     bool comprEnabled,
@@ -79,7 +94,8 @@ makeFeaturesRequestHeader(
 {
     std::stringstream str;
     if (comprEnabled)
-        str << FEATURE_COMPR << "=lz4" << DELIM_FEATURE;
+        str << FEATURE_COMPR << "=zstd" << DELIM_VALUE << "lz4"
+            << DELIM_FEATURE;
     if (ledgerReplayEnabled)
         str << FEATURE_LEDGER_REPLAY << "=1" << DELIM_FEATURE;
     if (txReduceRelayEnabled)
@@ -98,8 +114,11 @@ makeFeaturesResponseHeader(
     bool vpReduceRelayEnabled)
 {
     std::stringstream str;
-    if (comprEnabled && isFeatureValue(headers, FEATURE_COMPR, "lz4"))
-        str << FEATURE_COMPR << "=lz4" << DELIM_FEATURE;
+    // Peers that predate zstd only offer lz4
+    if (auto const algorithm = peerCompression(headers, comprEnabled);
+        algorithm != compression::Algorithm::None)
+        str << FEATURE_COMPR << "=" << compressionName(algorithm)
+            << DELIM_FEATURE;
     if (ledgerReplayEnabled && featureEnabled(headers, FEATURE_LEDGER_REPLAY))
         str << FEATURE_LEDGER_REPLAY << "=1" << DELIM_FEATURE;
     if (txReduceRelayEnabled && featureEnabled(headers, FEATURE_TXRR))
@@ -22,6 +22,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/overlay/Compression.h>
 #include <ripple/overlay/impl/ProtocolVersion.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <boost/asio/ip/tcp.hpp>
@@ -216,6 +217,33 @@ peerFeatureEnabled(
     return config && peerFeatureEnabled(request, feature, "1", config);
 }
 
+/** Get the compression algorithm to use with a peer. An inbound peer
+    offers the algorithms it supports and the response accepts the first
+    one of zstd and lz4 that it offers. An outbound peer's response
+    carries the accepted algorithm.
+   @tparam headers request (inbound) or response (outbound) header
+   @param request http headers
+   @param config compression's configuration value
+   @return the compression algorithm, None if compression is disabled
+ */
+template <typename headers>
+compression::Algorithm
+peerCompression(headers const& request, bool config)
+{
+    if (peerFeatureEnabled(request, FEATURE_COMPR, "zstd", config))
+        return compression::Algorithm::Zstd;
+    if (peerFeatureEnabled(request, FEATURE_COMPR, "lz4", config))
+        return compression::Algorithm::LZ4;
+    return compression::Algorithm::None;
+}
+
+/** Get the name of a compression algorithm in the X-Protocol-Ctl header
+   @param algorithm compression algorithm
+   @return the algorithm's name
+ */
+char const*
+compressionName(compression::Algorithm algorithm);
+
 /** Make request header X-Protocol-Ctl value with supported features
    @param comprEnabled if true then compression feature is enabled
    @param ledgerReplayEnabled if true then ledger-replay feature is enabled
@@ -64,75 +64,85 @@ Message::totalSize(::google::protobuf::Message const& message)
     return messageSize(message) + compression::headerBytes;
 }
 
+// static
+Message::Algorithm
+Message::compressionFor(
+    int type,
+    std::size_t messageBytes,
+    Algorithm negotiated)
+{
+    using namespace ripple::compression;
+
+    if (negotiated == Algorithm::None || messageBytes <= 70)
+        return Algorithm::None;
+
+    // Bulk messages use the negotiated algorithm once they are large
+    // enough for its better ratio to be worth the extra CPU.
+    auto const bulk = [&] {
+        return messageBytes >= zstdMinimumBytes ? negotiated : Algorithm::LZ4;
+    };
+
+    switch (type)
+    {
+        case protocol::mtLEDGER_DATA:
+        case protocol::mtGET_OBJECTS:
+        case protocol::mtTRANSACTIONS:
+        case protocol::mtVALIDATORLIST:
+        case protocol::mtVALIDATORLISTCOLLECTION:
+        case protocol::mtREPLAY_DELTA_RESPONSE:
+            return bulk();
+        case protocol::mtMANIFESTS:
+        case protocol::mtENDPOINTS:
+        case protocol::mtTRANSACTION:
+        case protocol::mtGET_LEDGER:
+            return Algorithm::LZ4;
+        case protocol::mtPING:
+        case protocol::mtCLUSTER:
+        case protocol::mtPROPOSE_LEDGER:
+        case protocol::mtSTATUS_CHANGE:
+        case protocol::mtHAVE_SET:
+        case protocol::mtVALIDATION:
+        case protocol::mtGET_PEER_SHARD_INFO:
+        case protocol::mtPEER_SHARD_INFO:
+        case protocol::mtPROOF_PATH_REQ:
+        case protocol::mtPROOF_PATH_RESPONSE:
+        case protocol::mtREPLAY_DELTA_REQ:
+        case protocol::mtGET_PEER_SHARD_INFO_V2:
+        case protocol::mtPEER_SHARD_INFO_V2:
+        case protocol::mtHAVE_TRANSACTIONS:
+            break;
+    }
+    return Algorithm::None;
+}
+
 void
-Message::compress()
+Message::compress(Algorithm algorithm, std::vector<uint8_t>& compressed)
 {
     using namespace ripple::compression;
     auto const messageBytes = buffer_.size() - headerBytes;
 
     auto type = getType(buffer_.data());
 
-    bool const compressible = [&] {
-        if (messageBytes <= 70)
-            return false;
-        switch (type)
-        {
-            case protocol::mtMANIFESTS:
-            case protocol::mtENDPOINTS:
-            case protocol::mtTRANSACTION:
-            case protocol::mtGET_LEDGER:
-            case protocol::mtLEDGER_DATA:
-            case protocol::mtGET_OBJECTS:
-            case protocol::mtVALIDATORLIST:
-            case protocol::mtVALIDATORLISTCOLLECTION:
-            case protocol::mtREPLAY_DELTA_RESPONSE:
-            case protocol::mtTRANSACTIONS:
-                return true;
-            case protocol::mtPING:
-            case protocol::mtCLUSTER:
-            case protocol::mtPROPOSE_LEDGER:
-            case protocol::mtSTATUS_CHANGE:
-            case protocol::mtHAVE_SET:
-            case protocol::mtVALIDATION:
-            case protocol::mtGET_PEER_SHARD_INFO:
-            case protocol::mtPEER_SHARD_INFO:
-            case protocol::mtPROOF_PATH_REQ:
-            case protocol::mtPROOF_PATH_RESPONSE:
-            case protocol::mtREPLAY_DELTA_REQ:
-            case protocol::mtGET_PEER_SHARD_INFO_V2:
-            case protocol::mtPEER_SHARD_INFO_V2:
-            case protocol::mtHAVE_TRANSACTIONS:
-                break;
-        }
-        return false;
-    }();
-
-    if (compressible)
+    auto payload = static_cast<void const*>(buffer_.data() + headerBytes);
+
+    auto compressedSize = ripple::compression::compress(
+        payload,
+        messageBytes,
+        [&](std::size_t inSize) {  // size of required compressed buffer
+            compressed.resize(inSize + headerBytesCompressed);
+            return (compressed.data() + headerBytesCompressed);
+        },
+        algorithm);
+
+    if (compressedSize != 0 &&
+        compressedSize < (messageBytes - (headerBytesCompressed - headerBytes)))
     {
-        auto payload = static_cast<void const*>(buffer_.data() + headerBytes);
-
-        auto compressedSize = ripple::compression::compress(
-            payload,
-            messageBytes,
-            [&](std::size_t inSize) {  // size of required compressed buffer
-                bufferCompressed_.resize(inSize + headerBytesCompressed);
-                return (bufferCompressed_.data() + headerBytesCompressed);
-            });
-
-        if (compressedSize <
-            (messageBytes - (headerBytesCompressed - headerBytes)))
-        {
-            bufferCompressed_.resize(headerBytesCompressed + compressedSize);
-            setHeader(
-                bufferCompressed_.data(),
-                compressedSize,
-                type,
-                Algorithm::LZ4,
-                messageBytes);
-        }
-        else
-            bufferCompressed_.resize(0);
+        compressed.resize(headerBytesCompressed + compressedSize);
+        setHeader(
+            compressed.data(), compressedSize, type, algorithm, messageBytes);
     }
+    else
+        compressed.resize(0);
 }
 
 /** Set payload header
@@ -209,13 +219,26 @@ Message::getBufferSize()
 std::vector<uint8_t> const&
 Message::getBuffer(Compressed tryCompressed)
 {
-    if (tryCompressed == Compressed::Off)
+    return getBuffer(
+        tryCompressed == Compressed::On ? Algorithm::LZ4 : Algorithm::None);
+}
+
+std::vector<uint8_t> const&
+Message::getBuffer(Algorithm negotiated)
+{
+    auto const algorithm = compressionFor(
+        getType(buffer_.data()),
+        buffer_.size() - compression::headerBytes,
+        negotiated);
+    if (algorithm == Algorithm::None)
         return buffer_;
 
-    std::call_once(once_flag_, &Message::compress, this);
+    auto& c = compressed_[compressedIndex(algorithm)];
+    std::call_once(
+        c.once, &Message::compress, this, algorithm, std::ref(c.buffer));
 
-    if (bufferCompressed_.size() > 0)
-        return bufferCompressed_;
+    if (c.buffer.size() > 0)
+        return c.buffer;
     else
         return buffer_;
 }
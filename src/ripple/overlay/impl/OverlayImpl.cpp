@@ -141,6 +141,7 @@ OverlayImpl::OverlayImpl(
     , next_id_(1)
     , timer_count_(0)
     , slots_(app.logs(), *this)
+    , signatureBatcher_(app)
     , m_stats(
           std::bind(&OverlayImpl::collect_metrics, this),
           collector,
@@ -568,20 +569,33 @@ OverlayImpl::stop()
 void
 OverlayImpl::onWrite(beast::PropertyStream::Map& stream)
 {
-    beast::PropertyStream::Set set("traffic", stream);
-    auto const stats = m_traffic.getCounts();
-    for (auto const& i : stats)
     {
-        if (i)
+        beast::PropertyStream::Set set("traffic", stream);
+        auto const stats = m_traffic.getCounts();
+        for (auto const& i : stats)
         {
-            beast::PropertyStream::Map item(set);
-            item["category"] = i.name;
-            item["bytes_in"] = std::to_string(i.bytesIn.load());
-            item["messages_in"] = std::to_string(i.messagesIn.load());
-            item["bytes_out"] = std::to_string(i.bytesOut.load());
-            item["messages_out"] = std::to_string(i.messagesOut.load());
+            if (i)
+            {
+                beast::PropertyStream::Map item(set);
+                item["category"] = i.name;
+                item["bytes_in"] = std::to_string(i.bytesIn.load());
+                item["messages_in"] = std::to_string(i.messagesIn.load());
+                item["bytes_out"] = std::to_string(i.bytesOut.load());
+                item["messages_out"] = std::to_string(i.messagesOut.load());
+            }
         }
     }
+
+    {
+        beast::PropertyStream::Map item("writes", stream);
+        auto const writes = m_traffic.writes();
+        auto const messages = m_traffic.writtenMessages();
+        item["writes"] = std::to_string(writes);
+        item["messages"] = std::to_string(messages);
+        if (messages != 0)
+            item["writes_per_message"] = std::to_string(
+                static_cast<double>(writes) / messages);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -674,6 +688,12 @@ OverlayImpl::onManifests(
                      std::shared_ptr<PeerImp>&& p) { p->send(m2); });
 }
 
+void
+OverlayImpl::reportWrite(std::size_t messages)
+{
+    m_traffic.addWrite(messages);
+}
+
 void
 OverlayImpl::reportTraffic(
     TrafficCount::category cat,
@@ -1220,6 +1240,19 @@ OverlayImpl::findPeerByPublicKey(PublicKey const& pubKey)
     return {};
 }
 
+void
+OverlayImpl::precompress(Message& m) const
+{
+    // Compress the message here, once, instead of in the strand of the
+    // first peer to send it while the strands of the others wait for it.
+    // Zstd is offered first, so that is what upgraded peers negotiate;
+    // messages that zstd is not selected for are compressed with LZ4.
+    // Proposals and validations are never compressed, so they are not
+    // passed here.
+    if (app_.config().COMPRESSION)
+        m.getBuffer(compression::Algorithm::Zstd);
+}
+
 void
 OverlayImpl::broadcast(protocol::TMProposeSet& m)
 {
@@ -1309,6 +1342,7 @@ OverlayImpl::relay(
     std::set<Peer::id_t> const& toSkip)
 {
     auto const sm = std::make_shared<Message>(m, protocol::mtTRANSACTION);
+    precompress(*sm);
     std::size_t total = 0;
     std::size_t disabled = 0;
     std::size_t enabledInSkip = 0;
@@ -1546,6 +1580,8 @@ setup_Overlay(BasicConfig const& config)
         if (setup.ipLimit < 0)
             Throw<std::runtime_error>("Configured IP limit is invalid");
 
+        set(setup.maxWriteBytes, "max_write_bytes", section);
+
         std::string ip;
         set(ip, "public_ip", section);
         if (!ip.empty())
@@ -29,6 +29,7 @@
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/Slot.h>
 #include <ripple/overlay/impl/Handshake.h>
+#include <ripple/overlay/impl/SignatureBatcher.h>
 #include <ripple/overlay/impl/TrafficCount.h>
 #include <ripple/overlay/impl/TxMetrics.h>
 #include <ripple/peerfinder/PeerfinderManager.h>
@@ -130,6 +131,9 @@ private:
     // Transaction reduce-relay metrics
     metrics::TxMetrics txMetrics_;
 
+    // Batches signature checks of transactions received from peers
+    SignatureBatcher signatureBatcher_;
+
     // A message with the list of manifests we send to peers
     std::shared_ptr<Message> manifestMessage_;
     // Used to track whether we need to update the cached list of manifests
@@ -350,6 +354,16 @@ public:
     void
     reportTraffic(TrafficCount::category cat, bool isInbound, int bytes);
 
+    /** Account for a write to a peer of the given number of messages. */
+    void
+    reportWrite(std::size_t messages);
+
+    SignatureBatcher&
+    signatureBatcher()
+    {
+        return signatureBatcher_;
+    }
+
     void
     incJqTransOverflow() override
     {
@@ -570,6 +584,10 @@ private:
     void
     deleteIdlePeers();
 
+    /** Compress a compressible message that is about to be relayed. */
+    void
+    precompress(Message& m) const;
+
 private:
     struct TrafficGauges
     {
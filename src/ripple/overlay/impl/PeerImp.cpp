@@ -50,6 +50,7 @@
 #include <mutex>
 #include <numeric>
 #include <sstream>
+#include <utility>
 
 using namespace std::chrono_literals;
 
@@ -100,14 +101,7 @@ PeerImp::PeerImp(
     , slot_(slot)
     , request_(std::move(request))
     , headers_(request_)
-    , compressionEnabled_(
-          peerFeatureEnabled(
-              headers_,
-              FEATURE_COMPR,
-              "lz4",
-              app_.config().COMPRESSION)
-              ? Compressed::On
-              : Compressed::Off)
+    , compression_(peerCompression(headers_, app_.config().COMPRESSION))
     , txReduceRelayEnabled_(peerFeatureEnabled(
           headers_,
           FEATURE_TXRR,
@@ -122,8 +116,7 @@ PeerImp::PeerImp(
           app_.config().LEDGER_REPLAY))
     , ledgerReplayMsgHandler_(app, app.getLedgerReplayer())
 {
-    JLOG(journal_.info()) << "compression enabled "
-                          << (compressionEnabled_ == Compressed::On)
+    JLOG(journal_.info()) << "compression " << compressionName(compression_)
                           << " vp reduce-relay enabled "
                           << vpReduceRelayEnabled_
                           << " tx reduce-relay enabled "
@@ -241,7 +234,24 @@ void
 PeerImp::send(std::shared_ptr<Message> const& m)
 {
     if (!strand_.running_in_this_thread())
-        return post(strand_, std::bind(&PeerImp::send, shared_from_this(), m));
+    {
+        // Relaying fans a message out to every peer, so rather than post a
+        // handler per message, leave it in the inbox and post only if the
+        // strand is not already due to drain it.
+        bool notify = false;
+        {
+            std::lock_guard lock(sendMutex_);
+            if (sendClosed_)
+                return;
+            sendInbox_.push_back(m);
+            notify = !std::exchange(sendDrainPending_, true);
+        }
+        if (notify)
+            post(
+                strand_,
+                std::bind(&PeerImp::drainSendInbox, shared_from_this()));
+        return;
+    }
     if (gracefulClose_)
         return;
     if (detaching_)
@@ -254,7 +264,7 @@ PeerImp::send(std::shared_ptr<Message> const& m)
     overlay_.reportTraffic(
         safe_cast<TrafficCount::category>(m->getCategory()),
         false,
-        static_cast<int>(m->getBuffer(compressionEnabled_).size()));
+        static_cast<int>(m->getBuffer(compression_).size()));
 
     auto sendq_size = send_queue_.size();
 
@@ -273,15 +283,47 @@ PeerImp::send(std::shared_ptr<Message> const& m)
              << " sendq: " << sendq_size;
     }
 
-    send_queue_.push(m);
+    send_queue_.push_back(m);
 
     if (sendq_size != 0)
         return;
 
+    writeQueued();
+}
+
+void
+PeerImp::writeQueued()
+{
+    assert(strand_.running_in_this_thread());
+    assert(!send_queue_.empty() && send_buffers_.empty());
+
+    // Gather the queued messages into one write, so that a burst of
+    // messages costs one completion and, since the SSL stream flattens
+    // small buffers before encrypting them, about one system call. The
+    // first message is always written, however large it is.
+    auto const limit = overlay_.setup().maxWriteBytes;
+    std::size_t bytes = 0;
+    for (auto const& m : send_queue_)
+    {
+        auto const& buffer = m->getBuffer(compression_);
+        if (!send_buffers_.empty() && bytes + buffer.size() > limit)
+            break;
+        send_buffers_.push_back(boost::asio::buffer(buffer));
+        bytes += buffer.size();
+        metrics_.sent.add_message(buffer.size());
+    }
+
+    overlay_.reportWrite(send_buffers_.size());
+
+    {
+        // The write's completion drains the inbox
+        std::lock_guard lock(sendMutex_);
+        sendDrainPending_ = true;
+    }
+
     boost::asio::async_write(
         stream_,
-        boost::asio::buffer(
-            send_queue_.front()->getBuffer(compressionEnabled_)),
+        send_buffers_,
         bind_executor(
             strand_,
             std::bind(
@@ -291,6 +333,29 @@ PeerImp::send(std::shared_ptr<Message> const& m)
                 std::placeholders::_2)));
 }
 
+void
+PeerImp::drainSendInbox()
+{
+    assert(strand_.running_in_this_thread());
+
+    std::vector<std::shared_ptr<Message>> inbox;
+    for (;;)
+    {
+        {
+            std::lock_guard lock(sendMutex_);
+            if (sendInbox_.empty())
+            {
+                sendDrainPending_ = !send_buffers_.empty();
+                return;
+            }
+            inbox.swap(sendInbox_);
+        }
+        for (auto const& m : inbox)
+            send(m);
+        inbox.clear();
+    }
+}
+
 void
 PeerImp::sendTxQueue()
 {
@@ -578,6 +643,13 @@ void
 PeerImp::close()
 {
     assert(strand_.running_in_this_thread());
+    {
+        // A failed write leaves sendDrainPending_ set, so nothing would
+        // drain the inbox again.
+        std::lock_guard lock(sendMutex_);
+        sendClosed_ = true;
+        sendInbox_.clear();
+    }
     if (socket_.is_open())
     {
         detaching_ = true;  // DEPRECATED
@@ -962,26 +1034,22 @@ PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
             stream << "onWriteMessage";
     }
 
-    metrics_.sent.add_message(bytes_transferred);
-
-    assert(!send_queue_.empty());
-    send_queue_.pop();
+    assert(send_queue_.size() >= send_buffers_.size());
+    send_queue_.erase(
+        send_queue_.begin(), send_queue_.begin() + send_buffers_.size());
+    send_buffers_.clear();
     if (!send_queue_.empty())
     {
         // Timeout on writes only
-        return boost::asio::async_write(
-            stream_,
-            boost::asio::buffer(
-                send_queue_.front()->getBuffer(compressionEnabled_)),
-            bind_executor(
-                strand_,
-                std::bind(
-                    &PeerImp::onWriteMessage,
-                    shared_from_this(),
-                    std::placeholders::_1,
-                    std::placeholders::_2)));
+        writeQueued();
     }
 
+    // Queue what arrived during the write. If nothing was left to write,
+    // this starts the next write.
+    drainSendInbox();
+    if (!send_queue_.empty())
+        return;
+
     if (gracefulClose_)
     {
         return stream_.async_shutdown(bind_executor(
@@ -1588,12 +1656,26 @@ PeerImp::handleTransaction(
                 << "No new transactions until synchronized";
         }
         else if (
-            app_.getJobQueue().getJobCount(jtTRANSACTION) >
+            app_.getJobQueue().getJobCount(jtTRANSACTION) +
+                overlay_.signatureBatcher().size() >
             app_.config().MAX_TRANSACTIONS)
         {
             overlay_.incJqTransOverflow();
             JLOG(p_journal_.info()) << "Transaction queue is full";
         }
+        else if (checkSignature)
+        {
+            // The signature is checked together with those of other
+            // transactions received around the same time.
+            overlay_.signatureBatcher().add(
+                stx,
+                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                 flags,
+                 stx]() {
+                    if (auto peer = weak.lock())
+                        peer->checkTransaction(flags, true, stx);
+                });
+        }
         else
         {
             app_.getJobQueue().addJob(
@@ -1601,10 +1683,9 @@ PeerImp::handleTransaction(
                 "recvTransaction->checkTransaction",
                 [weak = std::weak_ptr<PeerImp>(shared_from_this()),
                  flags,
-                 checkSignature,
                  stx]() {
                     if (auto peer = weak.lock())
-                        peer->checkTransaction(flags, checkSignature, stx);
+                        peer->checkTransaction(flags, false, stx);
                 });
         }
     }
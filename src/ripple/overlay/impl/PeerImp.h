@@ -41,6 +41,7 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <cstdint>
+#include <deque>
 #include <optional>
 #include <queue>
 
@@ -67,7 +68,7 @@ private:
     using endpoint_type = boost::asio::ip::tcp::endpoint;
     using waitable_timer =
         boost::asio::basic_waitable_timer<std::chrono::steady_clock>;
-    using Compressed = compression::Compressed;
+    using Algorithm = compression::Algorithm;
 
     Application& app_;
     id_t const id_;
@@ -155,7 +156,19 @@ private:
     http_request_type request_;
     http_response_type response_;
     boost::beast::http::fields const& headers_;
-    std::queue<std::shared_ptr<Message>> send_queue_;
+    std::deque<std::shared_ptr<Message>> send_queue_;
+    // The buffers of the messages at the front of send_queue_ that are
+    // being written, if a write is in progress.
+    std::vector<boost::asio::const_buffer> send_buffers_;
+    // Messages sent from outside the strand, waiting to be queued. The
+    // strand is only notified when it would not otherwise look here:
+    // sendDrainPending_ is true while a drain is posted or a write is in
+    // progress, since a completed write drains the inbox. Once the peer is
+    // closed, sendClosed_ is set and messages are no longer accepted.
+    std::mutex sendMutex_;
+    std::vector<std::shared_ptr<Message>> sendInbox_;
+    bool sendDrainPending_ = false;
+    bool sendClosed_ = false;
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     std::unique_ptr<LoadEvent> load_event_;
@@ -167,7 +180,8 @@ private:
     hash_map<PublicKey, NodeStore::ShardInfo> shardInfos_;
     std::mutex mutable shardInfoMutex_;
 
-    Compressed compressionEnabled_ = Compressed::Off;
+    // Compression algorithm negotiated in the handshake
+    Algorithm compression_ = Algorithm::None;
 
     // Queue of transactions' hashes that have not been
     // relayed. The hashes are sent once a second to a peer
@@ -422,7 +436,7 @@ public:
     bool
     compressionEnabled() const override
     {
-        return compressionEnabled_ == Compressed::On;
+        return compression_ != Algorithm::None;
     }
 
     bool
@@ -479,6 +493,14 @@ private:
     void
     onReadMessage(error_code ec, std::size_t bytes_transferred);
 
+    // Starts writing as many queued messages as fit in a single write
+    void
+    writeQueued();
+
+    // Moves the messages sent from outside the strand to send_queue_
+    void
+    drainSendInbox();
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage(error_code ec, std::size_t bytes_transferred);
@@ -685,14 +707,7 @@ PeerImp::PeerImp(
     , slot_(std::move(slot))
     , response_(std::move(response))
     , headers_(response_)
-    , compressionEnabled_(
-          peerFeatureEnabled(
-              headers_,
-              FEATURE_COMPR,
-              "lz4",
-              app_.config().COMPRESSION)
-              ? Compressed::On
-              : Compressed::Off)
+    , compression_(peerCompression(headers_, app_.config().COMPRESSION))
     , txReduceRelayEnabled_(peerFeatureEnabled(
           headers_,
           FEATURE_TXRR,
@@ -709,8 +724,7 @@ PeerImp::PeerImp(
 {
     read_buffer_.commit(boost::asio::buffer_copy(
         read_buffer_.prepare(boost::asio::buffer_size(buffers)), buffers));
-    JLOG(journal_.info()) << "compression enabled "
-                          << (compressionEnabled_ == Compressed::On)
+    JLOG(journal_.info()) << "compression " << compressionName(compression_)
                           << " vp reduce-relay enabled "
                           << vpReduceRelayEnabled_
                           << " tx reduce-relay enabled "
@@ -28,8 +28,10 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <ripple.pb.h>
@@ -141,9 +143,8 @@ struct MessageHeader
     /** The type of the message. */
     std::uint16_t message_type = 0;
 
-    /** Indicates which compression algorithm the payload is compressed with.
-     * Currenly only lz4 is supported. If None then the message is not
-     * compressed.
+    /** Indicates which compression algorithm the payload is compressed with,
+     * lz4 or zstd. If None then the message is not compressed.
      */
     compression::Algorithm algorithm = compression::Algorithm::None;
 };
@@ -210,7 +211,8 @@ parseMessageHeader(
 
         hdr.algorithm = static_cast<compression::Algorithm>(*iter & 0xF0);
 
-        if (hdr.algorithm != compression::Algorithm::LZ4)
+        if (hdr.algorithm != compression::Algorithm::LZ4 &&
+            hdr.algorithm != compression::Algorithm::Zstd)
         {
             ec = make_error_code(boost::system::errc::protocol_error);
             return std::nullopt;
@@ -264,6 +266,94 @@ parseMessageHeader(
     return std::nullopt;
 }
 
+/** Storage for decoding messages, reused by each thread that reads them.
+
+    Decompressing a message into a freshly allocated vector costs an
+    allocation and zeroing the whole payload, only for the payload to be
+    copied again by the parser. A thread keeps its buffer between
+    messages instead, unless a large message grew it past maxRetained.
+*/
+class ScratchBuffer
+{
+    std::unique_ptr<std::uint8_t[]> data_;
+    std::size_t capacity_ = 0;
+
+public:
+    static constexpr std::size_t maxRetained = megabytes(4);
+
+    /** Storage for at least size bytes, with unspecified contents. */
+    std::uint8_t*
+    get(std::size_t size)
+    {
+        if (size > capacity_)
+        {
+            data_.reset(new std::uint8_t[size]);
+            capacity_ = size;
+        }
+        return data_.get();
+    }
+
+    /** Release the storage if a large message left it too big to keep. */
+    void
+    trim()
+    {
+        if (capacity_ > maxRetained)
+        {
+            data_.reset();
+            capacity_ = 0;
+        }
+    }
+};
+
+struct Scratch
+{
+    // The compressed payload, if it spans chunks of the read buffer
+    ScratchBuffer compressed;
+    // The decompressed payload
+    ScratchBuffer payload;
+};
+
+inline Scratch&
+scratch()
+{
+    thread_local Scratch s;
+    return s;
+}
+
+/** Returns the next size bytes of a stream as one contiguous range.
+
+    This points into the stream's own buffer when the bytes lie in a
+    single chunk, which is the usual case, and otherwise gathers them
+    into staging.
+
+    @return The bytes, or nullptr if the stream holds too few.
+*/
+template <class Stream>
+std::uint8_t const*
+contiguous(Stream& stream, std::size_t size, ScratchBuffer& staging)
+{
+    void const* data = nullptr;
+    int chunk = 0;
+    if (!stream.Next(&data, &chunk))
+        return nullptr;
+    if (static_cast<std::size_t>(chunk) >= size)
+        return static_cast<std::uint8_t const*>(data);
+
+    auto const out = staging.get(size);
+    std::size_t copied = 0;
+    for (;;)
+    {
+        auto const n =
+            std::min(static_cast<std::size_t>(chunk), size - copied);
+        std::memcpy(out + copied, data, n);
+        copied += n;
+        if (copied == size)
+            return out;
+        if (!stream.Next(&data, &chunk))
+            return nullptr;
+    }
+}
+
 template <
     class T,
     class Buffers,
@@ -277,24 +367,35 @@ parseMessageContent(MessageHeader const& header, Buffers const& buffers)
     ZeroCopyInputStream<Buffers> stream(buffers);
     stream.Skip(header.header_size);
 
-    if (header.algorithm != compression::Algorithm::None)
+    if (header.algorithm == compression::Algorithm::None)
     {
-        std::vector<std::uint8_t> payload;
-        payload.resize(header.uncompressed_size);
+        // The buffers may hold the messages that follow this one, so
+        // stop parsing at the end of its payload.
+        if (!m->ParseFromBoundedZeroCopyStream(
+                &stream, header.payload_wire_size))
+            return {};
+        return m;
+    }
 
-        auto const payloadSize = ripple::compression::decompress(
-            stream,
+    auto& s = scratch();
+    bool parsed = false;
+    if (auto const compressed =
+            contiguous(stream, header.payload_wire_size, s.compressed))
+    {
+        auto const payload = s.payload.get(header.uncompressed_size);
+        auto const payloadSize = compression::decompress(
+            compressed,
             header.payload_wire_size,
-            payload.data(),
+            payload,
             header.uncompressed_size,
             header.algorithm);
-
-        if (payloadSize == 0 || !m->ParseFromArray(payload.data(), payloadSize))
-            return {};
+        parsed = payloadSize != 0 && m->ParseFromArray(payload, payloadSize);
     }
-    else if (!m->ParseFromZeroCopyStream(&stream))
-        return {};
+    s.compressed.trim();
+    s.payload.trim();
 
+    if (!parsed)
+        return {};
     return m;
 }
 
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/overlay/impl/SignatureBatcher.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace ripple {
+
+SignatureBatcher::SignatureBatcher(Application& app) : app_(app)
+{
+}
+
+void
+SignatureBatcher::add(
+    std::shared_ptr<STTx const> const& stx,
+    std::function<void()> handler)
+{
+    {
+        std::lock_guard lock(mutex_);
+        pending_.push_back({stx, std::move(handler)});
+
+        // A job is already going to pick this transaction up
+        if (jobs_ * maxBatchSize >= pending_.size())
+            return;
+
+        ++jobs_;
+    }
+
+    if (!app_.getJobQueue().addJob(
+            jtTRANSACTION, "batchVerifySignatures", [this]() { verify(); }))
+    {
+        // The job queue is stopping
+        std::lock_guard lock(mutex_);
+        --jobs_;
+    }
+}
+
+std::size_t
+SignatureBatcher::size() const
+{
+    std::lock_guard lock(mutex_);
+    return pending_.size();
+}
+
+void
+SignatureBatcher::verify()
+{
+    std::vector<Item> batch;
+    {
+        std::lock_guard lock(mutex_);
+        --jobs_;
+
+        auto const n = std::min(pending_.size(), maxBatchSize);
+        batch.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            batch.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+        }
+    }
+
+    if (batch.empty())
+        return;
+
+    std::vector<std::shared_ptr<STTx const>> txs;
+    txs.reserve(batch.size());
+    for (auto const& item : batch)
+        txs.push_back(item.stx);
+
+    checkSignatures(
+        app_.getHashRouter(), txs, app_.getLedgerMaster().getValidatedRules());
+
+    // Each transaction is then handled by its own job, as if its signature
+    // had been checked there, so the handlers run in parallel.
+    for (auto& item : batch)
+        app_.getJobQueue().addJob(
+            jtTRANSACTION,
+            "recvTransaction->checkTransaction",
+            std::move(item.handler));
+}
+
+}  // namespace ripple
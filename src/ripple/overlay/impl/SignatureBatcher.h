@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_SIGNATUREBATCHER_H_INCLUDED
+#define RIPPLE_OVERLAY_SIGNATUREBATCHER_H_INCLUDED
+
+#include <ripple/protocol/STTx.h>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+class Application;
+
+/** Checks the signatures of transactions received from peers in batches.
+
+    Transactions that arrive while a verification job is waiting to run
+    join that job's batch, so batches grow with the load on the job queue.
+    A job verifies at most maxBatchSize signatures; once that many are
+    pending another job is scheduled, so that several workers can verify
+    batches at the same time.
+
+    The outcome of each check is cached in the HashRouter, where
+    checkValidity finds it, and the handler passed with the transaction is
+    then called from a job of its own.
+*/
+class SignatureBatcher
+{
+public:
+    /** The largest batch verified by a single job. */
+    static constexpr std::size_t maxBatchSize = 64;
+
+    explicit SignatureBatcher(Application& app);
+
+    SignatureBatcher(SignatureBatcher const&) = delete;
+    SignatureBatcher&
+    operator=(SignatureBatcher const&) = delete;
+
+    /** Queue a transaction for signature verification.
+
+        @param stx The transaction to check.
+        @param handler Called once the transaction's signature state is
+                       cached.
+    */
+    void
+    add(std::shared_ptr<STTx const> const& stx, std::function<void()> handler);
+
+    /** Returns the number of transactions waiting to be checked. */
+    std::size_t
+    size() const;
+
+private:
+    struct Item
+    {
+        std::shared_ptr<STTx const> stx;
+        std::function<void()> handler;
+    };
+
+    void
+    verify();
+
+    Application& app_;
+
+    std::mutex mutable mutex_;
+    std::deque<Item> pending_;
+    // Verification jobs that have been scheduled but not yet started
+    std::size_t jobs_ = 0;
+};
+
+}  // namespace ripple
+
+#endif
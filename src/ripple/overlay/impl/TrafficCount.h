@@ -186,6 +186,30 @@ public:
         }
     }
 
+    /** Account for a write to a peer that sent the given number of messages
+
+        Queued messages are gathered into as few writes as possible, so
+        the ratio of writes to messages shows how well that works.
+     */
+    void
+    addWrite(std::size_t messages)
+    {
+        ++writes_;
+        writtenMessages_ += messages;
+    }
+
+    std::uint64_t
+    writes() const
+    {
+        return writes_.load();
+    }
+
+    std::uint64_t
+    writtenMessages() const
+    {
+        return writtenMessages_.load();
+    }
+
     TrafficCount() = default;
 
     /** An up-to-date copy of all the counters
@@ -250,6 +274,9 @@ protected:
         {"requested_transactions"},  // category::transactions
         {"unknown"}                  // category::unknown
     }};
+
+    std::atomic<std::uint64_t> writes_{0};
+    std::atomic<std::uint64_t> writtenMessages_{0};
 };
 
 }  // namespace ripple
@@ -19,6 +19,7 @@
 
 #include <ripple/perflog/impl/PerfLogImp.h>
 
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/beast/utility/Journal.h>
@@ -26,7 +27,9 @@
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 #include <ripple/nodestore/DatabaseShard.h>
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -42,6 +45,105 @@
 namespace ripple {
 namespace perf {
 
+char const*
+ledgerPhaseName(LedgerPhase phase)
+{
+    switch (phase)
+    {
+        case LedgerPhase::establish:
+            return "consensus_establish";
+        case LedgerPhase::build:
+            return "build_ledger";
+        case LedgerPhase::flush:
+            return "flush_dirty";
+        case LedgerPhase::save:
+            return "save_validated_ledger";
+        case LedgerPhase::publish:
+            return "pub_ledger";
+        case LedgerPhase::orderBook:
+            return "order_book_update";
+        case LedgerPhase::rotate:
+            return "shamap_store_rotate";
+    }
+    assert(false);
+    return "unknown";
+}
+
+std::size_t
+PerfLogImp::Counters::Phase::bucket(std::uint64_t us)
+{
+    if (us < subBuckets)
+        return us;
+
+    std::size_t const shift = std::bit_width(us) - std::bit_width(subBuckets);
+    return std::min(
+        (shift + 1) * subBuckets + (us >> shift) - subBuckets, buckets - 1);
+}
+
+std::uint64_t
+PerfLogImp::Counters::Phase::lowest(std::size_t bucket)
+{
+    if (bucket < subBuckets)
+        return bucket;
+
+    std::size_t const shift = bucket / subBuckets - 1;
+    return (subBuckets + bucket % subBuckets) << shift;
+}
+
+void
+PerfLogImp::Counters::Phase::record(microseconds dur)
+{
+    std::uint64_t const us = std::max<microseconds::rep>(dur.count(), 0);
+
+    counts[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(us, std::memory_order_relaxed);
+
+    auto prev = max.load(std::memory_order_relaxed);
+    while (prev < us &&
+           !max.compare_exchange_weak(prev, us, std::memory_order_relaxed))
+    {
+    }
+}
+
+Json::Value
+PerfLogImp::Counters::Phase::json() const
+{
+    // The buckets are read one at a time while other threads may be
+    // recording, so the snapshot is only approximately consistent.
+    std::array<std::uint64_t, buckets> snapshot;
+    std::uint64_t n = 0;
+    for (std::size_t i = 0; i < buckets; ++i)
+    {
+        snapshot[i] = counts[i].load(std::memory_order_relaxed);
+        n += snapshot[i];
+    }
+    auto const largest = max.load(std::memory_order_relaxed);
+
+    // Estimate a percentile by the upper bound of the bucket holding it.
+    auto const percentile = [&](std::uint64_t pct) -> std::uint64_t {
+        auto const rank = std::max<std::uint64_t>((n * pct + 99) / 100, 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets - 1; ++i)
+        {
+            seen += snapshot[i];
+            if (seen >= rank)
+                return std::min(lowest(i + 1) - 1, largest);
+        }
+        return largest;
+    };
+
+    Json::Value p(Json::objectValue);
+    p[jss::count] = std::to_string(n);
+    p[jss::duration_us] =
+        std::to_string(total.load(std::memory_order_relaxed));
+    p[jss::max_us] = std::to_string(largest);
+    p[jss::p50_us] = std::to_string(n ? percentile(50) : 0);
+    p[jss::p90_us] = std::to_string(n ? percentile(90) : 0);
+    p[jss::p99_us] = std::to_string(n ? percentile(99) : 0);
+    return p;
+}
+
 PerfLogImp::Counters::Counters(
     std::vector<char const*> const& labels,
     JobTypes const& jobTypes)
@@ -166,9 +268,22 @@ PerfLogImp::Counters::countersJson() const
     // even if empty.
     counters[jss::rpc] = rpcobj;
     counters[jss::job_queue] = jqobj;
+    counters[jss::ledger_phases] = ledgerPhasesJson();
     return counters;
 }
 
+Json::Value
+PerfLogImp::Counters::ledgerPhasesJson() const
+{
+    Json::Value phases(Json::objectValue);
+    for (std::size_t i = 0; i < ledgerPhaseCount; ++i)
+    {
+        auto const phase = static_cast<LedgerPhase>(i);
+        phases[ledgerPhaseName(phase)] = phases_[i].json();
+    }
+    return phases;
+}
+
 Json::Value
 PerfLogImp::Counters::currentJson() const
 {
@@ -433,6 +548,14 @@ PerfLogImp::jobFinish(JobType const type, microseconds dur, int instance)
         counters_.jobs_[instance] = {jtINVALID, steady_time_point()};
 }
 
+void
+PerfLogImp::ledgerPhase(LedgerPhase const phase, microseconds dur)
+{
+    auto const i = static_cast<std::size_t>(phase);
+    counters_.phases_[i].record(dur);
+    phaseEvents_[i].notify(dur);
+}
+
 void
 PerfLogImp::resizeJobs(int const resize)
 {
@@ -455,6 +578,13 @@ PerfLogImp::rotate()
 void
 PerfLogImp::start()
 {
+    auto const& group = app_.getCollectorManager().group("ledger_phase");
+    for (std::size_t i = 0; i < ledgerPhaseCount; ++i)
+    {
+        auto const phase = static_cast<LedgerPhase>(i);
+        phaseEvents_[i] = group->make_event(ledgerPhaseName(phase));
+    }
+
     if (setup_.perfLog.size())
         thread_ = std::thread(&PerfLogImp::run, this);
 }
@@ -22,10 +22,13 @@
 
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/chrono.h>
+#include <ripple/beast/insight/Event.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/impl/Handler.h>
 #include <boost/asio/ip/host_name.hpp>
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <fstream>
@@ -104,6 +107,41 @@ class PerfLogImp : public PerfLog
             microseconds runningDuration{0};
         };
 
+        /**
+         * Ledger phase latency histogram.
+         *
+         * Durations are counted in log-linear buckets: each power of two
+         * microseconds is split into subBuckets equal buckets, so that a
+         * bucket's bounds are within 1/subBuckets of any duration in it.
+         * Recording is lock-free so phases may be timed on any thread.
+         */
+        struct Phase
+        {
+            static constexpr std::size_t subBuckets = 4;
+            // Durations of about 2^40 microseconds (12 days) or more are
+            // counted in the last bucket.
+            static constexpr std::size_t buckets = 41 * subBuckets;
+
+            std::array<std::atomic<std::uint64_t>, buckets> counts{};
+            std::atomic<std::uint64_t> count{0};
+            // Cumulative and maximum durations in microseconds.
+            std::atomic<std::uint64_t> total{0};
+            std::atomic<std::uint64_t> max{0};
+
+            static std::size_t
+            bucket(std::uint64_t us);
+
+            // Smallest duration counted in a bucket.
+            static std::uint64_t
+            lowest(std::size_t bucket);
+
+            void
+            record(microseconds dur);
+
+            Json::Value
+            json() const;
+        };
+
         // rpc_ and jq_ do not need mutex protection because all
         // keys and values are created before more threads are started.
         std::unordered_map<std::string, Locked<Rpc>> rpc_;
@@ -112,6 +150,7 @@ class PerfLogImp : public PerfLog
         mutable std::mutex jobsMutex_;
         std::unordered_map<std::uint64_t, MethodStart> methods_;
         mutable std::mutex methodsMutex_;
+        std::array<Phase, ledgerPhaseCount> phases_;
 
         Counters(
             std::vector<char const*> const& labels,
@@ -120,6 +159,8 @@ class PerfLogImp : public PerfLog
         countersJson() const;
         Json::Value
         currentJson() const;
+        Json::Value
+        ledgerPhasesJson() const;
     };
 
     Setup const setup_;
@@ -127,6 +168,8 @@ class PerfLogImp : public PerfLog
     beast::Journal const j_;
     std::function<void()> const signalStop_;
     Counters counters_{ripple::RPC::getHandlerNames(), JobTypes::instance()};
+    // Created by start(), once the application's collector exists.
+    std::array<beast::insight::Event, ledgerPhaseCount> phaseEvents_;
     std::ofstream logFile_;
     std::thread thread_;
     std::mutex mutex_;
@@ -182,6 +225,8 @@ public:
         int instance) override;
     void
     jobFinish(JobType const type, microseconds dur, int instance) override;
+    void
+    ledgerPhase(LedgerPhase const phase, microseconds dur) override;
 
     Json::Value
     countersJson() const override
@@ -189,6 +234,12 @@ public:
         return counters_.countersJson();
     }
 
+    Json::Value
+    ledgerPhasesJson() const override
+    {
+        return counters_.ledgerPhasesJson();
+    }
+
     Json::Value
     currentJson() const override
     {
@@ -31,6 +31,7 @@
 #include <optional>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -257,6 +258,27 @@ verify(
     Slice const& sig,
     bool mustBeFullyCanonical = true) noexcept;
 
+/** A signature on a message, as passed to verifyBatch. */
+struct SignedMessage
+{
+    PublicKey publicKey;
+    Slice message;
+    Slice signature;
+    bool mustBeFullyCanonical = true;
+};
+
+/** Verify several signatures on messages.
+
+    The result is the same as calling verify on each entry, but Ed25519
+    signatures are checked together using batch verification, which costs
+    considerably less per signature. If a batch fails, its signatures are
+    checked one at a time to determine which of them are invalid.
+
+    @return One element per entry, `true` if that signature is valid.
+*/
+[[nodiscard]] std::vector<bool>
+verifyBatch(std::vector<SignedMessage> const& messages);
+
 /** Calculate the 160-bit node ID from a node public key. */
 NodeID
 calcNodeID(PublicKey const&);
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/contract.h>
 #include <ripple/protocol/SField.h>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <memory>
@@ -128,9 +129,18 @@ public:
         return elements_.size();
     }
 
-    /** Retrieve the position of a named field. */
+    /** Retrieve the position of a named field, or -1 if it is absent. */
     int
-    getIndex(SField const&) const;
+    getIndex(SField const& sField) const
+    {
+        // The mapping table should be large enough for any possible field
+        //
+        if (sField.getNum() <= 0 || sField.getNum() >= indices_.size())
+            Throw<std::runtime_error>("Invalid field index for getIndex().");
+
+        auto const index = indices_[sField.getNum()];
+        return index == unmapped ? -1 : index;
+    }
 
     SOEStyle
     style(SField const& sf) const
@@ -139,8 +149,13 @@ public:
     }
 
 private:
+    // Marks a field that is not in the template.
+    static constexpr std::uint8_t unmapped = 0xFF;
+
     std::vector<SOElement> elements_;
-    std::vector<int> indices_;  // field num -> index
+    // field num -> index. Every field lookup on a templated object reads
+    // this table, so it is kept to one byte per field.
+    std::vector<std::uint8_t> indices_;
 };
 
 }  // namespace ripple
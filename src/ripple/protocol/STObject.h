@@ -31,6 +31,7 @@
 #include <ripple/protocol/STPathSet.h>
 #include <ripple/protocol/STVector256.h>
 #include <ripple/protocol/impl/STVar.h>
+#include <boost/container/pmr/polymorphic_allocator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <cassert>
 #include <optional>
@@ -69,7 +70,11 @@ class STObject : public STBase, public CountedObject<STObject>
         operator()(detail::STVar const& e) const;
     };
 
-    using list_type = std::vector<detail::STVar>;
+    // Use boost::pmr functionality instead of the std::pmr
+    // functions b/c clang does not support pmr yet (as-of 9/2020)
+    using list_type = std::vector<
+        detail::STVar,
+        boost::container::pmr::polymorphic_allocator<detail::STVar>>;
 
     list_type v_;
     SOTemplate const* mType;
@@ -100,6 +105,18 @@ public:
     STObject(SerialIter&& sit, SField const& name);
     explicit STObject(SField const& name);
 
+    /** Create an empty object whose fields are allocated from `resource`.
+
+        This lets short-lived objects, like the ones built while computing
+        transaction metadata, share an arena instead of the global heap.
+        A copy of the object allocates from the default resource, but a
+        moved-from object's storage moves with it, so `resource` must
+        outlive the object and anything it is moved into.
+    */
+    STObject(
+        SField const& name,
+        boost::container::pmr::memory_resource* resource);
+
     iterator
     begin() const;
 
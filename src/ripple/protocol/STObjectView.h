@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_STOBJECTVIEW_H_INCLUDED
+#define RIPPLE_PROTOCOL_STOBJECTVIEW_H_INCLUDED
+
+#include <ripple/basics/Slice.h>
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STVector256.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/UintTypes.h>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace ripple {
+
+class STObject;
+
+/** A read-only view of a serialized object.
+
+    The field headers are parsed once, when the view is created, and each
+    field is decoded only when it is read. Variable length fields are
+    returned as slices of the serialized data, so reading them copies
+    nothing. This suits callers that read a few fields of an entry, which
+    would otherwise deserialize every field into its own STBase.
+
+    A view has no template. A field that is absent reads as its default
+    value, like an optional field of a templated object.
+*/
+class STObjectView
+{
+    struct Field
+    {
+        SField const* field;
+        // Position and size of the field's value within data_
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    std::shared_ptr<void const> owner_;
+    Slice data_;
+    std::vector<Field> fields_;
+
+public:
+    /** Create a view of serialized fields.
+
+        @param data The fields of an object, as serialized by
+                    STObject::add, without an end-of-object marker.
+        @param owner Keeps the memory referenced by `data` alive for the
+                     lifetime of the view.
+        @throws std::runtime_error if the data is malformed.
+    */
+    STObjectView(Slice data, std::shared_ptr<void const> owner);
+
+    /** Create a view of a copy of the fields of an object. */
+    explicit STObjectView(STObject const& object);
+
+    /** The serialized fields. */
+    Slice
+    slice() const
+    {
+        return data_;
+    }
+
+    /** The number of fields present. */
+    std::size_t
+    size() const
+    {
+        return fields_.size();
+    }
+
+    bool
+    isFieldPresent(SField const& field) const;
+
+    std::uint8_t
+    getFieldU8(SField const& field) const;
+    std::uint16_t
+    getFieldU16(SField const& field) const;
+    std::uint32_t
+    getFieldU32(SField const& field) const;
+    std::uint64_t
+    getFieldU64(SField const& field) const;
+    uint128
+    getFieldH128(SField const& field) const;
+    uint160
+    getFieldH160(SField const& field) const;
+    uint256
+    getFieldH256(SField const& field) const;
+    AccountID
+    getAccountID(SField const& field) const;
+    STAmount
+    getFieldAmount(SField const& field) const;
+    STVector256
+    getFieldV256(SField const& field) const;
+
+    /** The value of a variable length field, without copying it. */
+    Slice
+    getFieldVL(SField const& field) const;
+
+private:
+    explicit STObjectView(std::shared_ptr<Serializer const> serialized);
+
+    Field const*
+    find(SField const& field) const;
+
+    // An iterator over the value of a field of the given type, or
+    // nullopt if the field is absent.
+    std::optional<SerialIter>
+    peek(SField const& field, SerializedTypeID type) const;
+};
+
+}  // namespace ripple
+
+#endif
@@ -122,6 +122,19 @@ public:
     checkSign(RequireFullyCanonicalSig requireCanonicalSig, Rules const& rules)
         const;
 
+    /** Check the signatures of several transactions.
+
+        Single-signed transactions are verified together using verifyBatch,
+        multi-signed transactions one at a time.
+
+        @return One result per transaction, as checkSign would return it.
+    */
+    static std::vector<Expected<void, std::string>>
+    checkSignBatch(
+        std::vector<std::shared_ptr<STTx const>> const& txs,
+        RequireFullyCanonicalSig requireCanonicalSig,
+        Rules const& rules);
+
     // SQL Functions with metadata.
     static std::string const&
     getMetaSQLInsertReplaceHeader();
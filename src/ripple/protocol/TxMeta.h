@@ -25,6 +25,8 @@
 #include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/protocol/TER.h>
 #include <boost/container/flat_set.hpp>
+#include <boost/container/pmr/global_resource.hpp>
+#include <boost/container/pmr/memory_resource.hpp>
 #include <optional>
 
 namespace ripple {
@@ -45,6 +47,13 @@ private:
 
 public:
     TxMeta(uint256 const& transactionID, std::uint32_t ledger);
+    /** Create empty metadata whose affected nodes are allocated from
+        `resource`, which must outlive this object.
+    */
+    TxMeta(
+        uint256 const& transactionID,
+        std::uint32_t ledger,
+        boost::container::pmr::memory_resource* resource);
     TxMeta(uint256 const& txID, std::uint32_t ledger, Blob const&);
     TxMeta(uint256 const& txID, std::uint32_t ledger, std::string const&);
     TxMeta(uint256 const& txID, std::uint32_t ledger, STObject const&);
@@ -135,6 +144,10 @@ private:
     std::optional<STAmount> mDelivered;
 
     STArray mNodes;
+
+    // Where the fields of newly affected nodes are allocated
+    boost::container::pmr::memory_resource* resource_ =
+        boost::container::pmr::get_default_resource();
 };
 
 }  // namespace ripple
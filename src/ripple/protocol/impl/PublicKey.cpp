@@ -24,7 +24,10 @@
 #include <ripple/protocol/impl/secp256k1.h>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <ed25519.h>
+#include <algorithm>
+#include <mutex>
 #include <type_traits>
+#include <vector>
 
 namespace ripple {
 
@@ -172,6 +175,24 @@ ed25519Canonical(Slice const& sig)
     return std::lexicographical_compare(S, S + 32, Order, Order + 32);
 }
 
+/** Determine whether an Ed25519 point is canonically encoded.
+
+    The encoding holds the y coordinate, which must be less than
+    p = 2^255 - 19, and the sign of x in the top bit.
+*/
+static bool
+ed25519CanonicalPoint(std::uint8_t const* point)
+{
+    if ((point[31] & 0x7F) != 0x7F)
+        return true;
+    for (int i = 30; i > 0; --i)
+    {
+        if (point[i] != 0xFF)
+            return true;
+    }
+    return point[0] < 0xED;
+}
+
 //------------------------------------------------------------------------------
 
 PublicKey::PublicKey(Slice const& slice)
@@ -299,6 +320,75 @@ verify(
     return false;
 }
 
+std::vector<bool>
+verifyBatch(std::vector<SignedMessage> const& messages)
+{
+    std::vector<bool> result(messages.size(), false);
+
+    // Ed25519 signatures are collected and checked together
+    std::vector<std::size_t> index;
+    std::vector<unsigned char const*> m;
+    std::vector<std::size_t> mlen;
+    std::vector<unsigned char const*> pk;
+    std::vector<unsigned char const*> rs;
+
+    for (std::size_t i = 0; i < messages.size(); ++i)
+    {
+        auto const& sm = messages[i];
+        auto const type = publicKeyType(sm.publicKey);
+
+        // Batch verification decodes R and checks a random combination
+        // of the equations, while verify compares the encoding of R and
+        // checks each equation exactly. A component of small order in R
+        // or A only cancels out of the combination some of the time, so
+        // the two disagree on non-canonical encodings and on points that
+        // are not in the prime order subgroup. Those signatures are
+        // checked one at a time.
+        if (type != KeyType::ed25519 || !ed25519Canonical(sm.signature) ||
+            !ed25519CanonicalPoint(sm.publicKey.data() + 1) ||
+            !ed25519CanonicalPoint(sm.signature.data()) ||
+            !ed25519_point_has_prime_order(sm.publicKey.data() + 1) ||
+            !ed25519_point_has_prime_order(sm.signature.data()))
+        {
+            result[i] = verify(
+                sm.publicKey,
+                sm.message,
+                sm.signature,
+                sm.mustBeFullyCanonical);
+            continue;
+        }
+
+        index.push_back(i);
+        m.push_back(sm.message.data());
+        mlen.push_back(sm.message.size());
+        // Strip the 0xED prefix, as in verify
+        pk.push_back(sm.publicKey.data() + 1);
+        rs.push_back(sm.signature.data());
+    }
+
+    if (!index.empty())
+    {
+        // ed25519_sign_open_batch writes each combined point to a global
+        // buffer, so concurrent batches must not overlap.
+        static std::mutex batchMutex;
+
+        std::vector<int> valid(index.size(), 0);
+        std::lock_guard lock(batchMutex);
+        ed25519_sign_open_batch(
+            m.data(),
+            mlen.data(),
+            pk.data(),
+            rs.data(),
+            index.size(),
+            valid.data());
+
+        for (std::size_t i = 0; i < index.size(); ++i)
+            result[index[i]] = valid[i] == 1;
+    }
+
+    return result;
+}
+
 NodeID
 calcNodeID(PublicKey const& pk)
 {
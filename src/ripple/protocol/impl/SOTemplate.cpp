@@ -24,13 +24,18 @@ namespace ripple {
 SOTemplate::SOTemplate(
     std::initializer_list<SOElement> uniqueFields,
     std::initializer_list<SOElement> commonFields)
-    : indices_(SField::getNumFields() + 1, -1)  // Unmapped indices == -1
+    : indices_(SField::getNumFields() + 1, unmapped)
 {
     // Add all SOElements.
     elements_.reserve(uniqueFields.size() + commonFields.size());
     elements_.assign(uniqueFields);
     elements_.insert(elements_.end(), commonFields);
 
+    // Make sure every position fits in the mapping table
+    //
+    if (elements_.size() >= unmapped)
+        Throw<std::runtime_error>("Too many fields for SOTemplate.");
+
     // Validate and index elements_.
     for (std::size_t i = 0; i < elements_.size(); ++i)
     {
@@ -52,15 +57,4 @@ SOTemplate::SOTemplate(
     }
 }
 
-int
-SOTemplate::getIndex(SField const& sField) const
-{
-    // The mapping table should be large enough for any possible field
-    //
-    if (sField.getNum() <= 0 || sField.getNum() >= indices_.size())
-        Throw<std::runtime_error>("Invalid field index for getIndex().");
-
-    return indices_[sField.getNum()];
-}
-
 }  // namespace ripple
@@ -35,6 +35,13 @@ STObject::STObject(SField const& name) : STBase(name), mType(nullptr)
 {
 }
 
+STObject::STObject(
+    SField const& name,
+    boost::container::pmr::memory_resource* resource)
+    : STBase(name), v_(resource), mType(nullptr)
+{
+}
+
 STObject::STObject(SOTemplate const& type, SField const& name) : STBase(name)
 {
     set(type);
@@ -124,7 +131,7 @@ STObject::applyTemplate(const SOTemplate& type)
     };
 
     mType = &type;
-    decltype(v_) v;
+    decltype(v_) v(v_.get_allocator());
     v.reserve(type.size());
     for (auto const& e : type)
     {
@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/contract.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STObjectView.h>
+#include <ripple/protocol/impl/STVar.h>
+
+namespace ripple {
+
+// Advance past the value of a field
+static void
+skipValue(SerialIter& sit, SField const& field)
+{
+    switch (field.fieldType)
+    {
+        case STI_UINT8:
+            sit.skip(1);
+            break;
+        case STI_UINT16:
+            sit.skip(2);
+            break;
+        case STI_UINT32:
+            sit.skip(4);
+            break;
+        case STI_UINT64:
+            sit.skip(8);
+            break;
+        case STI_UINT96:
+            sit.skip(12);
+            break;
+        case STI_UINT128:
+            sit.skip(16);
+            break;
+        case STI_UINT160:
+            sit.skip(20);
+            break;
+        case STI_UINT192:
+            sit.skip(24);
+            break;
+        case STI_UINT256:
+            sit.skip(32);
+            break;
+        case STI_UINT384:
+            sit.skip(48);
+            break;
+        case STI_UINT512:
+            sit.skip(64);
+            break;
+        case STI_AMOUNT: {
+            // An issued amount follows its value with a currency and an
+            // issuer, and is marked by the top bit of its value.
+            SerialIter value = sit;
+            sit.skip((value.get8() & 0x80) ? 48 : 8);
+            break;
+        }
+        case STI_VL:
+        case STI_ACCOUNT:
+        case STI_VECTOR256:
+            sit.skip(sit.getVLDataLength());
+            break;
+        default: {
+            // Objects, arrays and path sets carry no length, so the only
+            // way to find their end is to deserialize them.
+            detail::STVar const skipped(sit, field, 1);
+            break;
+        }
+    }
+}
+
+STObjectView::STObjectView(Slice data, std::shared_ptr<void const> owner)
+    : owner_(std::move(owner)), data_(data)
+{
+    fields_.reserve(16);
+
+    SerialIter sit(data_);
+    while (!sit.empty())
+    {
+        int type;
+        int name;
+        sit.getFieldID(type, name);
+
+        if ((type == STI_OBJECT || type == STI_ARRAY) && name == 1)
+            Throw<std::runtime_error>("Illegal end marker in object");
+
+        auto const& field = SField::getField(type, name);
+        if (field.isInvalid())
+            Throw<std::runtime_error>("Unknown field");
+
+        auto const offset = data_.size() - sit.getBytesLeft();
+        skipValue(sit, field);
+        auto const end = data_.size() - sit.getBytesLeft();
+
+        fields_.push_back(
+            {&field,
+             static_cast<std::uint32_t>(offset),
+             static_cast<std::uint32_t>(end - offset)});
+    }
+}
+
+STObjectView::STObjectView(std::shared_ptr<Serializer const> serialized)
+    : STObjectView(serialized->slice(), serialized)
+{
+}
+
+STObjectView::STObjectView(STObject const& object)
+    : STObjectView([&object]() {
+        auto s = std::make_shared<Serializer>();
+        object.add(*s);
+        return std::shared_ptr<Serializer const>(std::move(s));
+    }())
+{
+}
+
+auto
+STObjectView::find(SField const& field) const -> Field const*
+{
+    for (auto const& f : fields_)
+    {
+        if (*f.field == field)
+            return &f;
+    }
+    return nullptr;
+}
+
+std::optional<SerialIter>
+STObjectView::peek(SField const& field, SerializedTypeID type) const
+{
+    if (field.fieldType != type)
+        Throw<std::runtime_error>("Wrong field type");
+
+    auto const f = find(field);
+    if (!f)
+        return std::nullopt;
+    return SerialIter(data_.data() + f->offset, f->size);
+}
+
+bool
+STObjectView::isFieldPresent(SField const& field) const
+{
+    return find(field) != nullptr;
+}
+
+std::uint8_t
+STObjectView::getFieldU8(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT8))
+        return sit->get8();
+    return 0;
+}
+
+std::uint16_t
+STObjectView::getFieldU16(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT16))
+        return sit->get16();
+    return 0;
+}
+
+std::uint32_t
+STObjectView::getFieldU32(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT32))
+        return sit->get32();
+    return 0;
+}
+
+std::uint64_t
+STObjectView::getFieldU64(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT64))
+        return sit->get64();
+    return 0;
+}
+
+uint128
+STObjectView::getFieldH128(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT128))
+        return sit->get128();
+    return {};
+}
+
+uint160
+STObjectView::getFieldH160(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT160))
+        return sit->get160();
+    return {};
+}
+
+uint256
+STObjectView::getFieldH256(SField const& field) const
+{
+    if (auto sit = peek(field, STI_UINT256))
+        return sit->get256();
+    return {};
+}
+
+AccountID
+STObjectView::getAccountID(SField const& field) const
+{
+    if (auto sit = peek(field, STI_ACCOUNT))
+        return STAccount(*sit, field).value();
+    return {};
+}
+
+STAmount
+STObjectView::getFieldAmount(SField const& field) const
+{
+    if (auto sit = peek(field, STI_AMOUNT))
+        return STAmount(*sit, field);
+    return STAmount();
+}
+
+STVector256
+STObjectView::getFieldV256(SField const& field) const
+{
+    if (auto sit = peek(field, STI_VECTOR256))
+        return STVector256(*sit, field);
+    return STVector256(field);
+}
+
+Slice
+STObjectView::getFieldVL(SField const& field) const
+{
+    if (auto sit = peek(field, STI_VL))
+        return sit->getSlice(sit->getVLDataLength());
+    return {};
+}
+
+}  // namespace ripple
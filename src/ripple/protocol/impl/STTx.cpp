@@ -226,6 +226,89 @@ STTx::checkSign(
     return Unexpected("Internal signature check failure.");
 }
 
+std::vector<Expected<void, std::string>>
+STTx::checkSignBatch(
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    RequireFullyCanonicalSig requireCanonicalSig,
+    Rules const& rules)
+{
+    std::vector<Expected<void, std::string>> result;
+    result.reserve(txs.size());
+
+    // Signing data and signatures of the single-signed transactions,
+    // kept alive for the slices passed to verifyBatch
+    std::vector<std::size_t> index;
+    std::vector<PublicKey> keys;
+    std::vector<Blob> data;
+    std::vector<Blob> signatures;
+    std::vector<bool> canonical;
+
+    for (auto const& tx : txs)
+    {
+        result.emplace_back();
+
+        try
+        {
+            Blob const& spk = tx->getFieldVL(sfSigningPubKey);
+
+            if (spk.empty())
+            {
+                result.back() = tx->checkSign(requireCanonicalSig, rules);
+                continue;
+            }
+
+            // As in checkSingleSign
+            if (tx->isFieldPresent(sfSigners))
+            {
+                result.back() =
+                    Unexpected("Cannot both single- and multi-sign.");
+                continue;
+            }
+
+            if (!publicKeyType(makeSlice(spk)))
+            {
+                result.back() = Unexpected("Invalid signature.");
+                continue;
+            }
+
+            PublicKey key(makeSlice(spk));
+            Blob signature = tx->getFieldVL(sfTxnSignature);
+            Blob signingData = getSigningData(*tx);
+
+            keys.push_back(std::move(key));
+            signatures.push_back(std::move(signature));
+            data.push_back(std::move(signingData));
+            canonical.push_back(
+                (tx->getFlags() & tfFullyCanonicalSig) ||
+                (requireCanonicalSig == RequireFullyCanonicalSig::yes));
+            index.push_back(result.size() - 1);
+        }
+        catch (std::exception const&)
+        {
+            // Assume it was a signature failure.
+            result.back() = Unexpected("Invalid signature.");
+        }
+    }
+
+    std::vector<SignedMessage> messages;
+    messages.reserve(index.size());
+    for (std::size_t i = 0; i < index.size(); ++i)
+        messages.push_back(
+            {keys[i],
+             makeSlice(data[i]),
+             makeSlice(signatures[i]),
+             canonical[i]});
+
+    auto const valid = verifyBatch(messages);
+    for (std::size_t i = 0; i < index.size(); ++i)
+    {
+        if (!valid[i])
+            result[index[i]] = Unexpected("Invalid signature.");
+    }
+
+    return result;
+}
+
 Json::Value STTx::getJson(JsonOptions) const
 {
     Json::Value ret = STObject::getJson(JsonOptions::none);
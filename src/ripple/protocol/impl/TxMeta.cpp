@@ -86,6 +86,15 @@ TxMeta::TxMeta(uint256 const& transactionID, std::uint32_t ledger)
     mNodes.reserve(32);
 }
 
+TxMeta::TxMeta(
+    uint256 const& transactionID,
+    std::uint32_t ledger,
+    boost::container::pmr::memory_resource* resource)
+    : TxMeta(transactionID, ledger)
+{
+    resource_ = resource;
+}
+
 void
 TxMeta::setAffectedNode(
     uint256 const& node,
@@ -103,7 +112,7 @@ TxMeta::setAffectedNode(
         }
     }
 
-    mNodes.push_back(STObject(type));
+    mNodes.push_back(STObject(type, resource_));
     STObject& obj = mNodes.back();
 
     assert(obj.getFName() == type);
@@ -172,7 +181,7 @@ TxMeta::getAffectedNode(SLE::ref node, SField const& type)
         if (n.getFieldH256(sfLedgerIndex) == index)
             return n;
     }
-    mNodes.push_back(STObject(type));
+    mNodes.push_back(STObject(type, resource_));
     STObject& obj = mNodes.back();
 
     assert(obj.getFName() == type);
@@ -349,6 +349,8 @@ JSS(ledger_index_max);            // in, out: AccountTx*
 JSS(ledger_index_min);            // in, out: AccountTx*
 JSS(ledger_max);                  // in, out: AccountTx*
 JSS(ledger_min);                  // in, out: AccountTx*
+JSS(ledger_phases);               // out: GetCounts, counters
+JSS(ledger_save_lag);             // out: GetCounts
 JSS(ledger_time);                 // out: NetworkOPs
 JSS(levels);                      // LogLevels
 JSS(limit);                       // in/out: AccountTx*, AccountOffers,
@@ -388,6 +390,7 @@ JSS(master_seed_hex);             // out: WalletPropose
 JSS(master_signature);            // out: pubManifest
 JSS(max_ledger);                  // in/out: LedgerCleaner
 JSS(max_queue_size);              // out: TxQ
+JSS(max_us);                      // out: counters
 JSS(max_spend_drops);             // out: AccountInfo
 JSS(max_spend_drops_total);       // out: AccountInfo
 JSS(median_fee);                  // out: TxQ
@@ -447,6 +450,9 @@ JSS(open_ledger_fee);            // out: TxQ
 JSS(open_ledger_level);          // out: TxQ
 JSS(owner);                      // in: LedgerEntry, out: NetworkOPs
 JSS(owner_funds);                // in/out: Ledger, NetworkOPs, AcceptedLedgerTx
+JSS(p50_us);                      // out: counters
+JSS(p90_us);                      // out: counters
+JSS(p99_us);                      // out: counters
 JSS(page_index);
 JSS(params);                      // RPC
 JSS(parent_close_time);           // out: LedgerToJson
@@ -23,6 +23,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/rdb/backend/SQLiteDatabase.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/json/json_value.h>
 #include <ripple/ledger/CachedSLEs.h>
@@ -101,6 +102,8 @@ getCountsJson(Application& app, int minObjectCount)
             if (c > 0)
                 ret[jss::local_txs] = static_cast<Json::UInt>(c);
         }
+
+        ret[jss::ledger_save_lag] = app.getLedgerMaster().getSaveLag();
     }
 
     ret[jss::write_load] = app.getNodeStore().getWriteLoad();
@@ -119,6 +122,8 @@ getCountsJson(Application& app, int minObjectCount)
     ret[jss::treenode_track_size] =
         app.getNodeFamily().getTreeNodeCache(0)->getTrackSize();
 
+    ret[jss::ledger_phases] = app.getPerfLog().ledgerPhasesJson();
+
     std::string uptime;
     auto s = UptimeClock::now();
     using namespace std::chrono_literals;
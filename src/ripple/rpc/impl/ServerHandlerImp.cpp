@@ -26,6 +26,7 @@
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/beast/rfc2616.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/json/ValueStream.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/to_string.h>
 #include <ripple/net/RPCErr.h>
@@ -48,6 +49,7 @@
 #include <boost/beast/http/string_body.hpp>
 #include <boost/type_traits.hpp>
 #include <algorithm>
+#include <limits>
 #include <mutex>
 #include <stdexcept>
 
@@ -344,12 +346,17 @@ ServerHandlerImp::onWSMessage(
         "WS-Client",
         [this, session, jv = std::move(jv)](
             std::shared_ptr<JobQueue::Coro> const& coro) {
-            auto const jr = this->processSession(session, coro, jv);
-            auto const s = to_string(jr);
-            auto const n = s.length();
-            boost::beast::multi_buffer sb(n);
-            sb.commit(boost::asio::buffer_copy(
-                sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
+            // The reply is serialized here, rather than by the thread
+            // that sends it, releasing the value as it is written.
+            boost::beast::multi_buffer sb;
+            Json::ValueStream(this->processSession(session, coro, jv))
+                .write(
+                    [&sb](boost::beast::string_view const& s) {
+                        sb.commit(boost::asio::buffer_copy(
+                            sb.prepare(s.size()),
+                            boost::asio::buffer(s.data(), s.size())));
+                    },
+                    std::numeric_limits<std::size_t>::max());
             session->send(
                 std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb)));
             session->complete();
@@ -561,7 +568,8 @@ ServerHandlerImp::processSession(
             if (iter != session->request().end())
                 return iter->value();
             return boost::beast::string_view{};
-        }());
+        }(),
+        session->request().version() >= 11);
 
     if (beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
@@ -593,7 +601,8 @@ ServerHandlerImp::processRequest(
     Output&& output,
     std::shared_ptr<JobQueue::Coro> coro,
     boost::string_view forwardedFor,
-    boost::string_view user)
+    boost::string_view user,
+    bool canStream)
 {
     auto rpcJ = app_.journal("RPC");
 
@@ -994,14 +1003,18 @@ ServerHandlerImp::processRequest(
         return 200;
     }();
 
-    auto response = to_string(reply);
+    // Serialize the start of the reply. Only a large reply is streamed,
+    // since a streamed reply has no Content-Length.
+    Json::ValueStream body(std::move(reply));
+    std::string response;
+    body.write(
+        Json::stringOutput(response),
+        canStream ? RPC::Tuning::streamedResponseSize
+                  : std::numeric_limits<std::size_t>::max());
 
     rpc_time_.notify(std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now() - start));
     ++rpc_requests_;
-    rpc_size_.notify(beast::insight::Event::value_type{response.size()});
-
-    response += '\n';
 
     if (auto stream = m_journal.debug())
     {
@@ -1012,6 +1025,25 @@ ServerHandlerImp::processRequest(
             stream << "Reply: " << response.substr(0, maxSize);
     }
 
+    if (!body.done())
+    {
+        // The rest is serialized here too, and each chunk is written to
+        // the session as soon as it is ready, so the first bytes go out
+        // before serialization ends.
+        auto const size = HTTPChunkedReply(
+            httpStatus,
+            response,
+            body,
+            RPC::Tuning::streamedChunkSize,
+            output);
+        rpc_size_.notify(beast::insight::Event::value_type{size});
+        return;
+    }
+
+    rpc_size_.notify(beast::insight::Event::value_type{response.size()});
+
+    response += '\n';
+
     HTTPReply(httpStatus, response, output, rpcJ);
 }
 
@@ -182,6 +182,7 @@ private:
         std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
+    // A large reply is sent with chunked encoding if canStream is set.
     void
     processRequest(
         Port const& port,
@@ -190,7 +191,8 @@ private:
         Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
         boost::string_view forwardedFor,
-        boost::string_view user);
+        boost::string_view user,
+        bool canStream = false);
 
     Handoff
     statusResponse(http_request_type const& request) const;
@@ -65,6 +65,12 @@ static int constexpr maxJobQueueClients = 500;
 auto constexpr maxValidatedLedgerAge = std::chrono::minutes{2};
 static int constexpr maxRequestSize = 1000000;
 
+/** HTTP responses larger than this are streamed with chunked encoding. */
+static int constexpr streamedResponseSize = 256 * 1024;
+
+/** The size of each chunk of a streamed HTTP response. */
+static int constexpr streamedChunkSize = 64 * 1024;
+
 /** Maximum number of pages in one response from a binary LedgerData request. */
 static int constexpr binaryPageLength = 2048;
 
@@ -24,6 +24,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/server/impl/JSONRPCUtil.h>
 #include <boost/algorithm/string.hpp>
+#include <cstdio>
 
 namespace ripple {
 
@@ -52,6 +53,47 @@ getHTTPHeaderTimestamp()
     return std::string(buffer);
 }
 
+static void
+outputStatusLine(int nStatus, Json::Output const& output)
+{
+    switch (nStatus)
+    {
+        case 200:
+            output("HTTP/1.1 200 OK\r\n");
+            break;
+        case 202:
+            output("HTTP/1.1 202 Accepted\r\n");
+            break;
+        case 400:
+            output("HTTP/1.1 400 Bad Request\r\n");
+            break;
+        case 401:
+            output("HTTP/1.1 401 Authorization Required\r\n");
+            break;
+        case 403:
+            output("HTTP/1.1 403 Forbidden\r\n");
+            break;
+        case 404:
+            output("HTTP/1.1 404 Not Found\r\n");
+            break;
+        case 405:
+            output("HTTP/1.1 405 Method Not Allowed\r\n");
+            break;
+        case 429:
+            output("HTTP/1.1 429 Too Many Requests\r\n");
+            break;
+        case 500:
+            output("HTTP/1.1 500 Internal Server Error\r\n");
+            break;
+        case 501:
+            output("HTTP/1.1 501 Not Implemented\r\n");
+            break;
+        case 503:
+            output("HTTP/1.1 503 Server is overloaded\r\n");
+            break;
+    }
+}
+
 void
 HTTPReply(
     int nStatus,
@@ -95,42 +137,7 @@ HTTPReply(
         return;
     }
 
-    switch (nStatus)
-    {
-        case 200:
-            output("HTTP/1.1 200 OK\r\n");
-            break;
-        case 202:
-            output("HTTP/1.1 202 Accepted\r\n");
-            break;
-        case 400:
-            output("HTTP/1.1 400 Bad Request\r\n");
-            break;
-        case 401:
-            output("HTTP/1.1 401 Authorization Required\r\n");
-            break;
-        case 403:
-            output("HTTP/1.1 403 Forbidden\r\n");
-            break;
-        case 404:
-            output("HTTP/1.1 404 Not Found\r\n");
-            break;
-        case 405:
-            output("HTTP/1.1 405 Method Not Allowed\r\n");
-            break;
-        case 429:
-            output("HTTP/1.1 429 Too Many Requests\r\n");
-            break;
-        case 500:
-            output("HTTP/1.1 500 Internal Server Error\r\n");
-            break;
-        case 501:
-            output("HTTP/1.1 501 Not Implemented\r\n");
-            break;
-        case 503:
-            output("HTTP/1.1 503 Server is overloaded\r\n");
-            break;
-    }
+    outputStatusLine(nStatus, output);
 
     output(getHTTPHeaderTimestamp());
 
@@ -156,4 +163,52 @@ HTTPReply(
     output("\r\n");
 }
 
+std::size_t
+HTTPChunkedReply(
+    int nStatus,
+    std::string const& serialized,
+    Json::ValueStream& stream,
+    std::size_t chunkSize,
+    Json::Output const& output)
+{
+    outputStatusLine(nStatus, output);
+    output(getHTTPHeaderTimestamp());
+    output(
+        "Connection: Keep-Alive\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Content-Type: application/json; charset=UTF-8\r\n");
+    output("Server: " + systemName() + "-json-rpc/");
+    output(BuildInfo::getFullVersionString());
+    output(
+        "\r\n"
+        "\r\n");
+
+    std::size_t size = 0;
+    auto outputChunk = [&](std::string const& chunk) {
+        if (chunk.empty())
+            return;
+        char length[20];
+        std::snprintf(length, sizeof(length), "%zx\r\n", chunk.size());
+        output(length);
+        output(chunk);
+        output("\r\n");
+        size += chunk.size();
+    };
+
+    outputChunk(serialized);
+
+    std::string chunk;
+    chunk.reserve(chunkSize + 64);
+    while (!stream.done())
+    {
+        chunk.clear();
+        stream.write(Json::stringOutput(chunk), chunkSize);
+        outputChunk(chunk);
+    }
+
+    // The trailing CRLF, as with HTTPReply, then the last chunk
+    output("2\r\n\r\n\r\n0\r\n\r\n");
+    return size;
+}
+
 }  // namespace ripple
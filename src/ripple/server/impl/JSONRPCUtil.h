@@ -20,8 +20,12 @@
 #ifndef RIPPLE_SERVER_JSONRPCUTIL_H_INCLUDED
 #define RIPPLE_SERVER_JSONRPCUTIL_H_INCLUDED
 
+#include <ripple/beast/utility/Journal.h>
 #include <ripple/json/Output.h>
+#include <ripple/json/ValueStream.h>
 #include <ripple/json/json_value.h>
+#include <cstddef>
+#include <string>
 
 namespace ripple {
 
@@ -32,6 +36,22 @@ HTTPReply(
     Json::Output const&,
     beast::Journal j);
 
+/** Write a reply whose body is sent with chunked transfer encoding.
+
+    The body is the part already serialized followed by the rest of the
+    stream, and a CRLF, as with HTTPReply. Each chunk is passed to the
+    output as soon as it has been serialized.
+
+    @return The size of the body, without the CRLF.
+*/
+std::size_t
+HTTPChunkedReply(
+    int nStatus,
+    std::string const& serialized,
+    Json::ValueStream& stream,
+    std::size_t chunkSize,
+    Json::Output const&);
+
 }  // namespace ripple
 
 #endif
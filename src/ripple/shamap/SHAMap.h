@@ -39,6 +39,7 @@
 
 namespace ripple {
 
+class JobQueue;
 class SHAMapNodeID;
 class SHAMapSyncFilter;
 
@@ -217,6 +218,19 @@ public:
     boost::intrusive_ptr<SHAMapItem const> const&
     peekItem(uint256 const& id, SHAMapHash& hash) const;
 
+    /** Load the nodes on the paths to the given keys.
+
+        The paths are walked together, one level at a time, and the nodes
+        missing at each level are read from the backend in a single batch.
+        Later lookups of the keys then find every node already in memory.
+
+        @param keys The keys whose paths should be loaded. The keys do not
+                    need to be present in the map.
+        @return The number of nodes read from the backend.
+     */
+    std::size_t
+    prefetch(std::vector<uint256> const& keys) const;
+
     // traverse functions
     /** Find the first item after the given item.
 
@@ -344,10 +358,29 @@ public:
     int
     unshare();
 
-    /** Flush modified nodes to the nodestore and convert them to shared. */
+    /** Flush modified nodes to the nodestore and convert them to shared.
+
+        @param t The type of the node objects written.
+        @return The number of nodes flushed.
+    */
     int
     flushDirty(NodeObjectType t);
 
+    /** Flush modified nodes, sharing the work with jobs.
+
+        The subtrees below the root are hashed and written by the calling
+        thread and by up to `helpers` jtLEDGER_FLUSH jobs. The nodes
+        written and the resulting hashes are identical to those of a
+        serial flush.
+
+        @param t The type of the node objects written.
+        @param jobQueue The queue to add the jobs to.
+        @param helpers The most jobs to add.
+        @return The number of nodes flushed.
+    */
+    int
+    flushDirty(NodeObjectType t, JobQueue& jobQueue, int helpers);
+
     void
     walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
     bool
@@ -459,16 +492,13 @@ private:
     descendThrow(std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
     // Descend with filter
-    // If pending, callback is called as if it called fetchNodeNT
-    using descendCallback =
-        std::function<void(std::shared_ptr<SHAMapTreeNode>, SHAMapHash const&)>;
+    // If pending, the node must be read from the database by the caller
     SHAMapTreeNode*
     descendAsync(
         SHAMapInnerNode* parent,
         int branch,
         SHAMapSyncFilter* filter,
-        bool& pending,
-        descendCallback&&) const;
+        bool& pending) const;
 
     std::pair<SHAMapTreeNode*, SHAMapNodeID>
     descend(
@@ -503,7 +533,32 @@ private:
         Delta& differences,
         int& maxCount) const;
     int
-    walkSubTree(bool doWrite, NodeObjectType t);
+    walkSubTree(
+        bool doWrite,
+        NodeObjectType t,
+        JobQueue* jobQueue = nullptr,
+        int helpers = 0);
+
+    /** Flush the modified nodes below an inner node this map owns.
+
+        On return `node` refers to the flushed, shared, node.
+    */
+    int
+    walkSubTree(
+        std::shared_ptr<SHAMapInnerNode>& node,
+        bool doWrite,
+        NodeObjectType t) const;
+
+    /** Flush the modified inner children of the root in parallel, and
+        hook the flushed children to the root.
+    */
+    int
+    walkBranchesParallel(
+        std::shared_ptr<SHAMapInnerNode> const& root,
+        bool doWrite,
+        NodeObjectType t,
+        JobQueue& jobQueue,
+        int helpers) const;
 
     // Structure to track information about call to
     // getMissingNodes while it's in progress
@@ -518,6 +573,7 @@ private:
         int max_;
         SHAMapSyncFilter* filter_;
         int const maxDefer_;
+        std::size_t const batchSize_;
         std::uint32_t generation_;
 
         // nodes we have discovered to be missing
@@ -546,7 +602,15 @@ private:
             int,                               // branch
             std::shared_ptr<SHAMapTreeNode>>;  // node
 
+        // reads not yet handed to the database, sent as one batch
+        using PendingRead = std::tuple<
+            SHAMapInnerNode*,  // parent node
+            SHAMapNodeID,      // parent node ID
+            int,               // branch
+            SHAMapHash>;       // hash of the node
+
         int deferred_;
+        std::vector<PendingRead> pendingReads_;
         std::mutex deferLock_;
         std::condition_variable deferCondVar_;
         std::vector<DeferredNode> finishedReads_;
@@ -559,14 +623,17 @@ private:
             int max,
             SHAMapSyncFilter* filter,
             int maxDefer,
+            std::size_t batchSize,
             std::uint32_t generation)
             : max_(max)
             , filter_(filter)
             , maxDefer_(maxDefer)
+            , batchSize_(batchSize)
             , generation_(generation)
             , deferred_(0)
         {
             missingNodes_.reserve(max);
+            pendingReads_.reserve(batchSize);
             finishedReads_.reserve(maxDefer);
         }
     };
@@ -576,6 +643,8 @@ private:
     gmn_ProcessNodes(MissingNodes&, MissingNodes::StackEntry& node);
     void
     gmn_ProcessDeferredReads(MissingNodes&);
+    void
+    gmn_SubmitPendingReads(MissingNodes&);
 
     // fetch from DB helper function
     std::shared_ptr<SHAMapTreeNode>
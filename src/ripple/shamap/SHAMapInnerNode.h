@@ -92,6 +92,16 @@ private:
     void
     iterChildren(F&& f) const;
 
+    /** Call the `f` callback with the hashes of all 16 (branchFactor)
+        branches as a series of contiguous byte ranges.
+
+        @param f a two parameter callback function. The first parameter is
+        a pointer to the start of the range, the second is its size in bytes.
+    */
+    template <class F>
+    void
+    iterHashRanges(F&& f) const;
+
     /** Call the `f` callback for all non-empty branches.
 
         @param f a two parameter callback function. The first parameter is
@@ -42,7 +42,9 @@ NodeFamily::NodeFamily(Application& app, CollectorManager& cm)
           std::chrono::seconds(
               app.config().getValueFor(SizedItem::treeCacheAge)),
           stopwatch(),
-          j_))
+          j_,
+          beast::insight::NullCollector::New(),
+          true))
 {
 }
 
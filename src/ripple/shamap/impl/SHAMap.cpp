@@ -18,12 +18,14 @@
 //==============================================================================
 
 #include <ripple/basics/contract.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapAccountStateLeafNode.h>
 #include <ripple/shamap/SHAMapNodeID.h>
 #include <ripple/shamap/SHAMapSyncFilter.h>
 #include <ripple/shamap/SHAMapTxLeafNode.h>
 #include <ripple/shamap/SHAMapTxPlusMetaLeafNode.h>
+#include <array>
 
 namespace ripple {
 
@@ -387,8 +389,7 @@ SHAMap::descendAsync(
     SHAMapInnerNode* parent,
     int branch,
     SHAMapSyncFilter* filter,
-    bool& pending,
-    descendCallback&& callback) const
+    bool& pending) const
 {
     pending = false;
 
@@ -406,14 +407,6 @@ SHAMap::descendAsync(
 
         if (!ptr && backed_)
         {
-            f_.db().asyncFetch(
-                hash.as_uint256(),
-                ledgerSeq_,
-                [this, hash, cb{std::move(callback)}](
-                    std::shared_ptr<NodeObject> const& object) {
-                    auto node = finishFetch(hash, object);
-                    cb(node, hash);
-                });
             pending = true;
             return nullptr;
         }
@@ -611,6 +604,117 @@ SHAMap::peekItem(uint256 const& id, SHAMapHash& hash) const
     return leaf->peekItem();
 }
 
+std::size_t
+SHAMap::prefetch(std::vector<uint256> const& keys) const
+{
+    if (!backed_ || keys.empty())
+        return 0;
+
+    // A path that has reached an inner node and has further to go
+    struct Path
+    {
+        std::shared_ptr<SHAMapInnerNode> node;
+        SHAMapNodeID nodeID;
+        uint256 const* key;
+    };
+
+    // A path waiting for the child at `branch` to be read
+    struct Read
+    {
+        Path path;
+        int branch;
+        std::size_t index;
+    };
+
+    std::vector<Path> paths;
+    paths.reserve(keys.size());
+    for (auto const& key : keys)
+        paths.push_back({std::static_pointer_cast<SHAMapInnerNode>(root_),
+                         SHAMapNodeID{},
+                         &key});
+
+    std::size_t fetched = 0;
+    std::vector<Read> reads;
+    std::vector<uint256> hashes;
+    hash_map<uint256, std::size_t> indexes;
+
+    while (!paths.empty())
+    {
+        // Follow each path through the nodes that are already in memory
+        for (auto& path : paths)
+        {
+            while (true)
+            {
+                int const branch = selectBranch(path.nodeID, *path.key);
+                if (path.node->isEmptyBranch(branch))
+                    break;
+
+                auto child = path.node->getChild(branch);
+                if (!child)
+                {
+                    auto const& hash = path.node->getChildHash(branch);
+                    if (auto node = cacheLookup(hash))
+                    {
+                        child = path.node->canonicalizeChild(
+                            branch, std::move(node));
+                    }
+                    else
+                    {
+                        auto const [it, inserted] = indexes.emplace(
+                            hash.as_uint256(), hashes.size());
+                        if (inserted)
+                            hashes.push_back(hash.as_uint256());
+                        reads.push_back({std::move(path), branch, it->second});
+                        break;
+                    }
+                }
+
+                if (child->isLeaf())
+                    break;
+
+                path.node = std::static_pointer_cast<SHAMapInnerNode>(child);
+                path.nodeID = path.nodeID.getChildNodeID(branch);
+            }
+        }
+
+        paths.clear();
+        if (reads.empty())
+            break;
+
+        // Read every node missing at this level at once
+        auto const objects = f_.db().fetchBatch(hashes, ledgerSeq_);
+        std::vector<std::shared_ptr<SHAMapTreeNode>> nodes(hashes.size());
+        for (std::size_t i = 0; i < hashes.size(); ++i)
+        {
+            nodes[i] = finishFetch(SHAMapHash{hashes[i]}, objects[i]);
+            if (nodes[i])
+                ++fetched;
+        }
+
+        for (auto& read : reads)
+        {
+            auto node = nodes[read.index];
+            if (!node)
+                continue;
+
+            node = read.path.node->canonicalizeChild(read.branch, node);
+            if (node->isInner())
+            {
+                auto& path = read.path;
+                path.node = std::static_pointer_cast<SHAMapInnerNode>(node);
+                path.nodeID = path.nodeID.getChildNodeID(read.branch);
+                paths.push_back(std::move(path));
+            }
+        }
+
+        reads.clear();
+        hashes.clear();
+        indexes.clear();
+    }
+
+    return fetched;
+}
+
 SHAMap::const_iterator
 SHAMap::upper_bound(uint256 const& id) const
 {
@@ -996,7 +1100,17 @@ SHAMap::flushDirty(NodeObjectType t)
 }
 
 int
-SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
+SHAMap::flushDirty(NodeObjectType t, JobQueue& jobQueue, int helpers)
+{
+    return walkSubTree(backed_, t, &jobQueue, helpers);
+}
+
+int
+SHAMap::walkSubTree(
+    bool doWrite,
+    NodeObjectType t,
+    JobQueue* jobQueue,
+    int helpers)
 {
     assert(!doWrite || backed_);
 
@@ -1025,13 +1139,35 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         return 1;
     }
 
+    node = preFlushNode(std::move(node));
+
+    // Flush the subtrees below the root in parallel; the serial walk then
+    // skips them, since they are no longer modified.
+    if (jobQueue && helpers > 0)
+        flushed +=
+            walkBranchesParallel(node, doWrite, t, *jobQueue, helpers);
+
+    flushed += walkSubTree(node, doWrite, t);
+
+    // Last inner node is the new root_
+    root_ = std::move(node);
+
+    return flushed;
+}
+
+int
+SHAMap::walkSubTree(
+    std::shared_ptr<SHAMapInnerNode>& node,
+    bool doWrite,
+    NodeObjectType t) const
+{
+    int flushed = 0;
+
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
     using StackEntry = std::pair<std::shared_ptr<SHAMapInnerNode>, int>;
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
-    node = preFlushNode(std::move(node));
-
     int pos = 0;
 
     // We can't flush an inner node until we flush its children
@@ -1114,9 +1250,62 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         ++pos;
     }
 
-    // Last inner node is the new root_
-    root_ = std::move(node);
+    return flushed;
+}
+
+int
+SHAMap::walkBranchesParallel(
+    std::shared_ptr<SHAMapInnerNode> const& root,
+    bool doWrite,
+    NodeObjectType t,
+    JobQueue& jobQueue,
+    int helpers) const
+{
+    assert(root->cowid() == cowid_);
 
+    // Only modified inner nodes are worth handing to another thread;
+    // modified leaves are left to the serial walk.
+    std::array<std::shared_ptr<SHAMapInnerNode>, branchFactor> subtrees;
+    std::vector<int> branches;
+    for (int branch = 0; branch < branchFactor; ++branch)
+    {
+        if (root->isEmptyBranch(branch))
+            continue;
+
+        auto child = root->getChild(branch);
+        if (child && (child->cowid() != 0) && child->isInner())
+        {
+            subtrees[branch] =
+                std::static_pointer_cast<SHAMapInnerNode>(std::move(child));
+            branches.push_back(branch);
+        }
+    }
+
+    if (branches.size() < 2)
+        return 0;
+
+    // The calling thread works too, so the flush never waits for a job
+    // that the queue has not started.
+    std::array<int, branchFactor> counts{};
+    jobQueue.forEach(
+        jtLEDGER_FLUSH,
+        "SHAMap::flushDirty",
+        branches.size(),
+        helpers,
+        [&](std::size_t i) {
+            auto const branch = branches[i];
+            auto node = preFlushNode(std::move(subtrees[branch]));
+            counts[branch] = walkSubTree(node, doWrite, t);
+            subtrees[branch] = std::move(node);
+        });
+
+    // Hook the flushed subtrees to the root in branch order
+    int flushed = 0;
+    for (auto const branch : branches)
+    {
+        root->shareChild(branch, subtrees[branch]);
+        flushed += counts[branch];
+    }
     return flushed;
 }
 
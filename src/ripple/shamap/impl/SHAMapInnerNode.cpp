@@ -51,6 +51,13 @@ SHAMapInnerNode::iterChildren(F&& f) const
     hashesAndChildren_.iterChildren(isBranch_, std::forward<F>(f));
 }
 
+template <class F>
+void
+SHAMapInnerNode::iterHashRanges(F&& f) const
+{
+    hashesAndChildren_.iterHashRanges(isBranch_, std::forward<F>(f));
+}
+
 template <class F>
 void
 SHAMapInnerNode::iterNonEmptyChildIndexes(F&& f) const
@@ -201,7 +208,8 @@ SHAMapInnerNode::updateHash()
         sha512_half_hasher h;
         using beast::hash_append;
         hash_append(h, HashPrefix::innerNode);
-        iterChildren([&](SHAMapHash const& hh) { hash_append(h, hh); });
+        iterHashRanges(
+            [&](void const* data, std::size_t size) { h(data, size); });
         nh = static_cast<typename sha512_half_hasher::result_type>(h);
     }
     hash_ = SHAMapHash{nh};
@@ -240,8 +248,9 @@ SHAMapInnerNode::serializeForWire(Serializer& s) const
     }
     else
     {
-        iterChildren(
-            [&](SHAMapHash const& hh) { s.addBitString(hh.as_uint256()); });
+        iterHashRanges([&](void const* data, std::size_t size) {
+            s.addRaw(data, static_cast<int>(size));
+        });
         s.add8(wireTypeInner);
     }
 }
@@ -252,8 +261,9 @@ SHAMapInnerNode::serializeWithPrefix(Serializer& s) const
     assert(!isEmpty());
 
     s.add32(HashPrefix::innerNode);
-    iterChildren(
-        [&](SHAMapHash const& hh) { s.addBitString(hh.as_uint256()); });
+    iterHashRanges([&](void const* data, std::size_t size) {
+        s.addRaw(data, static_cast<int>(size));
+    });
 }
 
 bool
@@ -20,6 +20,7 @@
 #include <ripple/basics/random.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapSyncFilter.h>
+#include <iterator>
 
 namespace ripple {
 
@@ -196,24 +197,18 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
                  ->touch_if_exists(childHash.as_uint256()))
         {
             bool pending = false;
-            auto d = descendAsync(
-                node,
-                branch,
-                mn.filter_,
-                pending,
-                [node, nodeID, branch, &mn](
-                    std::shared_ptr<SHAMapTreeNode> found, SHAMapHash const&) {
-                    // a read completed asynchronously
-                    std::unique_lock<std::mutex> lock{mn.deferLock_};
-                    mn.finishedReads_.emplace_back(
-                        node, nodeID, branch, std::move(found));
-                    mn.deferCondVar_.notify_one();
-                });
+            auto d = descendAsync(node, branch, mn.filter_, pending);
 
             if (pending)
             {
                 fullBelow = false;
                 ++mn.deferred_;
+
+                // Reads are handed to the database in batches, so the
+                // traversal keeps going while earlier batches are read.
+                mn.pendingReads_.emplace_back(node, nodeID, branch, childHash);
+                if (mn.pendingReads_.size() >= mn.batchSize_)
+                    gmn_SubmitPendingReads(mn);
             }
             else if (!d)
             {
@@ -259,11 +254,55 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
     node = nullptr;
 }
 
+// Hand the reads we have deferred so far to the database
+// as a single batch
+void
+SHAMap::gmn_SubmitPendingReads(MissingNodes& mn)
+{
+    if (mn.pendingReads_.empty())
+        return;
+
+    std::vector<uint256> hashes;
+    hashes.reserve(mn.pendingReads_.size());
+    for (auto const& read : mn.pendingReads_)
+        hashes.push_back(std::get<3>(read).as_uint256());
+
+    f_.db().asyncFetchBatch(
+        std::move(hashes),
+        ledgerSeq_,
+        [this, &mn, reads = std::move(mn.pendingReads_)](
+            std::vector<std::shared_ptr<NodeObject>> const& objects) {
+            assert(objects.size() == reads.size());
+
+            std::vector<MissingNodes::DeferredNode> found;
+            found.reserve(reads.size());
+            for (std::size_t i = 0; i < reads.size(); ++i)
+            {
+                auto const& [parent, parentID, branch, hash] = reads[i];
+                found.emplace_back(
+                    parent, parentID, branch, finishFetch(hash, objects[i]));
+            }
+
+            // a batch of reads completed asynchronously
+            std::unique_lock<std::mutex> lock{mn.deferLock_};
+            std::move(
+                found.begin(),
+                found.end(),
+                std::back_inserter(mn.finishedReads_));
+            mn.deferCondVar_.notify_one();
+        });
+
+    mn.pendingReads_.clear();
+    mn.pendingReads_.reserve(mn.batchSize_);
+}
+
 // Wait for deferred reads to finish and
 // process their results
 void
 SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
 {
+    gmn_SubmitPendingReads(mn);
+
     // Process all deferred reads
     int complete = 0;
     while (complete != mn.deferred_)
@@ -323,6 +362,7 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
         max,
         filter,
         512,  // number of async reads per pass
+        64,   // number of async reads per database batch
         f_.getFullBelowCache(ledgerSeq_)->getGeneration());
 
     if (!root_->isInner() ||
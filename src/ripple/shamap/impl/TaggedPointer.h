@@ -192,6 +192,24 @@ public:
     void
     iterChildren(std::uint16_t isBranch, F&& f) const;
 
+    /** Call the `f` callback with the hashes of all 16 (branchFactor)
+        branches, in branch order, as a series of contiguous byte ranges.
+
+        Hashes are stored back to back, so the dense format is a single
+        range. The sparse format is one range per run of adjacent non-empty
+        branches, and one range of zero bytes per run of empty branches.
+        This lets the hashes be fed to a hasher or serializer without being
+        copied one at a time.
+
+        @param isBranch bitset of non-empty children
+
+        @param f a two parameter callback function. The first parameter is
+        a pointer to the start of the range, the second is its size in bytes.
+     */
+    template <class F>
+    void
+    iterHashRanges(std::uint16_t isBranch, F&& f) const;
+
     /** Call the `f` callback for all non-empty branches.
 
         @param isBranch bitset of non-empty children
@@ -186,6 +186,14 @@ popcnt16(std::uint16_t a)
 // the hash isn't actually stored in the array.
 static SHAMapHash const zeroSHAMapHash;
 
+// Used in `iterHashRanges` for runs of empty branches in sparse arrays.
+static std::array<SHAMapHash, SHAMapInnerNode::branchFactor> const
+    zeroSHAMapHashes{};
+
+static_assert(
+    sizeof(SHAMapHash) == uint256::bytes,
+    "SHAMapHash arrays must be contiguous bytes");
+
 }  // namespace
 
 template <class F>
@@ -217,6 +225,44 @@ TaggedPointer::iterChildren(std::uint16_t isBranch, F&& f) const
     }
 }
 
+template <class F>
+void
+TaggedPointer::iterHashRanges(std::uint16_t isBranch, F&& f) const
+{
+    auto [numAllocated, hashes, _] = getHashesAndChildren();
+    if (numAllocated == SHAMapInnerNode::branchFactor)
+    {
+        // dense case
+        f(static_cast<void const*>(hashes),
+          SHAMapInnerNode::branchFactor * sizeof(SHAMapHash));
+        return;
+    }
+
+    // sparse case
+    int curHashI = 0;
+    for (int i = 0; i < SHAMapInnerNode::branchFactor;)
+    {
+        bool const nonEmpty = (1 << i) & isBranch;
+        int n = 1;
+        while (i + n < SHAMapInnerNode::branchFactor &&
+               bool((1 << (i + n)) & isBranch) == nonEmpty)
+            ++n;
+
+        if (nonEmpty)
+        {
+            f(static_cast<void const*>(hashes + curHashI),
+              n * sizeof(SHAMapHash));
+            curHashI += n;
+        }
+        else
+        {
+            f(static_cast<void const*>(zeroSHAMapHashes.data()),
+              n * sizeof(SHAMapHash));
+        }
+        i += n;
+    }
+}
+
 template <class F>
 void
 TaggedPointer::iterNonEmptyChildIndexes(std::uint16_t isBranch, F&& f) const
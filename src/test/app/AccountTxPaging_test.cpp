@@ -16,7 +16,11 @@
     OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 //==============================================================================
+#include <ripple/app/main/DBInit.h>
+#include <ripple/app/rdb/backend/detail/Node.h>
+#include <ripple/beast/core/LexicalCast.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/core/SociDB.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/jss.h>
 #include <cstdlib>
@@ -60,13 +64,22 @@ class AccountTxPaging_test : public beast::unit_test::suite
         return env.rpc("json", "account_tx", to_string(jvc))[jss::result];
     }
 
+    static std::unique_ptr<Config>
+    compactTxTables(std::unique_ptr<Config> cfg)
+    {
+        cfg->loadFromString("[ledger_tx_tables]\ncompact_tx_tables=1");
+        return cfg;
+    }
+
     void
-    testAccountTxPaging()
+    testAccountTxPaging(bool compact)
     {
-        testcase("Paging for Single Account");
+        testcase(
+            std::string("Paging for Single Account") +
+            (compact ? " (compact tables)" : ""));
         using namespace test::jtx;
 
-        Env env(*this);
+        Env env(*this, compact ? envconfig(compactTxTables) : envconfig());
         Account A1{"A1"};
         Account A2{"A2"};
         Account A3{"A3"};
@@ -263,14 +276,217 @@ class AccountTxPaging_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testTxLookup()
+    {
+        testcase("Transaction lookup with compact tables");
+        using namespace test::jtx;
+
+        Env env(*this, envconfig(compactTxTables));
+        Account A1{"A1"};
+        Account A2{"A2"};
+
+        env.fund(XRP(10000), A1, A2);
+        env.close();
+        env(pay(A1, A2, XRP(100)));
+        env.close();
+
+        auto const id = to_string(env.tx()->getTransactionID());
+        auto const jrr = env.rpc("tx", id)[jss::result];
+        BEAST_EXPECT(jrr[jss::hash] == id);
+        BEAST_EXPECT(jrr[jss::Account] == A1.human());
+        BEAST_EXPECT(jrr[jss::Destination] == A2.human());
+        BEAST_EXPECT(jrr[jss::validated].asBool());
+
+        // The transaction is listed for both accounts
+        for (auto const& account : {A1, A2})
+        {
+            auto const txs = next(env, account, -1, -1, 10, false);
+            if (BEAST_EXPECT(
+                    txs[jss::transactions].isArray() &&
+                    txs[jss::transactions].size() > 0))
+                BEAST_EXPECT(
+                    txs[jss::transactions][0u][jss::tx][jss::hash] == id);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testAccountTxPaging(false);
+        testAccountTxPaging(true);
+        testTxLookup();
+    }
+};
+
+/** Measure paging deep into a long account history.
+
+    A synthetic history is written straight to an in-memory transaction
+    database, and then read back a page at a time by following markers,
+    the way account_tx does. The time taken by pages near the start and
+    near the end of the history is reported; with marker seeks the two
+    are about the same. Pass the number of ledgers to write as the
+    argument to override the default.
+*/
+class AccountTxPagingTiming_test : public beast::unit_test::suite
+{
+    static constexpr std::uint32_t defaultLedgers = 100000;
+    static constexpr std::uint32_t txnsPerLedger = 5;
+    static constexpr std::uint32_t pageSize = 200;
+
+    template <std::size_t N>
+    static void
+    create(soci::session& session, std::array<char const*, N> const& init)
+    {
+        for (auto const& statement : init)
+            session << statement;
+    }
+
+    void
+    fill(
+        soci::session& session,
+        AccountID const& account,
+        detail::TxSchema schema,
+        std::uint32_t ledgers)
+    {
+        auto const literal = schema == detail::TxSchema::compact
+            ? "X'" + strHex(account) + "'"
+            : "'" + toBase58(account) + "'";
+
+        std::uint32_t ledger = 0;
+        std::uint32_t txnSeq = 0;
+
+        // Writes the rows with the transaction ID bound to id, which set
+        // assigns in the form the layout stores
+        auto write = [&](auto& id, auto const& set) {
+            soci::statement accountTxs =
+                (session.prepare
+                     << "INSERT INTO AccountTransactions "
+                        "(TransID, Account, LedgerSeq, TxnSeq) VALUES "
+                        "(:id, " +
+                         literal + ", :ledger, :txnSeq);",
+                 soci::use(id),
+                 soci::use(ledger),
+                 soci::use(txnSeq));
+            soci::statement txs =
+                (session.prepare
+                     << "INSERT INTO Transactions "
+                        "(TransID, LedgerSeq, Status, RawTxn, TxnMeta) "
+                        "VALUES (:id, :ledger, 'V', X'00', X'00');",
+                 soci::use(id),
+                 soci::use(ledger));
+
+            soci::transaction tr(session);
+            for (ledger = 1; ledger <= ledgers; ++ledger)
+            {
+                for (txnSeq = 0; txnSeq < txnsPerLedger; ++txnSeq)
+                {
+                    set(uint256(ledger * txnsPerLedger + txnSeq));
+                    accountTxs.execute(true);
+                    txs.execute(true);
+                }
+            }
+            tr.commit();
+        };
+
+        if (schema == detail::TxSchema::compact)
+        {
+            // Every ID is 32 bytes, so each write replaces the last one
+            soci::blob id(session);
+            write(id, [&id](uint256 const& txID) {
+                id.write(
+                    0, reinterpret_cast<char const*>(txID.data()), txID.size());
+            });
+        }
+        else
+        {
+            std::string id;
+            write(id, [&id](uint256 const& txID) { id = to_string(txID); });
+        }
+    }
+
+    void
+    page(detail::TxSchema schema, std::uint32_t ledgers)
+    {
+        testcase(
+            schema == detail::TxSchema::compact ? "compact tables"
+                                                : "legacy tables");
+
+        soci::session session;
+        open(session, "sqlite", ":memory:");
+        if (schema == detail::TxSchema::compact)
+            create(session, TxDBInitCompact);
+        else
+            create(session, TxDBInit);
+
+        AccountID const account(7);
+        fill(session, account, schema, ledgers);
+
+        using namespace std::chrono;
+
+        std::uint32_t total = 0;
+        std::uint32_t pages = 0;
+        std::uint32_t const totalPages =
+            (ledgers * txnsPerLedger + pageSize - 1) / pageSize;
+        std::optional<RelationalDatabase::AccountTxMarker> marker;
+        std::optional<RelationalDatabase::AccountTxMarker> last;
+        bool ordered = true;
+        nanoseconds first{0};
+        nanoseconds deep{0};
+        do
+        {
+            RelationalDatabase::AccountTxPageOptions const options{
+                account, 1, ledgers, marker, pageSize, true};
+            auto const start = steady_clock::now();
+            auto const [next, count] = detail::oldestAccountTxPage(
+                session,
+                [](std::uint32_t) {},
+                [&](std::uint32_t ledger,
+                    std::string const&,
+                    Blob&&,
+                    Blob&&) {
+                    if (last && ledger < last->ledgerSeq)
+                        ordered = false;
+                    last = {ledger, 0};
+                },
+                options,
+                0,
+                pageSize);
+            auto const elapsed = steady_clock::now() - start;
+            if (pages < 10)
+                first += elapsed;
+            else if (pages >= totalPages - 10)
+                deep += elapsed;
+            total += count;
+            marker = next;
+            ++pages;
+        } while (marker && pages <= totalPages);
+
+        BEAST_EXPECT(ordered);
+        BEAST_EXPECT(total == ledgers * txnsPerLedger);
+        BEAST_EXPECT(pages == totalPages);
+        log << pages << " pages of " << pageSize << ", "
+            << duration_cast<microseconds>(first).count() / 10
+            << " us per page at the start, "
+            << duration_cast<microseconds>(deep).count() / 10
+            << " us per page at the end" << std::endl;
+    }
+
 public:
     void
     run() override
     {
-        testAccountTxPaging();
+        std::uint32_t const ledgers = arg().empty()
+            ? defaultLedgers
+            : beast::lexicalCastThrow<std::uint32_t>(arg());
+
+        page(detail::TxSchema::legacy, ledgers);
+        page(detail::TxSchema::compact, ledgers);
     }
 };
 
 BEAST_DEFINE_TESTSUITE(AccountTxPaging, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(AccountTxPagingTiming, app, ripple);
 
 }  // namespace ripple
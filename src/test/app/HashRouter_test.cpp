@@ -21,6 +21,9 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
 
+#include <set>
+#include <vector>
+
 namespace ripple {
 namespace test {
 
@@ -31,7 +34,9 @@ class HashRouter_test : public beast::unit_test::suite
     {
         using namespace std::chrono_literals;
         TestStopwatch stopwatch;
-        HashRouter router(stopwatch, 2s);
+        // Entries expire separately in each shard. With a single shard,
+        // inserting one key expires every other stale key.
+        HashRouter router(stopwatch, 2s, 1);
 
         uint256 const key1(1);
         uint256 const key2(2);
@@ -68,7 +73,8 @@ class HashRouter_test : public beast::unit_test::suite
     {
         using namespace std::chrono_literals;
         TestStopwatch stopwatch;
-        HashRouter router(stopwatch, 2s);
+        // See testNonExpiration
+        HashRouter router(stopwatch, 2s, 1);
 
         uint256 const key1(1);
         uint256 const key2(2);
@@ -242,6 +248,69 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.shouldProcess(key, peer, flags, 1s));
     }
 
+    void
+    testShards()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s);
+
+        std::vector<uint256> keys;
+        for (int i = 1; i <= 1000; ++i)
+        {
+            keys.emplace_back(i);
+            BEAST_EXPECT(router.setFlags(keys.back(), 1 + i % 7));
+        }
+        for (int i = 1; i <= 1000; ++i)
+            BEAST_EXPECT(router.getFlags(keys[i - 1]) == 1 + i % 7);
+
+        ++stopwatch;
+        ++stopwatch;
+        ++stopwatch;
+
+        // Insertions into each shard expire that shard's stale entries.
+        // Touch the even keys first so that they survive.
+        for (int i = 2; i <= 1000; i += 2)
+            BEAST_EXPECT(router.getFlags(keys[i - 1]) == 1 + i % 7);
+        for (int i = 1001; i <= 2000; ++i)
+            router.addSuppression(uint256(i));
+        for (int i = 1; i <= 1000; ++i)
+        {
+            auto const expected = i % 2 ? 0 : 1 + i % 7;
+            BEAST_EXPECT(router.getFlags(keys[i - 1]) == expected);
+        }
+    }
+
+    void
+    testPeers()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 1s);
+
+        uint256 const key1(1);
+        BEAST_EXPECT(router.shouldRelay(key1));
+
+        // Peers are kept once each, in order, however many there are
+        std::set<HashRouter::PeerShortID> expected;
+        for (HashRouter::PeerShortID peer = 300; peer > 0; peer -= 3)
+        {
+            router.addSuppressionPeer(key1, peer);
+            router.addSuppressionPeer(key1, peer);
+            expected.insert(peer);
+        }
+        // Peer zero is never recorded
+        router.addSuppressionPeer(key1, 0);
+
+        ++stopwatch;
+        auto const peers = router.shouldRelay(key1);
+        BEAST_EXPECT(peers && *peers == expected);
+
+        ++stopwatch;
+        auto const none = router.shouldRelay(key1);
+        BEAST_EXPECT(none && none->empty());
+    }
+
 public:
     void
     run() override
@@ -252,6 +321,8 @@ public:
         testSetFlags();
         testRelay();
         testProcess();
+        testShards();
+        testPeers();
     }
 };
 
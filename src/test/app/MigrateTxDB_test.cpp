@@ -0,0 +1,256 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/app/rdb/MigrateTxDB.h>
+#include <ripple/app/rdb/backend/detail/Node.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <test/jtx.h>
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+
+namespace ripple {
+namespace test {
+
+class MigrateTxDB_test : public beast::unit_test::suite
+{
+    // The transactions of an account, oldest first, with their ledgers
+    using History = std::vector<std::pair<uint256, std::uint32_t>>;
+
+    History
+    accountTxs(
+        jtx::Env& env,
+        soci::session& session,
+        detail::TxSchema schema,
+        AccountID const& account)
+    {
+        RelationalDatabase::AccountTxOptions const options{
+            account,
+            0,
+            std::numeric_limits<std::uint32_t>::max(),
+            0,
+            100,
+            false};
+        auto const txs = detail::getOldestAccountTxs(
+                             session,
+                             env.app(),
+                             env.app().getLedgerMaster(),
+                             options,
+                             {},
+                             env.journal,
+                             schema)
+                             .first;
+
+        History history;
+        for (auto const& [tx, meta] : txs)
+        {
+            if (BEAST_EXPECT(tx && meta))
+                history.emplace_back(tx->getID(), meta->getLgrSeq());
+        }
+        return history;
+    }
+
+    // Looks a transaction up by its ID, as the tx command does
+    std::optional<RelationalDatabase::AccountTx>
+    find(
+        jtx::Env& env,
+        soci::session& session,
+        detail::TxSchema schema,
+        uint256 const& id)
+    {
+        error_code_i ec = rpcSUCCESS;
+        auto const found = detail::getTransaction(
+            session,
+            env.app(),
+            id,
+            std::nullopt,
+            ec,
+            schema);
+        auto const tx = std::get_if<RelationalDatabase::AccountTx>(&found);
+        if (!tx || !tx->first || !tx->second)
+            return std::nullopt;
+        return *tx;
+    }
+
+    // Checks that both databases list the same transactions for each
+    // account, and find each of them by its ID.
+    void
+    compare(
+        jtx::Env& env,
+        soci::session& legacy,
+        soci::session& compact,
+        std::vector<jtx::Account> const& accounts)
+    {
+        auto const legacySchema = detail::TxSchema::legacy;
+        auto const compactSchema = detail::TxSchema::compact;
+        BEAST_EXPECT(detail::getTxSchema(legacy) == legacySchema);
+        BEAST_EXPECT(detail::getTxSchema(compact) == compactSchema);
+
+        for (auto const& account : accounts)
+        {
+            auto const history =
+                accountTxs(env, legacy, legacySchema, account.id());
+            BEAST_EXPECT(!history.empty());
+            BEAST_EXPECT(
+                accountTxs(env, compact, compactSchema, account.id()) ==
+                history);
+
+            for (auto const& [id, seq] : history)
+            {
+                auto const fromLegacy = find(env, legacy, legacySchema, id);
+                auto const fromCompact = find(env, compact, compactSchema, id);
+                if (BEAST_EXPECT(fromLegacy && fromCompact))
+                {
+                    BEAST_EXPECT(fromCompact->first->getID() == id);
+                    BEAST_EXPECT(fromCompact->second->getLgrSeq() == seq);
+                    BEAST_EXPECT(
+                        fromCompact->first->getSTransaction()->getFullText() ==
+                        fromLegacy->first->getSTransaction()->getFullText());
+                    BEAST_EXPECT(
+                        fromCompact->second->getAsObject() ==
+                        fromLegacy->second->getAsObject());
+                }
+            }
+        }
+    }
+
+    void
+    testMigrate()
+    {
+        testcase("Migrate the transaction database");
+        jtx::Env env(*this);
+        // The first ledger not yet written to the database
+        std::uint32_t saved = env.closed()->info().seq;
+        jtx::Account const alice("alice");
+        jtx::Account const bob("bob");
+        jtx::Account const carol("carol");
+        std::vector<jtx::Account> const accounts{alice, bob, carol};
+
+        auto pay = [&](int count) {
+            for (int i = 0; i < count; ++i)
+            {
+                env(jtx::pay(alice, bob, jtx::XRP(10)));
+                env(jtx::pay(bob, carol, jtx::XRP(5)));
+                env.close();
+            }
+        };
+        env.fund(jtx::XRP(10000), alice, bob, carol);
+        env.close();
+        pay(5);
+
+        // Write the ledgers to a legacy database on disk
+        beast::temp_dir const dir;
+        auto setup = setup_DatabaseCon(env.app().config());
+        setup.standAlone = false;
+        setup.dataDir = dir.path();
+
+        DatabaseCon lgrDB(setup, LgrDBName, LgrDBPragma, LgrDBInit);
+        auto txDB = std::make_unique<DatabaseCon>(
+            setup, TxDBName, TxDBPragma, TxDBInit);
+        // As the server keeps it by default
+        txDB->getSession() << "PRAGMA journal_mode=WAL;";
+
+        auto save = [&]() {
+            std::vector<std::shared_ptr<Ledger const>> ledgers;
+            for (; saved <= env.closed()->info().seq; ++saved)
+                ledgers.push_back(
+                    env.app().getLedgerMaster().getLedgerBySeq(saved));
+            if (!BEAST_EXPECT(std::all_of(
+                    ledgers.begin(), ledgers.end(), [](auto const& ledger) {
+                        return ledger != nullptr;
+                    })))
+                return;
+            auto const result = detail::saveValidatedLedgers(
+                lgrDB,
+                *txDB,
+                env.app(),
+                ledgers,
+                false,
+                detail::TxSchema::legacy);
+            BEAST_EXPECT(
+                std::find(result.begin(), result.end(), false) ==
+                result.end());
+        };
+        save();
+
+        auto const compactPath = dir.file(TxDBMigrationName);
+        auto checkCopy = [&]() {
+            soci::session compact;
+            open(compact, "sqlite", compactPath);
+            compare(env, txDB->getSession(), compact, accounts);
+        };
+
+        // The copy can be made while the database is in use
+        BEAST_EXPECT(doMigrateTxDB(setup, false));
+        checkCopy();
+
+        // Copying again picks up ledgers saved since, and ledgers whose
+        // transactions were deleted
+        auto const deleted = saved - 1;
+        detail::deleteByLedgerSeq(
+            txDB->getSession(),
+            detail::TableType::AccountTransactions,
+            deleted);
+        detail::deleteByLedgerSeq(
+            txDB->getSession(), detail::TableType::Transactions, deleted);
+        pay(3);
+        save();
+        BEAST_EXPECT(doMigrateTxDB(setup, false));
+        checkCopy();
+
+        // The database is only replaced once it is no longer in use
+        BEAST_EXPECT(!doMigrateTxDB(setup, true));
+        BEAST_EXPECT(boost::filesystem::exists(compactPath));
+
+        txDB.reset();
+        BEAST_EXPECT(doMigrateTxDB(setup, true));
+        BEAST_EXPECT(!boost::filesystem::exists(compactPath));
+        {
+            soci::session legacy;
+            open(
+                legacy,
+                "sqlite",
+                dir.file(std::string(TxDBName) + ".legacy"));
+            soci::session compact;
+            open(compact, "sqlite", dir.file(TxDBName));
+            compare(env, legacy, compact, accounts);
+        }
+
+        // Once migrated, there is nothing left to do
+        BEAST_EXPECT(doMigrateTxDB(setup, false));
+        BEAST_EXPECT(!boost::filesystem::exists(compactPath));
+    }
+
+public:
+    void
+    run() override
+    {
+        testMigrate();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(MigrateTxDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
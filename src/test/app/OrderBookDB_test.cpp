@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/core/JobQueue.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    // Close a ledger and wait for it to be published
+    static void
+    close(jtx::Env& env)
+    {
+        env.close();
+        env.app().getJobQueue().rendezvous();
+    }
+
+    static bool
+    hasBook(jtx::Env& env, Issue const& in, Issue const& out)
+    {
+        for (auto const& book :
+             env.app().getOrderBookDB().getBooksByTakerPays(in))
+        {
+            if (book.out == out)
+                return true;
+        }
+        return false;
+    }
+
+    void
+    testIncremental()
+    {
+        testcase("Incremental maintenance");
+
+        using namespace jtx;
+
+        Env env{*this};
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env(trust(alice, USD(1000)));
+        env(pay(gw, alice, USD(500)));
+        close(env);
+
+        auto& db = env.app().getOrderBookDB();
+        BEAST_EXPECT(!hasBook(env, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // Two qualities in the XRP -> USD book
+        auto const seq1 = env.seq(alice);
+        env(offer(alice, XRP(100), USD(10)));
+        auto const seq2 = env.seq(alice);
+        env(offer(alice, XRP(100), USD(20)));
+
+        // A book to XRP
+        auto const seq3 = env.seq(alice);
+        env(offer(alice, USD(10), XRP(100)));
+        close(env);
+
+        BEAST_EXPECT(hasBook(env, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        // The book remains while any of its qualities does
+        env(offer_cancel(alice, seq1));
+        close(env);
+        BEAST_EXPECT(hasBook(env, xrpIssue(), USD.issue()));
+
+        env(offer_cancel(alice, seq2));
+        env(offer_cancel(alice, seq3));
+        close(env);
+        BEAST_EXPECT(!hasBook(env, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // One quality replaced by another in the same ledger
+        auto const seq4 = env.seq(alice);
+        env(offer(alice, XRP(100), USD(10)));
+        close(env);
+        env(offer(alice, XRP(100), USD(30)));
+        env(offer_cancel(alice, seq4));
+        close(env);
+        BEAST_EXPECT(hasBook(env, xrpIssue(), USD.issue()));
+    }
+
+    void
+    testScan()
+    {
+        testcase("Scan agrees with index");
+
+        using namespace jtx;
+
+        Env env{*this};
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice);
+        env(trust(alice, USD(1000)));
+        env(trust(alice, EUR(1000)));
+        env(pay(gw, alice, USD(500)));
+        env(pay(gw, alice, EUR(500)));
+        close(env);
+
+        env(offer(alice, XRP(100), USD(10)));
+        env(offer(alice, EUR(10), USD(10)));
+        auto const seq = env.seq(alice);
+        env(offer(alice, USD(10), EUR(10)));
+        close(env);
+        env(offer_cancel(alice, seq));
+        close(env);
+
+        auto& db = env.app().getOrderBookDB();
+        auto const before = db.getBooksByTakerPays(USD.issue());
+        BEAST_EXPECT(before.empty());
+
+        db.update(env.app().getLedgerMaster().getPublishedLedger());
+
+        BEAST_EXPECT(hasBook(env, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(hasBook(env, EUR.issue(), USD.issue()));
+        BEAST_EXPECT(db.getBooksByTakerPays(USD.issue()).empty());
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testScan();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
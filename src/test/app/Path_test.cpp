@@ -18,6 +18,9 @@
 //==============================================================================
 
 #include <ripple/app/paths/AccountCurrencies.h>
+#include <ripple/app/paths/PathRequests.h>
+#include <ripple/app/paths/PathfinderCache.h>
+#include <ripple/app/paths/TrustLineGraph.h>
 #include <ripple/basics/contract.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
@@ -36,6 +39,7 @@
 #include <mutex>
 #include <test/jtx.h>
 #include <test/jtx/envconfig.h>
+#include <test/shamap/common.h>
 #include <thread>
 
 namespace ripple {
@@ -478,6 +482,256 @@ public:
         BEAST_EXPECT(equal(sa, Account("alice")["USD"](5)));
     }
 
+    void
+    path_find_shared()
+    {
+        testcase("path find shared");
+        using namespace jtx;
+        Env env = pathTestEnv();
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.trust(USD(600), "alice");
+        env.trust(USD(700), "bob");
+        env(pay(gw, "alice", USD(70)));
+        env(pay(gw, "bob", USD(50)));
+        env.close();
+
+        {
+            auto const cache = std::make_shared<RippleLineCache>(
+                env.current(), env.app().journal("RippleLineCache"));
+            PathfinderCache pathfinders(cache, env.app());
+            auto get = [&](STAmount const& amount, int level) {
+                return pathfinders.getPathfinder(
+                    Account("alice"),
+                    Account("bob"),
+                    USD.currency,
+                    amount,
+                    std::nullopt,
+                    level,
+                    4,
+                    {});
+            };
+
+            auto const pathfinder = get(Account("bob")["USD"](5), 7);
+            BEAST_EXPECT(pathfinder);
+            BEAST_EXPECT(get(Account("bob")["USD"](5), 7) == pathfinder);
+            BEAST_EXPECT(pathfinders.size() == 1);
+            BEAST_EXPECT(get(Account("bob")["USD"](6), 7) != pathfinder);
+            BEAST_EXPECT(get(Account("bob")["USD"](5), 4) != pathfinder);
+            BEAST_EXPECT(pathfinders.size() == 3);
+
+            if (pathfinder)
+            {
+                STPath fullLiquidityPath;
+                auto const paths = pathfinder->getBestPaths(
+                    4, fullLiquidityPath, {}, Account("alice"));
+                BEAST_EXPECT(same(paths, stpath("gateway")));
+            }
+        }
+
+        // Legacy requests each build their own pathfinders, so identical
+        // requests made at once must still find the same paths.
+        std::vector<std::tuple<STPathSet, STAmount, STAmount>> results(4);
+        std::vector<std::thread> threads;
+        for (auto& result : results)
+            threads.emplace_back([&] {
+                result =
+                    find_paths(env, "alice", "bob", Account("bob")["USD"](5));
+            });
+        for (auto& thread : threads)
+            thread.join();
+        for (auto const& [st, sa, da] : results)
+        {
+            BEAST_EXPECT(same(st, stpath("gateway")));
+            BEAST_EXPECT(equal(sa, Account("alice")["USD"](5)));
+        }
+    }
+
+    void
+    trust_line_graph()
+    {
+        testcase("trust line graph");
+        using namespace jtx;
+        Env env = pathTestEnv();
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const carol("carol");
+        env.fund(XRP(10000), alice, bob, carol, gw);
+        env.trust(USD(600), alice);
+        env.trust(USD(700), bob);
+        env(trust(carol, EUR(100), tfSetNoRipple));
+        env(pay(gw, alice, USD(70)));
+        env.close();
+
+        // The graph holds the lines that would be read from the ledger
+        auto checkLines = [&](TrustLineGraph const& graph) {
+            auto const& ledger = *graph.getLedger();
+            for (auto const& account : {alice, bob, carol, gw})
+            {
+                for (auto const direction :
+                     {LineDirection::incoming, LineDirection::outgoing})
+                {
+                    auto const lines = graph.getItems(account, direction);
+                    auto const expected =
+                        PathFindTrustLine::getItems(account, ledger, direction);
+                    if (!BEAST_EXPECT(lines.size() == expected.size()))
+                        continue;
+                    for (auto const& line : lines)
+                    {
+                        auto const it = std::find_if(
+                            expected.begin(),
+                            expected.end(),
+                            [&line](auto const& other) {
+                                return other.key() == line.key();
+                            });
+                        if (!BEAST_EXPECT(it != expected.end()))
+                            continue;
+                        auto const& other = *it;
+                        BEAST_EXPECT(line.getAccountID() == account.id());
+                        BEAST_EXPECT(
+                            line.getAccountIDPeer() ==
+                            other.getAccountIDPeer());
+                        BEAST_EXPECT(line.getBalance() == other.getBalance());
+                        BEAST_EXPECT(line.getLimit() == other.getLimit());
+                        BEAST_EXPECT(
+                            line.getLimitPeer() == other.getLimitPeer());
+                        BEAST_EXPECT(line.getNoRipple() == other.getNoRipple());
+                        BEAST_EXPECT(
+                            line.getNoRipplePeer() == other.getNoRipplePeer());
+                        BEAST_EXPECT(line.getAuth() == other.getAuth());
+                        BEAST_EXPECT(line.getFreeze() == other.getFreeze());
+                    }
+                }
+            }
+        };
+
+        auto const first =
+            std::dynamic_pointer_cast<Ledger const>(env.closed());
+        if (!BEAST_EXPECT(first))
+            return;
+        auto const graph = TrustLineGraph::make(first);
+        BEAST_EXPECT(graph->size() == 3);
+        BEAST_EXPECT(graph->getItems(gw, LineDirection::outgoing).size() == 3);
+        BEAST_EXPECT(graph->getItems(carol, LineDirection::incoming).empty());
+        checkLines(*graph);
+
+        // Change a balance, add a line and remove one
+        env(pay(alice, bob, USD(20)));
+        env(trust(carol, EUR(0)));
+        env.trust(EUR(50), alice);
+        env.close();
+
+        auto const second =
+            std::dynamic_pointer_cast<Ledger const>(env.closed());
+        if (!BEAST_EXPECT(second))
+            return;
+        BEAST_EXPECT(!graph->update(second, 1));
+        auto const next = graph->update(second, 1000);
+        if (!BEAST_EXPECT(next))
+            return;
+        BEAST_EXPECT(next->getLedger() == second);
+        BEAST_EXPECT(next->size() == 3);
+        BEAST_EXPECT(next->getItems(carol, LineDirection::outgoing).empty());
+        BEAST_EXPECT(
+            next->getItems(alice, LineDirection::outgoing).size() == 2);
+        checkLines(*next);
+
+        // The original graph is unchanged
+        checkLines(*graph);
+
+        // Paths are found from the graph
+        auto const cache = std::make_shared<RippleLineCache>(
+            second, env.app().journal("RippleLineCache"), next);
+        PathfinderCache pathfinders(cache, env.app());
+        auto const pathfinder = pathfinders.getPathfinder(
+            alice, bob, USD.currency, bob["USD"](5), std::nullopt, 7, 4, {});
+        if (BEAST_EXPECT(pathfinder))
+        {
+            STPath fullLiquidityPath;
+            auto const paths =
+                pathfinder->getBestPaths(4, fullLiquidityPath, {}, alice);
+            BEAST_EXPECT(same(paths, stpath("gateway")));
+        }
+    }
+
+    void
+    trust_line_graph_missing_nodes()
+    {
+        testcase("trust line graph missing nodes");
+        using namespace jtx;
+        Env env = pathTestEnv();
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.trust(USD(600), "alice");
+        env.close();
+
+        auto& pathRequests = env.app().getPathRequests();
+        auto& jobQueue = env.app().getJobQueue();
+
+        // The first graph is built by a job
+        auto const first =
+            std::dynamic_pointer_cast<Ledger const>(env.closed());
+        if (!BEAST_EXPECT(first))
+            return;
+        pathRequests.updateGraph(first);
+        jobQueue.rendezvous();
+        BEAST_EXPECT(pathRequests.getGraph(*first));
+
+        env.trust(USD(700), "bob");
+        env(pay(gw, "alice", USD(70)));
+        env.close();
+        auto const second =
+            std::dynamic_pointer_cast<Ledger const>(env.closed());
+        if (!BEAST_EXPECT(second))
+            return;
+
+        // A ledger whose state holds only the root node
+        tests::TestNodeFamily family(env.app().journal("PathRequests"));
+        second->stateMap().visitNodes([&](SHAMapTreeNode& node) {
+            if (node.getHash() == second->stateMap().getHash())
+            {
+                Serializer s;
+                node.serializeWithPrefix(s);
+                family.db().store(
+                    hotACCOUNT_NODE,
+                    std::move(s.modData()),
+                    node.getHash().as_uint256(),
+                    second->seq());
+            }
+            return true;
+        });
+        auto info = second->info();
+        info.txHash.zero();
+        bool loaded;
+        auto const incomplete = std::make_shared<Ledger const>(
+            info,
+            loaded,
+            false,
+            env.app().config(),
+            family,
+            env.app().journal("Ledger"));
+
+        // The graph can't be updated to that ledger, nor built from it,
+        // so lines are read from the ledger instead
+        pathRequests.updateGraph(incomplete);
+        jobQueue.rendezvous();
+        BEAST_EXPECT(!pathRequests.getGraph(*first));
+        BEAST_EXPECT(!pathRequests.getGraph(*incomplete));
+        BEAST_EXPECT(!pathRequests.graphPending_);
+
+        // The graph is built again for the next complete ledger
+        pathRequests.updateGraph(second);
+        jobQueue.rendezvous();
+        auto const graph = pathRequests.getGraph(*second);
+        if (BEAST_EXPECT(graph))
+            BEAST_EXPECT(graph->size() == 2);
+    }
+
     void
     xrp_to_xrp()
     {
@@ -1449,6 +1703,9 @@ public:
         direct_path_no_intermediary();
         payment_auto_path_find();
         path_find();
+        path_find_shared();
+        trust_line_graph();
+        trust_line_graph_missing_nodes();
         path_find_consume_all();
         alternative_path_consume_both();
         alternative_paths_consume_best_transfer();
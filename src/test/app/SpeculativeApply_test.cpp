@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class SpeculativeApply_test : public beast::unit_test::suite
+{
+    // Build a ledger from the transactions of the open ledger
+    std::shared_ptr<Ledger>
+    build(jtx::Env& env, int workers, std::set<TxID>& failed)
+    {
+        auto& app = env.app();
+        auto const parent = app.getLedgerMaster().getClosedLedger();
+
+        CanonicalTXSet txns(parent->info().hash);
+        for (auto const& [tx, meta] : env.current()->txs)
+            txns.insert(tx);
+
+        app.config().LEDGER_APPLY_WORKERS = workers;
+        return buildLedger(
+            parent,
+            parent->info().closeTime + parent->info().closeTimeResolution,
+            true,
+            parent->info().closeTimeResolution,
+            app,
+            txns,
+            failed,
+            env.journal);
+    }
+
+    void
+    testIdentical()
+    {
+        testcase("Identical to serial application");
+
+        using namespace jtx;
+
+        Env env(*this);
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+
+        std::vector<Account> accounts;
+        for (int i = 0; i < 24; ++i)
+            accounts.emplace_back("a" + std::to_string(i));
+
+        env.fund(XRP(100000), gw);
+        for (int i = 0; i < 16; ++i)
+            env.fund(XRP(10000), accounts[i]);
+        env.close();
+
+        for (int i = 0; i < 16; ++i)
+            env.trust(USD(10000), accounts[i]);
+        env.close();
+        for (int i = 0; i < 16; ++i)
+            env(pay(gw, accounts[i], USD(1000)));
+        env.close();
+
+        // Payments between disjoint pairs of accounts
+        for (int i = 0; i < 8; i += 2)
+            env(pay(accounts[i], accounts[i + 1], XRP(10)));
+
+        // Several transactions from one account, which must be applied in
+        // sequence order
+        for (int i = 0; i < 4; ++i)
+            env(pay(accounts[8], accounts[9 + i], XRP(1 + i)));
+
+        // Offers crossing in the same book
+        env(offer(accounts[13], XRP(100), USD(10)));
+        env(offer(accounts[14], USD(10), XRP(100)));
+        env(offer(accounts[15], XRP(50), USD(5)));
+
+        // New accounts that transact in the same ledger. Those ordered
+        // before their funding payment must be retried in a later pass.
+        for (int i = 16; i < 24; ++i)
+        {
+            env(pay(env.master, accounts[i], XRP(1000)));
+            env(noop(accounts[i]));
+        }
+
+        // A payment that cannot be made
+        env(pay(accounts[0], accounts[1], USD(100000)),
+            ter(tecPATH_PARTIAL));
+
+        std::set<TxID> serialFailed;
+        auto const serial = build(env, 1, serialFailed);
+
+        for (int workers : {2, 4, 16})
+        {
+            std::set<TxID> failed;
+            auto const parallel = build(env, workers, failed);
+
+            BEAST_EXPECT(parallel->info().hash == serial->info().hash);
+            BEAST_EXPECT(
+                parallel->info().accountHash == serial->info().accountHash);
+            BEAST_EXPECT(parallel->info().txHash == serial->info().txHash);
+            BEAST_EXPECT(failed == serialFailed);
+        }
+
+        // Every transaction made it into the ledger
+        std::size_t count = 0;
+        for (auto const& tx : serial->txs)
+        {
+            (void)tx;
+            ++count;
+        }
+        BEAST_EXPECT(count == env.current()->txCount());
+    }
+
+public:
+    void
+    run() override
+    {
+        testIdentical();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SpeculativeApply, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -1043,6 +1043,65 @@ public:
         }
     }
 
+    void
+    testLedgerPhases()
+    {
+        // Exercise the ledger phase histograms of PerfLog.
+        Fixture fixture{env_.app(), j_};
+        auto perfLog{fixture.perfLog(WithFile::no)};
+        perfLog->start();
+
+        using namespace std::chrono;
+        using perf::LedgerPhase;
+
+        // Every phase is reported, even before it has been timed.
+        {
+            Json::Value const phases{perfLog->ledgerPhasesJson()};
+            BEAST_EXPECT(phases.size() == perf::ledgerPhaseCount);
+            for (std::size_t i = 0; i < perf::ledgerPhaseCount; ++i)
+            {
+                Json::Value const& phase{
+                    phases[perf::ledgerPhaseName(static_cast<LedgerPhase>(i))]};
+                BEAST_EXPECT(phase[jss::count] == "0");
+                BEAST_EXPECT(phase[jss::p99_us] == "0");
+            }
+        }
+
+        // 1..100 milliseconds, so each percentile is known.
+        for (int ms = 1; ms <= 100; ++ms)
+            perfLog->ledgerPhase(LedgerPhase::build, milliseconds{ms});
+        perfLog->ledgerPhase(LedgerPhase::save, microseconds{3});
+        perfLog->ledgerPhase(LedgerPhase::save, microseconds{0});
+
+        // A percentile is estimated within a quarter of its value.
+        auto const near = [](Json::Value const& value, std::uint64_t us) {
+            auto const estimate = jsonToUint64(value);
+            return estimate >= us && estimate <= us + us / 4;
+        };
+
+        Json::Value const phases{perfLog->countersJson()[jss::ledger_phases]};
+        {
+            Json::Value const& build{phases["build_ledger"]};
+            BEAST_EXPECT(build[jss::count] == "100");
+            BEAST_EXPECT(build[jss::duration_us] == "5050000");
+            BEAST_EXPECT(build[jss::max_us] == "100000");
+            BEAST_EXPECT(near(build[jss::p50_us], 50000));
+            BEAST_EXPECT(near(build[jss::p90_us], 90000));
+            // but never above the largest duration seen.
+            BEAST_EXPECT(build[jss::p99_us] == "100000");
+        }
+        {
+            // Small durations are counted exactly.
+            Json::Value const& save{phases["save_validated_ledger"]};
+            BEAST_EXPECT(save[jss::count] == "2");
+            BEAST_EXPECT(save[jss::p50_us] == "0");
+            BEAST_EXPECT(save[jss::p99_us] == "3");
+        }
+        BEAST_EXPECT(phases["pub_ledger"][jss::count] == "0");
+
+        perfLog->stop();
+    }
+
     void
     run() override
     {
@@ -1055,6 +1114,7 @@ public:
         testInvalidID(WithFile::yes);
         testRotate(WithFile::no);
         testRotate(WithFile::yes);
+        testLedgerPhases();
     }
 };
 
@@ -18,11 +18,20 @@
 //==============================================================================
 
 #include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/base_uint.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/clock/manual_clock.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/rfc2616.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/rngfill.h>
+#include <ripple/beast/xor_shift_engine.h>
 #include <ripple/protocol/Protocol.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 
@@ -40,8 +49,10 @@ class TaggedCache_test : public beast::unit_test::suite
 {
 public:
     void
-    run() override
+    testCache(bool partitioned)
     {
+        testcase(partitioned ? "partitioned locking" : "single lock");
+
         using namespace std::chrono_literals;
         using namespace beast::severities;
         test::SuiteJournal journal("TaggedCache_test", *this);
@@ -53,7 +64,15 @@ public:
         using Value = std::string;
         using Cache = TaggedCache<Key, Value>;
 
-        Cache c("test", 1, 1s, clock, journal);
+        Cache c(
+            "test",
+            1,
+            1s,
+            clock,
+            journal,
+            beast::insight::NullCollector::New(),
+            partitioned);
+        BEAST_EXPECT(c.partitionedLocking() == partitioned);
 
         // Insert an item, retrieve it, and age it so it gets purged.
         {
@@ -149,8 +168,193 @@ public:
             BEAST_EXPECT(c.getTrackSize() == 0);
         }
     }
+
+    void
+    testConcurrentAccess()
+    {
+        testcase("concurrent access");
+
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCache_test", *this);
+
+        TestStopwatch clock;
+        clock.set(0);
+
+        using Cache = TaggedCache<LedgerIndex, std::string>;
+        Cache c(
+            "test",
+            0,
+            1s,
+            clock,
+            journal,
+            beast::insight::NullCollector::New(),
+            true);
+
+        // Threads canonicalize overlapping keys while another sweeps; every
+        // thread must end up sharing the same object for each key.
+        constexpr LedgerIndex keys = 1000;
+        constexpr int threads = 4;
+        std::vector<std::vector<std::shared_ptr<std::string>>> seen(threads);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                for (LedgerIndex k = 0; k < keys; ++k)
+                {
+                    auto p = std::make_shared<std::string>(std::to_string(k));
+                    c.canonicalize_replace_client(k, p);
+                    seen[t].push_back(std::move(p));
+                }
+            });
+        }
+        std::thread sweeper([&]() {
+            for (int i = 0; i < 10; ++i)
+                c.sweep();
+        });
+        for (auto& worker : workers)
+            worker.join();
+        sweeper.join();
+
+        bool same = true;
+        for (int t = 1; t < threads; ++t)
+        {
+            for (LedgerIndex k = 0; k < keys; ++k)
+                same = same && seen[t][k].get() == seen[0][k].get();
+        }
+        BEAST_EXPECT(same);
+        BEAST_EXPECT(c.getTrackSize() == keys);
+        BEAST_EXPECT(c.getKeys().size() == keys);
+
+        seen.clear();
+        ++clock;
+        c.sweep();
+        BEAST_EXPECT(c.getCacheSize() == 0);
+        BEAST_EXPECT(c.getTrackSize() == 0);
+    }
+
+    void
+    run() override
+    {
+        testCache(false);
+        testCache(true);
+        testConcurrentAccess();
+    }
+};
+
+/** Measures how cache hits per second scale with the number of threads.
+
+    Each thread repeatedly fetches random keys from a fully populated cache
+    while a separate thread sweeps it, once with the single cache lock and
+    once with partitioned locking. Pass a comma separated list of thread
+    counts as the argument to override the default.
+*/
+class TaggedCacheContention_test : public beast::unit_test::suite
+{
+    using Cache = TaggedCache<uint256, std::string>;
+
+    static constexpr std::size_t keyCount = 100000;
+    static constexpr std::chrono::milliseconds duration{1000};
+
+    double
+    hitsPerSecond(std::vector<uint256> const& keys, int threads, bool partitioned)
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCacheContention_test", *this);
+
+        Cache c(
+            "bench",
+            0,
+            1h,
+            stopwatch(),
+            journal,
+            beast::insight::NullCollector::New(),
+            partitioned);
+        for (auto const& key : keys)
+            c.insert(key, "value");
+
+        std::atomic<bool> stop = false;
+        std::atomic<std::uint64_t> hits = 0;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                std::uint64_t local = 0;
+                std::size_t i = t * (keys.size() / threads);
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    if (c.fetch(keys[i]))
+                        ++local;
+                    if (++i == keys.size())
+                        i = 0;
+                }
+                hits += local;
+            });
+        }
+        std::thread sweeper([&]() {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                c.sweep();
+                std::this_thread::sleep_for(100ms);
+            }
+        });
+
+        auto const start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (auto& worker : workers)
+            worker.join();
+        sweeper.join();
+        auto const elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start);
+
+        return hits / elapsed.count();
+    }
+
+public:
+    void
+    run() override
+    {
+        std::vector<int> threadCounts;
+        if (arg().empty())
+        {
+            for (int t = 1; t <= std::thread::hardware_concurrency(); t *= 2)
+                threadCounts.push_back(t);
+        }
+        else
+        {
+            for (auto const& t : beast::rfc2616::split_commas(arg()))
+                threadCounts.push_back(beast::lexicalCastThrow<int>(t));
+        }
+
+        beast::xor_shift_engine rng(42);
+        std::vector<uint256> keys;
+        keys.reserve(keyCount);
+        for (std::size_t i = 0; i < keyCount; ++i)
+        {
+            uint256 key;
+            beast::rngfill(key.begin(), key.size(), rng);
+            keys.push_back(key);
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        for (bool const partitioned : {false, true})
+        {
+            testcase(partitioned ? "partitioned locking" : "single lock");
+            for (auto const threads : threadCounts)
+            {
+                auto const rate = hitsPerSecond(keys, threads, partitioned);
+                log << threads << " thread" << (threads > 1 ? "s" : "")
+                    << ": " << static_cast<std::uint64_t>(rate)
+                    << " hits/s, "
+                    << static_cast<std::uint64_t>(rate / threads)
+                    << " hits/s per thread" << std::endl;
+            }
+            pass();
+        }
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(TaggedCache, common, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TaggedCacheContention, common, ripple);
 
 }  // namespace ripple
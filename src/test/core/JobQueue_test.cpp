@@ -17,9 +17,18 @@
 */
 //==============================================================================
 
+#include <ripple/basics/PerfLog.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/beast/rfc2616.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
 #include <test/jtx/Env.h>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 
 namespace ripple {
 namespace test {
@@ -28,10 +37,27 @@ namespace test {
 
 class JobQueue_test : public beast::unit_test::suite
 {
+    static std::unique_ptr<Config>
+    makeConfig(bool lockFree)
+    {
+        return jtx::envconfig([lockFree](std::unique_ptr<Config> cfg) {
+            cfg->LOCKFREE_JOB_QUEUE = lockFree;
+            return cfg;
+        });
+    }
+
+    static std::string
+    scheduler(bool lockFree)
+    {
+        return lockFree ? " lock-free" : "";
+    }
+
     void
-    testAddJob()
+    testAddJob(bool lockFree)
     {
-        jtx::Env env{*this};
+        testcase("addJob" + scheduler(lockFree));
+
+        jtx::Env env{*this, makeConfig(lockFree)};
 
         JobQueue& jQueue = env.app().getJobQueue();
         {
@@ -64,9 +90,11 @@ class JobQueue_test : public beast::unit_test::suite
     }
 
     void
-    testPostCoro()
+    testPostCoro(bool lockFree)
     {
-        jtx::Env env{*this};
+        testcase("postCoro" + scheduler(lockFree));
+
+        jtx::Env env{*this, makeConfig(lockFree)};
 
         JobQueue& jQueue = env.app().getJobQueue();
         {
@@ -149,16 +177,206 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testPriority(bool lockFree)
+    {
+        testcase("priority" + scheduler(lockFree));
+
+        jtx::Env env{*this};
+        JobQueue jq(
+            1,
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog(),
+            lockFree);
+
+        // Occupy the only worker so that the jobs below queue up
+        std::promise<void> release;
+        std::shared_future<void> hold = release.get_future();
+        std::atomic<bool> held{false};
+        jq.addJob(jtCLIENT, "hold", [&held, hold]() {
+            held = true;
+            hold.wait();
+        });
+        while (!held)
+            ;
+
+        std::mutex m;
+        std::vector<std::string> order;
+        auto add = [&](JobType type, std::string const& name) {
+            jq.addJob(type, name, [&m, &order, name]() {
+                std::lock_guard lock(m);
+                order.push_back(name);
+            });
+        };
+        add(jtCLIENT, "client1");
+        add(jtLEDGER_DATA, "ledgerData1");
+        add(jtTRANSACTION, "transaction1");
+        add(jtCLIENT, "client2");
+        add(jtTRANSACTION, "transaction2");
+        add(jtLEDGER_DATA, "ledgerData2");
+
+        BEAST_EXPECT(jq.getJobCount(jtTRANSACTION) == 2);
+        BEAST_EXPECT(jq.getJobCountGE(jtTRANSACTION) == 4);
+
+        release.set_value();
+        jq.rendezvous();
+
+        std::vector<std::string> const expected{
+            "ledgerData1",
+            "ledgerData2",
+            "transaction1",
+            "transaction2",
+            "client1",
+            "client2"};
+        BEAST_EXPECT(order == expected);
+        jq.stop();
+    }
+
+    void
+    testLimits(bool lockFree)
+    {
+        testcase("limits" + scheduler(lockFree));
+
+        using namespace std::chrono_literals;
+        jtx::Env env{*this};
+        JobQueue jq(
+            8,
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog(),
+            lockFree);
+
+        // jtLEDGER_REQ may have at most 3 jobs running at once
+        int const limit = JobTypes::instance().get(jtLEDGER_REQ).limit();
+        std::atomic<int> running{0};
+        std::atomic<int> peak{0};
+        std::atomic<int> ran{0};
+        for (int i = 0; i < 24; ++i)
+        {
+            jq.addJob(jtLEDGER_REQ, "limited", [&]() {
+                int const now = ++running;
+                int prev = peak.load();
+                while (prev < now && !peak.compare_exchange_weak(prev, now))
+                    ;
+                std::this_thread::sleep_for(2ms);
+                --running;
+                ++ran;
+            });
+        }
+
+        // Jobs added concurrently, of types with and without limits, must
+        // all run.
+        JobType const types[] = {
+            jtCLIENT, jtTRANSACTION, jtLEDGER_DATA, jtLEDGER_REQ};
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t)
+        {
+            producers.emplace_back([&jq, &ran, &types]() {
+                for (int i = 0; i < 2500; ++i)
+                    jq.addJob(types[i % 4], "mixed", [&ran]() { ++ran; });
+            });
+        }
+        for (auto& producer : producers)
+            producer.join();
+
+        jq.rendezvous();
+        BEAST_EXPECT(ran == 24 + 4 * 2500);
+        BEAST_EXPECT(peak <= limit);
+        BEAST_EXPECT(jq.getJobCountTotal(jtLEDGER_REQ) == 0);
+        jq.stop();
+    }
+
 public:
     void
     run() override
     {
-        testAddJob();
-        testPostCoro();
+        for (bool const lockFree : {false, true})
+        {
+            testAddJob(lockFree);
+            testPostCoro(lockFree);
+            testPriority(lockFree);
+            testLimits(lockFree);
+        }
+    }
+};
+
+// Measures the rate at which the JobQueue runs trivial jobs added by
+// several threads at once, with each scheduler. The argument is an
+// optional comma separated list of producer thread counts.
+class JobQueueThroughput_test : public beast::unit_test::suite
+{
+    static constexpr int jobsPerProducer = 100000;
+
+    double
+    jobsPerSecond(int producers, bool lockFree)
+    {
+        jtx::Env env{*this};
+        JobQueue jq(
+            static_cast<int>(std::thread::hardware_concurrency()),
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog(),
+            lockFree);
+
+        // The job types that arrive in floods of peer traffic
+        JobType const types[] = {
+            jtTRANSACTION, jtVALIDATION_ut, jtPROPOSAL_ut, jtLEDGER_DATA};
+
+        std::atomic<int> ran{0};
+        auto const start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&jq, &ran, &types]() {
+                for (int i = 0; i < jobsPerProducer; ++i)
+                    jq.addJob(types[i % 4], "bench", [&ran]() { ++ran; });
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        jq.rendezvous();
+        auto const elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start);
+
+        BEAST_EXPECT(ran == producers * jobsPerProducer);
+        jq.stop();
+        return ran / elapsed.count();
+    }
+
+public:
+    void
+    run() override
+    {
+        std::vector<int> producerCounts{1, 2, 4, 8};
+        if (!arg().empty())
+        {
+            producerCounts.clear();
+            for (auto const& p : beast::rfc2616::split_commas(arg()))
+                producerCounts.push_back(beast::lexicalCastThrow<int>(p));
+        }
+
+        testcase("throughput");
+        log << std::left << std::setw(10) << "Producers" << std::right
+            << std::setw(14) << "Locked" << std::setw(14) << "Lock-free"
+            << "  (jobs/s)" << std::endl;
+        for (int const producers : producerCounts)
+        {
+            std::stringstream ss;
+            ss << std::left << std::setw(10) << producers << std::right
+               << std::fixed << std::setprecision(0) << std::setw(14)
+               << jobsPerSecond(producers, false) << std::setw(14)
+               << jobsPerSecond(producers, true);
+            log << ss.str() << std::endl;
+        }
     }
 };
 
 BEAST_DEFINE_TESTSUITE(JobQueue, core, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueueThroughput, core, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -74,6 +74,18 @@ class PerfLogTest : public PerfLog
     {
     }
 
+    void
+    ledgerPhase(LedgerPhase const phase, std::chrono::microseconds dur)
+        override
+    {
+    }
+
+    Json::Value
+    ledgerPhasesJson() const override
+    {
+        return Json::Value();
+    }
+
     Json::Value
     countersJson() const override
     {
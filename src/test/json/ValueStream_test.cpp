@@ -0,0 +1,314 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/ValueStream.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/server/impl/JSONRPCUtil.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace Json {
+
+// A value shaped like a ledger_data response
+static Value
+makeState(int count)
+{
+    Value result(objectValue);
+    result["ledger_index"] = 75000000u;
+    result["validated"] = true;
+    auto& state = result["state"] = Value(arrayValue);
+    for (int i = 0; i < count; ++i)
+    {
+        Value entry(objectValue);
+        entry["Account"] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        entry["Balance"] = std::to_string(1000000000 + i);
+        entry["Flags"] = 0u;
+        entry["LedgerEntryType"] = "AccountRoot";
+        entry["OwnerCount"] = i % 17;
+        entry["PreviousTxnID"] =
+            "C3D0A6B1E27F41B8C3D0A6B1E27F41B8C3D0A6B1E27F41B8C3D0A6B1E27F"
+            "41B8";
+        entry["PreviousTxnLgrSeq"] = 74999000u + i;
+        entry["Sequence"] = i + 1;
+        entry["index"] =
+            "13F1A95D7AAB7108D5CE7EEAF504B2894B8C674E6D68499076441C4837282"
+            "BF8";
+        entry["Rate"] = 1.5 + i;
+        state.append(std::move(entry));
+    }
+    return result;
+}
+
+class ValueStream_test : public beast::unit_test::suite
+{
+    static Value
+    parse(std::string const& s)
+    {
+        Value v;
+        Reader().parse(s, v);
+        return v;
+    }
+
+    static std::string
+    streamed(Value v, std::size_t bytes)
+    {
+        std::string s;
+        ValueStream stream(std::move(v));
+        while (!stream.write(stringOutput(s), bytes))
+            ;
+        return s;
+    }
+
+    void
+    testValues()
+    {
+        testcase("Values");
+
+        std::string const descs[] = {
+            "null",
+            "true",
+            "-12",
+            "4.25",
+            "\"string with \\\"quotes\\\" and \\n\"",
+            "{}",
+            "[]",
+            "[23,4.25,true,null,\"string\"]",
+            "{\"hello\":\"world\"}",
+            "[{}]",
+            "[[]]",
+            "{\"array\":[{\"12\":23},{},null,false,0.5],"
+            "\"b\":{\"c\":[[1],[]]}}",
+        };
+
+        for (auto const& desc : descs)
+        {
+            auto const value = parse(desc);
+            auto const expected = to_string(value);
+            for (std::size_t bytes : {1, 3, 16, 1000000})
+                BEAST_EXPECTS(streamed(value, bytes) == expected, desc);
+        }
+
+        // A sparse array has nulls for its missing elements
+        {
+            Value v(arrayValue);
+            v[4u] = 7;
+            BEAST_EXPECT(streamed(v, 1) == to_string(v));
+        }
+
+        {
+            auto const v = makeState(100);
+            auto const expected = to_string(v);
+            for (std::size_t bytes : {1, 100, 4096, 1000000})
+                BEAST_EXPECT(streamed(v, bytes) == expected);
+        }
+
+        // Every call makes progress, and stops soon after the limit
+        {
+            ValueStream stream(makeState(50));
+            std::string s;
+            while (!stream.done())
+            {
+                auto const before = s.size();
+                stream.write(stringOutput(s), 512);
+                BEAST_EXPECT(s.size() > before);
+                BEAST_EXPECT(stream.done() || s.size() - before >= 512);
+                BEAST_EXPECT(s.size() - before < 1024);
+            }
+            BEAST_EXPECT(stream.write(stringOutput(s), 512));
+        }
+    }
+
+    void
+    testChunkedReply()
+    {
+        testcase("Chunked reply");
+
+        auto const value = makeState(40);
+        auto const json = to_string(value);
+
+        std::string prefix;
+        ValueStream stream{Value(value)};
+        stream.write(stringOutput(prefix), 1000);
+
+        std::string wire;
+        auto const size =
+            ripple::HTTPChunkedReply(200, prefix, stream, 300, [&](auto s) {
+                wire.append(s.data(), s.size());
+            });
+        BEAST_EXPECT(stream.done());
+        BEAST_EXPECT(size == json.size());
+
+        auto const head = wire.find("\r\n\r\n");
+        if (!BEAST_EXPECT(head != std::string::npos))
+            return;
+        BEAST_EXPECT(wire.substr(0, 17) == "HTTP/1.1 200 OK\r\n");
+        BEAST_EXPECT(
+            wire.substr(0, head).find("Transfer-Encoding: chunked") !=
+            std::string::npos);
+
+        // Decode the chunks
+        std::string body;
+        std::size_t pos = head + 4;
+        bool last = false;
+        while (!last && pos < wire.size())
+        {
+            auto const eol = wire.find("\r\n", pos);
+            auto const size =
+                std::stoul(wire.substr(pos, eol - pos), nullptr, 16);
+            pos = eol + 2;
+            body += wire.substr(pos, size);
+            pos += size;
+            BEAST_EXPECT(wire.substr(pos, 2) == "\r\n");
+            pos += 2;
+            last = size == 0;
+        }
+        BEAST_EXPECT(last && pos == wire.size());
+        BEAST_EXPECT(body == json + "\r\n");
+    }
+
+public:
+    void
+    run() override
+    {
+        testValues();
+        testChunkedReply();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Compares buffered and streamed serialization of a large response.
+
+    Reports the time until the first bytes of the response are available,
+    and on Linux the growth of peak RSS while serializing. The argument is
+    the number of ledger entries in the response.
+*/
+class ValueStreamTiming_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Peak and current resident set size in kB, or zero if unknown
+    static std::pair<std::size_t, std::size_t>
+    rss()
+    {
+        std::size_t peak = 0;
+        std::size_t current = 0;
+#if defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            std::istringstream is(line);
+            std::string key;
+            std::size_t kb;
+            if (!(is >> key >> kb))
+                continue;
+            if (key == "VmHWM:")
+                peak = kb;
+            else if (key == "VmRSS:")
+                current = kb;
+        }
+#endif
+        return {peak, current};
+    }
+
+    // Reset the peak RSS to the current RSS, where supported
+    static void
+    resetPeak()
+    {
+#if defined(__linux__)
+        std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+    }
+
+    template <class F>
+    void
+    measure(std::string const& name, int count, F&& f)
+    {
+        auto value = makeState(count);
+        resetPeak();
+        auto const before = rss().second;
+
+        auto const start = clock_type::now();
+        clock_type::time_point first;
+        std::size_t size = f(std::move(value), [&] {
+            if (first == clock_type::time_point{})
+                first = clock_type::now();
+        });
+        auto const end = clock_type::now();
+
+        auto const peak = rss().first;
+        using ms = std::chrono::duration<double, std::milli>;
+        std::stringstream ss;
+        ss << name << ": " << size / 1024 << " kB, first byte "
+           << ms(first - start).count() << " ms, total "
+           << ms(end - start).count() << " ms";
+        if (peak != 0)
+            ss << ", peak RSS +" << (peak > before ? peak - before : 0)
+               << " kB";
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        int count = 200000;
+        if (!arg().empty())
+            count = std::stoi(arg());
+
+        testcase("Serialize " + std::to_string(count) + " entries");
+
+        // As before: the whole reply is serialized into a string, which
+        // is then copied to the session's write buffers.
+        measure("buffered", count, [](Value value, auto&& onFirst) {
+            auto const s = to_string(value);
+            value = Value();
+            std::string out = s + "\n";
+            onFirst();
+            return out.size();
+        });
+
+        // Streamed: each chunk is sent as soon as it is serialized.
+        measure("streamed", count, [](Value value, auto&& onFirst) {
+            ValueStream stream(std::move(value));
+            std::string chunk;
+            std::size_t size = 0;
+            while (!stream.done())
+            {
+                chunk.clear();
+                stream.write(stringOutput(chunk), 4096);
+                onFirst();
+                size += chunk.size();
+            }
+            return size;
+        });
+
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ValueStream, ripple_basics, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(ValueStreamTiming, ripple_basics, ripple);
+
+}  // namespace Json
@@ -15,8 +15,10 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
 
 namespace ripple {
 namespace test {
@@ -49,10 +51,70 @@ struct PendingSaves_test : public beast::unit_test::suite
         BEAST_EXPECT(!ps.pending(0));
     }
 
+    // Dispatch an asynchronous save the way pendSaveValidated does
+    static bool
+    pend(PendingSaves& ps, LedgerIndex seq, bool isCurrent = false)
+    {
+        return ps.shouldWork(seq, false) && ps.enqueue(nullptr, seq, isCurrent);
+    }
+
+    void
+    testQueue()
+    {
+        PendingSaves ps;
+
+        // Only the first ledger starts the writer
+        BEAST_EXPECT(pend(ps, 10));
+        BEAST_EXPECT(!pend(ps, 11));
+        BEAST_EXPECT(!pend(ps, 12, true));
+        BEAST_EXPECT(!pend(ps, 10));
+
+        // Ledgers are taken newest first and their work is started
+        auto batch = ps.dequeue(2);
+        BEAST_EXPECT(batch.size() == 2);
+        BEAST_EXPECT(batch[0].isCurrent && !batch[1].isCurrent);
+        BEAST_EXPECT(!ps.startWork(12) && !ps.startWork(11));
+        ps.finishWork(12);
+        ps.finishWork(11);
+        BEAST_EXPECT(ps.lastSaved() == 12);
+
+        // A ledger saved synchronously is dropped from the queue
+        BEAST_EXPECT(ps.shouldWork(10, true));
+        BEAST_EXPECT(ps.startWork(10));
+        ps.finishWork(10);
+        BEAST_EXPECT(ps.lastSaved() == 12);
+
+        // A ledger that failed to save does not count as saved
+        BEAST_EXPECT(!pend(ps, 15));
+        batch = ps.dequeue(2);
+        BEAST_EXPECT(batch.size() == 1);
+        ps.finishWork(15, false);
+        BEAST_EXPECT(!ps.pending(15));
+        BEAST_EXPECT(ps.lastSaved() == 12);
+
+        // The writer stops once the queue is empty
+        BEAST_EXPECT(ps.dequeue(2).empty());
+        BEAST_EXPECT(ps.getSnapshot().empty());
+
+        // A ledger queued again with the same sequence replaces the first
+        jtx::Env env(*this);
+        auto const ledger = env.app().getLedgerMaster().getClosedLedger();
+        BEAST_EXPECT(ledger);
+        BEAST_EXPECT(pend(ps, 13));
+        BEAST_EXPECT(!ps.enqueue(ledger, 13, true));
+        batch = ps.dequeue(2);
+        BEAST_EXPECT(batch.size() == 1);
+        BEAST_EXPECT(batch[0].ledger == ledger && batch[0].isCurrent);
+        ps.finishWork(13);
+        BEAST_EXPECT(ps.dequeue(2).empty());
+        BEAST_EXPECT(pend(ps, 14));
+    }
+
     void
     run() override
     {
         testSaves();
+        testQueue();
     }
 };
 
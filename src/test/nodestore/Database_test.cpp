@@ -26,6 +26,7 @@
 #include <test/jtx/envconfig.h>
 #include <test/nodestore/TestBase.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <future>
 
 namespace ripple {
 
@@ -546,6 +547,28 @@ public:
                 fetchCopyOfBatch(*db, &copy, batch);
                 BEAST_EXPECT(areBatchesEqual(batch, copy));
             }
+
+            {
+                // Read it back as one asynchronous batch, along with
+                // an object that is not in the database
+                std::vector<uint256> hashes;
+                hashes.reserve(batch.size() + 1);
+                for (auto const& object : batch)
+                    hashes.push_back(object->getHash());
+                hashes.push_back(uint256(1));
+
+                std::promise<Batch> promise;
+                db->asyncFetchBatch(
+                    std::move(hashes), 0, [&promise](Batch const& objects) {
+                        promise.set_value(objects);
+                    });
+                auto copy = promise.get_future().get();
+
+                BEAST_EXPECT(copy.size() == batch.size() + 1);
+                BEAST_EXPECT(copy.back() == nullptr);
+                copy.pop_back();
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
         }
 
         if (testPersistence)
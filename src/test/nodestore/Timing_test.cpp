@@ -26,10 +26,18 @@
 #include <ripple/beast/xor_shift_engine.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/Serializer.h>
 #include <ripple/unity/rocksdb.h>
 #include <boost/algorithm/string.hpp>
 #include <atomic>
 #include <chrono>
+#include <cstring>
+#include <iomanip>
 #include <iterator>
 #include <limits>
 #include <map>
@@ -669,6 +677,161 @@ public:
 
     //--------------------------------------------------------------------------
 
+    // Returns encoded blobs resembling a state map: serialized account
+    // roots, with every fourth object an inner node.
+    static std::vector<Blob>
+    makeStateBlobs(std::size_t items)
+    {
+        beast::xor_shift_engine gen(items);
+        std::uniform_int_distribution<std::uint32_t> d_seq(1, 100000);
+        std::uniform_int_distribution<std::uint64_t> d_drops(
+            20000000, 100000000000);
+        std::bernoulli_distribution d_branch(0.5);
+
+        std::vector<Blob> result;
+        result.reserve(items);
+        for (std::size_t n = 0; n < items; ++n)
+        {
+            Serializer s;
+            if (n % 4 == 3)
+            {
+                s.add32(HashPrefix::innerNode);
+                for (int branch = 0; branch < 16; ++branch)
+                {
+                    uint256 hash;
+                    if (d_branch(gen))
+                        rngcpy(hash.data(), hash.size(), gen);
+                    s.addBitString(hash);
+                }
+            }
+            else
+            {
+                AccountID id;
+                rngcpy(id.data(), id.size(), gen);
+                SLE sle(keylet::account(id));
+                sle.setAccountID(sfAccount, id);
+                sle.setFieldAmount(sfBalance, XRPAmount(d_drops(gen)));
+                sle.setFieldU32(sfSequence, d_seq(gen));
+                sle.setFieldU32(sfOwnerCount, d_seq(gen) % 8);
+                sle.setFieldU32(sfFlags, 0);
+                uint256 txID;
+                rngcpy(txID.data(), txID.size(), gen);
+                sle.setFieldH256(sfPreviousTxnID, txID);
+                sle.setFieldU32(sfPreviousTxnLgrSeq, d_seq(gen));
+
+                s.add32(HashPrefix::leafNode);
+                sle.add(s);
+                s.addBitString(sle.key());
+            }
+
+            EncodedBlob const e(NodeObject::createObject(
+                hotACCOUNT_NODE, Blob(s.peekData()), s.getSHA512Half()));
+            auto const p = static_cast<std::uint8_t const*>(e.getData());
+            result.emplace_back(p, p + e.getSize());
+        }
+        return result;
+    }
+
+    // Reports the compression ratio and the encode and decode throughput
+    // of the codec, checking that every object survives the round trip.
+    void
+    do_codec(
+        std::string const& name,
+        std::vector<Blob> const& blobs,
+        ZstdCodec* zstd)
+    {
+        std::size_t rawBytes = 0;
+        std::size_t storedBytes = 0;
+        std::vector<Blob> stored;
+        stored.reserve(blobs.size());
+
+        auto start = clock_type::now();
+        for (auto const& blob : blobs)
+        {
+            nudb::detail::buffer bf;
+            auto const result =
+                nodeobject_compress(blob.data(), blob.size(), bf, zstd);
+            auto const p = static_cast<std::uint8_t const*>(result.first);
+            stored.emplace_back(p, p + result.second);
+            rawBytes += blob.size();
+            storedBytes += result.second;
+        }
+        auto const encodeTime = clock_type::now() - start;
+
+        bool ok = true;
+        start = clock_type::now();
+        for (std::size_t i = 0; i < stored.size(); ++i)
+        {
+            nudb::detail::buffer bf;
+            auto const result = nodeobject_decompress(
+                stored[i].data(), stored[i].size(), bf, zstd);
+            ok = ok && result.second == blobs[i].size() &&
+                std::memcmp(result.first, blobs[i].data(), result.second) ==
+                    0;
+        }
+        auto const decodeTime = clock_type::now() - start;
+        BEAST_EXPECTS(ok, name);
+
+        auto const mbps = [rawBytes](auto d) {
+            using seconds = std::chrono::duration<double>;
+            auto const s = std::chrono::duration_cast<seconds>(d).count();
+            return s > 0 ? rawBytes / s / 1e6 : 0.;
+        };
+
+        std::stringstream ss;
+        ss << std::left << std::setw(10) << name << std::right << std::fixed
+           << std::setprecision(2) << std::setw(8)
+           << (storedBytes ? double(rawBytes) / storedBytes : 0.)
+           << std::setprecision(1) << std::setw(12) << mbps(encodeTime)
+           << std::setw(12) << mbps(decodeTime);
+        log << ss.str() << std::endl;
+    }
+
+    void
+    do_codecs(std::size_t items)
+    {
+        test::SuiteJournal journal("Timing_test", *this);
+        auto const blobs = makeStateBlobs(items);
+
+        beast::temp_dir tempDir;
+        DummyScheduler scheduler;
+        ZstdCodec zstd(3, false, {}, scheduler, journal);
+        ZstdCodec zstdDict(
+            3,
+            true,
+            tempDir.path(),
+            scheduler,
+            journal,
+            32 * ZstdCodec::dictionarySize);
+
+        // Train the dictionary before measuring. The dummy scheduler trains
+        // it as soon as there are enough samples.
+        for (auto const& blob : blobs)
+        {
+            nudb::detail::buffer bf;
+            nodeobject_compress(blob.data(), blob.size(), bf, &zstdDict);
+        }
+        BEAST_EXPECT(zstdDict.hasDictionary(hotACCOUNT_NODE));
+        {
+            // The dictionary was renamed into place once synced
+            auto const dictionary = boost::filesystem::path(tempDir.path()) /
+                ("zstd." + std::to_string(hotACCOUNT_NODE) + ".dict");
+            BEAST_EXPECT(boost::filesystem::exists(dictionary));
+            BEAST_EXPECT(!boost::filesystem::exists(
+                boost::filesystem::path(dictionary).concat(".tmp")));
+        }
+
+        log << items << " Objects" << std::endl;
+        log << std::left << std::setw(10) << "Codec" << std::right
+            << std::setw(8) << "Ratio" << std::setw(12) << "Encode MB/s"
+            << std::setw(12) << "Decode MB/s" << std::endl;
+        do_codec("lz4", blobs, nullptr);
+        do_codec("zstd", blobs, &zstd);
+        do_codec("zstd+dict", blobs, &zstdDict);
+    }
+
+    //--------------------------------------------------------------------------
+
     using test_func =
         void (Timing_test::*)(Section const&, Params const&, beast::Journal);
     using test_list = std::vector<std::pair<std::string, test_func>>;
@@ -736,6 +899,9 @@ public:
     void
     run() override
     {
+        testcase("Codecs");
+        do_codecs(default_items);
+
         testcase("Timing", beast::unit_test::abort_on_fail);
 
         /*  Parameters:
@@ -746,6 +912,7 @@ public:
         */
         std::string default_args =
             "type=nudb"
+            ";type=nudb,compression=zstd"
 #if RIPPLE_ROCKSDB_AVAILABLE
             ";type=rocksdb,open_files=2000,filter_bits=12,cache_mb=256,"
             "file_size_mb=8,file_size_mult=2"
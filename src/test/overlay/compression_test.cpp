@@ -35,16 +35,20 @@
 #include <ripple/protocol/digest.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/shamap/SHAMapNodeID.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <boost/algorithm/string/replace.hpp>
 #include <boost/asio/ip/address_v4.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/endian/conversion.hpp>
 #include <algorithm>
+#include <chrono>
 #include <ripple.pb.h>
 #include <test/jtx/Account.h>
 #include <test/jtx/Env.h>
 #include <test/jtx/WSClient.h>
 #include <test/jtx/amount.h>
 #include <test/jtx/pay.h>
+#include <test/jtx/seq.h>
 
 namespace ripple {
 
@@ -79,6 +83,44 @@ public:
     {
     }
 
+    // Parse a message the way peers do, from a read buffer that is split
+    // into chunks and also holds the message that follows.
+    template <typename T>
+    void
+    checkParse(
+        T const& proto,
+        Message& m,
+        Algorithm negotiated,
+        uint16_t nbuffers)
+    {
+        auto const& wire = m.getBuffer(negotiated);
+
+        boost::beast::multi_buffer buffers;
+        auto const sz = wire.size() / nbuffers;
+        for (int i = 0; i < nbuffers; i++)
+        {
+            auto const start = wire.data() + sz * i;
+            auto const size =
+                i < nbuffers - 1 ? sz : wire.size() - sz * (nbuffers - 1);
+            buffers.commit(boost::asio::buffer_copy(
+                buffers.prepare(size), boost::asio::buffer(start, size)));
+        }
+        buffers.commit(boost::asio::buffer_copy(
+            buffers.prepare(wire.size()), boost::asio::buffer(wire)));
+
+        boost::system::error_code ec;
+        auto const header = ripple::detail::parseMessageHeader(
+            ec, buffers.data(), buffers.size());
+        if (!BEAST_EXPECT(header))
+            return;
+
+        auto const parsed =
+            ripple::detail::parseMessageContent<T>(*header, buffers.data());
+        BEAST_EXPECT(
+            parsed &&
+            parsed->SerializeAsString() == proto.SerializeAsString());
+    }
+
     template <typename T>
     void
     doTest(
@@ -91,7 +133,26 @@ public:
 
         Message m(*proto, mt);
 
-        auto& buffer = m.getBuffer(Compressed::On);
+        for (auto const negotiated :
+             {Algorithm::None, Algorithm::LZ4, Algorithm::Zstd})
+            checkParse(*proto, m, negotiated, nbuffers);
+
+        BEAST_EXPECT(
+            &m.getBuffer(Compressed::On) == &m.getBuffer(Algorithm::LZ4));
+
+        for (auto const negotiated : {Algorithm::LZ4, Algorithm::Zstd})
+            checkDecompress(proto, m, negotiated, nbuffers);
+    }
+
+    template <typename T>
+    void
+    checkDecompress(
+        std::shared_ptr<T> proto,
+        Message& m,
+        Algorithm negotiated,
+        uint16_t nbuffers)
+    {
+        auto& buffer = m.getBuffer(negotiated);
 
         boost::beast::multi_buffer buffers;
 
@@ -116,6 +177,11 @@ public:
         if (!header || header->algorithm == Algorithm::None)
             return;
 
+        BEAST_EXPECT(
+            header->algorithm ==
+            Message::compressionFor(
+                header->message_type, header->uncompressed_size, negotiated));
+
         std::vector<std::uint8_t> decompressed;
         decompressed.resize(header->uncompressed_size);
 
@@ -129,7 +195,8 @@ public:
             stream,
             header->payload_wire_size,
             decompressed.data(),
-            header->uncompressed_size);
+            header->uncompressed_size,
+            header->algorithm);
         BEAST_EXPECT(decompressedSize == header->uncompressed_size);
         auto const proto1 = std::make_shared<T>();
 
@@ -312,6 +379,79 @@ public:
         return getObject;
     }
 
+    std::shared_ptr<protocol::TMGetObjectByHash>
+    buildGetObjectByHashReply(uint32_t n, Logs& logs)
+    {
+        auto getObject = std::make_shared<protocol::TMGetObjectByHash>();
+
+        getObject->set_type(protocol::TMGetObjectByHash_ObjectType::
+                                TMGetObjectByHash_ObjectType_otLEDGER);
+        getObject->set_query(false);
+        getObject->set_seq(123456789);
+        uint256 const hash(ripple::sha512Half(123456789));
+        getObject->set_ledgerhash(hash.data(), hash.size());
+        auto tk = make_TimeKeeper(logs.journal("TimeKeeper"));
+        uint256 parentHash(0);
+        for (int i = 0; i < n; i++)
+        {
+            LedgerInfo info;
+            info.seq = i;
+            info.parentCloseTime = tk->now();
+            info.txHash = ripple::sha512Half(i + 1);
+            info.accountHash = ripple::sha512Half(i + 2);
+            info.parentHash = parentHash;
+            info.drops = XRPAmount(10);
+            info.closeTime = tk->now();
+            parentHash = ledgerHash(info);
+            Serializer nData;
+            ripple::addRaw(info, nData);
+            auto object = getObject->add_objects();
+            object->set_hash(parentHash.data(), parentHash.size());
+            object->set_data(nData.getDataPtr(), nData.getLength());
+            object->set_ledgerseq(i);
+        }
+        return getObject;
+    }
+
+    std::shared_ptr<protocol::TMTransactions>
+    buildTransactions(uint32_t n, Logs& logs)
+    {
+        Env env(*this, envconfig());
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+
+        auto tk = make_TimeKeeper(logs.journal("TimeKeeper"));
+        auto transactions = std::make_shared<protocol::TMTransactions>();
+        auto const aliceSeq = env.seq(alice);
+        for (int i = 0; i < n; i++)
+        {
+            auto const jt =
+                env.jt(pay(alice, bob, drops(1000 + i)), seq(aliceSeq + i));
+            Serializer s;
+            jt.stx->add(s);
+            auto transaction = transactions->add_transactions();
+            transaction->set_rawtransaction(s.data(), s.size());
+            transaction->set_status(protocol::tsNEW);
+            transaction->set_receivetimestamp(
+                tk->now().time_since_epoch().count());
+        }
+        return transactions;
+    }
+
+    std::shared_ptr<protocol::TMValidation>
+    buildValidation()
+    {
+        // A signed validation is mostly hashes, keys and a signature
+        Serializer s;
+        for (int i = 0; i < 8; i++)
+            s.addBitString(ripple::sha512Half(i));
+        auto validation = std::make_shared<protocol::TMValidation>();
+        validation->set_validation(s.data(), s.size());
+        return validation;
+    }
+
     std::shared_ptr<protocol::TMValidatorList>
     buildValidatorList()
     {
@@ -480,7 +620,10 @@ public:
                 c.VP_REDUCE_RELAY_SQUELCH;
             return env;
         };
-        auto handshake = [&](int outboundEnable, int inboundEnable) {
+        // A legacy outbound peer only offers lz4
+        auto handshake = [&](int outboundEnable,
+                             int inboundEnable,
+                             bool legacy = false) {
             beast::IP::Address addr =
                 boost::asio::ip::address::from_string("172.1.1.100");
 
@@ -494,14 +637,22 @@ public:
             http_request_type http_request;
             http_request.version(request.version());
             http_request.base() = request.base();
+            if (legacy)
+            {
+                auto features = http_request["X-Protocol-Ctl"].to_string();
+                boost::algorithm::replace_all(
+                    features, "compr=zstd,lz4", "compr=lz4");
+                http_request.set("X-Protocol-Ctl", features);
+            }
             // feature enabled on the peer's connection only if both sides are
-            // enabled
-            auto const peerEnabled = inboundEnable && outboundEnable;
+            // enabled, with zstd unless the outbound peer only offers lz4
+            auto const expected = !(inboundEnable && outboundEnable)
+                ? Algorithm::None
+                : legacy ? Algorithm::LZ4 : Algorithm::Zstd;
             // inbound is enabled if the request's header has the feature
             // enabled and the peer's configuration is enabled
-            auto const inboundEnabled = peerFeatureEnabled(
-                http_request, FEATURE_COMPR, "lz4", inboundEnable);
-            BEAST_EXPECT(!(peerEnabled ^ inboundEnabled));
+            BEAST_EXPECT(
+                peerCompression(http_request, inboundEnable) == expected);
 
             env.reset();
             env = getEnv(inboundEnable);
@@ -516,14 +667,49 @@ public:
                 env->app());
             // outbound is enabled if the response's header has the feature
             // enabled and the peer's configuration is enabled
-            auto const outboundEnabled = peerFeatureEnabled(
-                http_resp, FEATURE_COMPR, "lz4", outboundEnable);
-            BEAST_EXPECT(!(peerEnabled ^ outboundEnabled));
+            BEAST_EXPECT(
+                peerCompression(http_resp, outboundEnable) == expected);
         };
         handshake(1, 1);
         handshake(1, 0);
         handshake(0, 1);
         handshake(0, 0);
+        handshake(1, 1, true);
+        handshake(0, 1, true);
+    }
+
+    void
+    testPolicy()
+    {
+        testcase("Compression policy");
+
+        auto const select = [](int type, std::size_t bytes) {
+            return Message::compressionFor(type, bytes, Algorithm::Zstd);
+        };
+
+        // Bulk messages use the negotiated algorithm once they are large
+        for (auto const type :
+             {protocol::mtLEDGER_DATA,
+              protocol::mtGET_OBJECTS,
+              protocol::mtTRANSACTIONS})
+        {
+            BEAST_EXPECT(select(type, 64 * 1024) == Algorithm::Zstd);
+            BEAST_EXPECT(select(type, 200) == Algorithm::LZ4);
+            BEAST_EXPECT(select(type, 50) == Algorithm::None);
+            BEAST_EXPECT(
+                Message::compressionFor(type, 64 * 1024, Algorithm::LZ4) ==
+                Algorithm::LZ4);
+            BEAST_EXPECT(
+                Message::compressionFor(type, 64 * 1024, Algorithm::None) ==
+                Algorithm::None);
+        }
+
+        BEAST_EXPECT(
+            select(protocol::mtTRANSACTION, 64 * 1024) == Algorithm::LZ4);
+        BEAST_EXPECT(
+            select(protocol::mtVALIDATION, 64 * 1024) == Algorithm::None);
+        BEAST_EXPECT(
+            select(protocol::mtPROPOSE_LEDGER, 200) == Algorithm::None);
     }
 
     void
@@ -531,10 +717,135 @@ public:
     {
         testProtocol();
         testHandshake();
+        testPolicy();
+    }
+};
+
+/** Reports the compression ratio and the CPU cost of compressing and
+    decompressing each message type with every algorithm.
+
+    The argument is the number of times each message is compressed and
+    decompressed, 100 by default.
+*/
+class compression_benchmark_test : public compression_test
+{
+    using Algorithm = compression::Algorithm;
+    using clock_type = std::chrono::steady_clock;
+
+    template <typename T>
+    void
+    measure(
+        std::string const& name,
+        T const& proto,
+        protocol::MessageType mt,
+        std::size_t iterations)
+    {
+        auto const payload = proto.SerializeAsString();
+        log << name << ": " << payload.size() << " bytes, zstd peers use "
+            << compressionName(Message::compressionFor(
+                   mt, payload.size(), Algorithm::Zstd))
+            << std::endl;
+
+        for (auto const algorithm : {Algorithm::LZ4, Algorithm::Zstd})
+        {
+            std::vector<std::uint8_t> compressed;
+            std::size_t compressedSize = 0;
+            auto start = clock_type::now();
+            for (std::size_t i = 0; i < iterations; ++i)
+                compressedSize = compression::compress(
+                    payload.data(),
+                    payload.size(),
+                    [&](std::size_t size) {
+                        compressed.resize(size);
+                        return compressed.data();
+                    },
+                    algorithm);
+            auto const compressTime = clock_type::now() - start;
+
+            std::vector<std::uint8_t> decompressed(payload.size());
+            start = clock_type::now();
+            for (std::size_t i = 0; i < iterations; ++i)
+                compression::decompress(
+                    compressed.data(),
+                    compressedSize,
+                    decompressed.data(),
+                    decompressed.size(),
+                    algorithm);
+            auto const decompressTime = clock_type::now() - start;
+
+            BEAST_EXPECT(std::equal(
+                decompressed.begin(), decompressed.end(), payload.begin()));
+
+            using namespace std::chrono;
+            auto const perMessage = [&](clock_type::duration d) {
+                return duration_cast<nanoseconds>(d).count() / iterations;
+            };
+            log << "    " << compressionName(algorithm)
+                << ": ratio " << (static_cast<double>(payload.size()) /
+                                  std::max<std::size_t>(compressedSize, 1))
+                << ", compress " << perMessage(compressTime)
+                << " ns, decompress " << perMessage(decompressTime) << " ns"
+                << std::endl;
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t iterations = 100;
+        if (!arg().empty())
+            iterations = beast::lexicalCastThrow<std::size_t>(arg());
+
+        testcase("Benchmark");
+
+        auto logs = std::make_unique<Logs>(beast::severities::kInfo);
+
+        measure(
+            "TMValidation",
+            *buildValidation(),
+            protocol::mtVALIDATION,
+            iterations);
+        measure(
+            "TMTransaction",
+            *buildTransaction(*logs),
+            protocol::mtTRANSACTION,
+            iterations);
+        measure(
+            "TMTransactions100",
+            *buildTransactions(100, *logs),
+            protocol::mtTRANSACTIONS,
+            iterations);
+        measure(
+            "TMGetObjectByHash query",
+            *buildGetObjectByHash(),
+            protocol::mtGET_OBJECTS,
+            iterations);
+        measure(
+            "TMGetObjectByHash reply",
+            *buildGetObjectByHashReply(1000, *logs),
+            protocol::mtGET_OBJECTS,
+            iterations);
+        measure(
+            "TMLedgerData1000",
+            *buildLedgerData(1000, *logs),
+            protocol::mtLEDGER_DATA,
+            iterations);
+        measure(
+            "TMManifests100",
+            *buildManifests(100),
+            protocol::mtMANIFESTS,
+            iterations);
+        measure(
+            "TMEndpoints100",
+            *buildEndpoints(100),
+            protocol::mtENDPOINTS,
+            iterations);
     }
 };
 
 BEAST_DEFINE_TESTSUITE_MANUAL(compression, ripple_data, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(compression_benchmark, ripple_data, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -20,6 +20,11 @@
 #include <ripple/beast/unit_test.h>
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/digest.h>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <array>
+#include <iterator>
+#include <string>
 #include <vector>
 
 namespace ripple {
@@ -453,12 +458,258 @@ public:
         BEAST_EXPECT(pk1 == pk3);
     }
 
+    void
+    testBatchVerify()
+    {
+        testcase("Batch verification");
+
+        // Alternate key types and corrupt every fifth signature, with
+        // enough Ed25519 signatures to fill more than one batch
+        std::vector<std::pair<PublicKey, SecretKey>> keys;
+        std::vector<std::string> messages;
+        std::vector<Buffer> signatures;
+        for (int i = 0; i < 150; ++i)
+        {
+            auto const type =
+                i % 3 == 0 ? KeyType::secp256k1 : KeyType::ed25519;
+            keys.push_back(randomKeyPair(type));
+            messages.push_back("message " + std::to_string(i));
+            signatures.push_back(sign(
+                keys.back().first,
+                keys.back().second,
+                makeSlice(messages.back())));
+            if (i % 5 == 4)
+                signatures.back().data()[10] ^= 0x01;
+        }
+
+        std::vector<SignedMessage> batch;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            batch.push_back(
+                {keys[i].first, makeSlice(messages[i]), signatures[i]});
+
+        auto const valid = verifyBatch(batch);
+        BEAST_EXPECT(valid.size() == batch.size());
+        for (std::size_t i = 0; i < valid.size(); ++i)
+        {
+            BEAST_EXPECT(valid[i] == (i % 5 != 4));
+            BEAST_EXPECT(
+                valid[i] ==
+                verify(keys[i].first, batch[i].message, batch[i].signature));
+        }
+
+        // A signature checked against the wrong message or key
+        std::swap(batch[1].message, batch[2].message);
+        std::swap(batch[5].publicKey, batch[7].publicKey);
+        auto const swapped = verifyBatch(batch);
+        for (auto i : {1, 2, 5, 7})
+            BEAST_EXPECT(!swapped[i]);
+        BEAST_EXPECT(swapped[8]);
+
+        BEAST_EXPECT(verifyBatch({}).empty());
+
+        testBatchVerifyEdgeCases();
+    }
+
+    // Decode a little-endian integer
+    static boost::multiprecision::cpp_int
+    fromLE(std::uint8_t const* data, std::size_t size)
+    {
+        boost::multiprecision::cpp_int x;
+        import_bits(x, data, data + size, 8, false);
+        return x;
+    }
+
+    // Encode an integer below 2^256 as 32 little-endian bytes
+    static std::array<std::uint8_t, 32>
+    toLE(boost::multiprecision::cpp_int const& x)
+    {
+        std::array<std::uint8_t, 32> bytes{};
+        std::vector<std::uint8_t> v;
+        export_bits(x, std::back_inserter(v), 8, false);
+        std::copy(v.begin(), v.end(), bytes.begin());
+        return bytes;
+    }
+
+    void
+    testBatchVerifyEdgeCases()
+    {
+        testcase("Batch verification edge cases");
+
+        using boost::multiprecision::cpp_int;
+
+        // The order of the Ed25519 base point
+        cpp_int const order =
+            (cpp_int(1) << 252) +
+            cpp_int("27742317777372353535851937790883648493");
+
+        // The neutral element, canonically and non-canonically encoded as
+        // y = 1 and y = p + 1, and a point of order 8
+        std::array<std::uint8_t, 32> const neutral = toLE(1);
+        std::array<std::uint8_t, 32> const neutralNonCanonical =
+            toLE((cpp_int(1) << 255) - 18);
+        std::array<std::uint8_t, 32> const order8 = {
+            0x26, 0xE8, 0x95, 0x8F, 0xC2, 0xB2, 0x27, 0xB0, 0x45, 0xC3, 0xF4,
+            0x89, 0xF2, 0xEF, 0x98, 0xF0, 0xD5, 0xDF, 0xAC, 0x05, 0xD3, 0xC6,
+            0x33, 0x39, 0xB1, 0x38, 0x02, 0x88, 0x6D, 0x53, 0xFC, 0x05};
+
+        auto makeKey = [](std::array<std::uint8_t, 32> const& point) {
+            std::uint8_t key[33] = {0xED};
+            std::copy(point.begin(), point.end(), key + 1);
+            return PublicKey(Slice(key, sizeof(key)));
+        };
+
+        auto makeSignature = [](std::array<std::uint8_t, 32> const& r,
+                                std::array<std::uint8_t, 32> const& s) {
+            Buffer sig(64);
+            std::copy(r.begin(), r.end(), sig.data());
+            std::copy(s.begin(), s.end(), sig.data() + 32);
+            return sig;
+        };
+
+        // Batches smaller than four are checked one at a time, so each
+        // signature under test is batched with valid ones
+        std::vector<std::pair<PublicKey, SecretKey>> keys;
+        std::vector<Buffer> valid;
+        std::string const message = "valid";
+        for (int i = 0; i < 3; ++i)
+        {
+            keys.push_back(randomKeyPair(KeyType::ed25519));
+            valid.push_back(
+                sign(keys[i].first, keys[i].second, makeSlice(message)));
+        }
+
+        auto check = [&](PublicKey const& pk,
+                         std::string const& m,
+                         Buffer const& sig) {
+            std::vector<SignedMessage> batch;
+            for (int i = 0; i < 3; ++i)
+                batch.push_back({keys[i].first, makeSlice(message), valid[i]});
+            batch.push_back({pk, makeSlice(m), sig});
+
+            auto const result = verifyBatch(batch);
+            BEAST_EXPECT(result[0] && result[1] && result[2]);
+            BEAST_EXPECT(result[3] == verify(pk, makeSlice(m), sig));
+            return result[3];
+        };
+
+        // The scalar a for which a secret key's public key is aB
+        auto secretScalar = [](SecretKey const& sk) {
+            sha512_hasher h;
+            h(sk.data(), sk.size());
+            auto digest = static_cast<sha512_hasher::result_type>(h);
+            digest[0] &= 248;
+            digest[31] &= 127;
+            digest[31] |= 64;
+            return fromLE(digest.data(), 32);
+        };
+
+        // The hash H(R || A || m) reduced modulo the order
+        auto hram = [&order](
+                        std::uint8_t const* r,
+                        PublicKey const& pk,
+                        std::string const& m) {
+            sha512_hasher h;
+            h(r, 32);
+            h(pk.data() + 1, pk.size() - 1);
+            h(m.data(), m.size());
+            auto const digest = static_cast<sha512_hasher::result_type>(h);
+            return fromLE(digest.data(), digest.size()) % order;
+        };
+
+        // Add the point of order 8 to a canonically encoded point, using
+        // the affine addition law of -x^2 + y^2 = 1 + dx^2y^2.
+        auto addOrder8 = [&order8](std::uint8_t const* point) {
+            using boost::multiprecision::powm;
+            cpp_int const p = (cpp_int(1) << 255) - 19;
+            auto inv = [&p](cpp_int const& x) -> cpp_int {
+                return powm(x, p - 2, p);
+            };
+            cpp_int const d = (p - 121665) * inv(121666) % p;
+            cpp_int const sqrtMinusOne =
+                powm(cpp_int(2), cpp_int((p - 1) / 4), p);
+
+            auto decode = [&](std::uint8_t const* e) {
+                auto const v = fromLE(e, 32);
+                cpp_int const y = v & ((cpp_int(1) << 255) - 1);
+                cpp_int const xx = (y * y + p - 1) * inv(d * y * y + 1) % p;
+                cpp_int x = powm(xx, cpp_int((p + 3) / 8), p);
+                if ((x * x - xx) % p != 0)
+                    x = x * sqrtMinusOne % p;
+                if ((x & 1) != (v >> 255))
+                    x = p - x;
+                return std::make_pair(x, y);
+            };
+
+            auto const [x1, y1] = decode(point);
+            auto const [x2, y2] = decode(order8.data());
+            cpp_int const t = d * x1 * x2 * y1 * y2 % p;
+            cpp_int const x = (x1 * y2 + x2 * y1) * inv(1 + t) % p;
+            cpp_int const y = (y1 * y2 + x1 * x2) * inv(p + 1 - t) % p;
+            return toLE(y | ((x & 1) << 255));
+        };
+
+        // A non-canonical R, which verify rejects since the R it computes
+        // is encoded differently. S is chosen so that SB - hA is neutral.
+        {
+            auto const [pk, sk] = randomKeyPair(KeyType::ed25519);
+            std::string const m = "non-canonical R";
+            auto const a = secretScalar(sk);
+            auto const k = hram(neutralNonCanonical.data(), pk, m);
+
+            BEAST_EXPECT(!check(
+                pk,
+                m,
+                makeSignature(neutralNonCanonical, toLE(k * a % order))));
+        }
+
+        // R and keys with both a component of prime order and one of order
+        // 8. Signed with the prime order parts, verify rejects R always
+        // and the key unless the hash is a multiple of 8, while a batch
+        // only sees the order 8 part some of the time.
+        for (int i = 0; i < 64; ++i)
+        {
+            auto const [pk, sk] = randomKeyPair(KeyType::ed25519);
+            auto const [rk, rsk] = randomKeyPair(KeyType::ed25519);
+            auto const a = secretScalar(sk);
+            auto const r = secretScalar(rsk);
+
+            std::string m = "mixed order R " + std::to_string(i);
+            auto const mixedR = addOrder8(rk.data() + 1);
+            auto const s = (r + hram(mixedR.data(), pk, m) * a) % order;
+            BEAST_EXPECT(!check(pk, m, makeSignature(mixedR, toLE(s))));
+
+            m = "mixed order key " + std::to_string(i);
+            auto const mixedKey = makeKey(addOrder8(pk.data() + 1));
+            std::array<std::uint8_t, 32> R;
+            std::copy(rk.data() + 1, rk.data() + rk.size(), R.begin());
+            auto const t = (r + hram(R.data(), mixedKey, m) * a) % order;
+            check(mixedKey, m, makeSignature(R, toLE(t)));
+        }
+
+        // The neutral element as the key, with a non-canonical R
+        BEAST_EXPECT(!check(
+            makeKey(neutral),
+            "neutral key",
+            makeSignature(neutralNonCanonical, toLE(0))));
+
+        // A key of order 8, with R neutral and S zero. verify accepts
+        // exactly when the hash is a multiple of 8, while a batch also
+        // accepts whenever the random factor it scales the signature by
+        // is a multiple of 8.
+        for (int i = 0; i < 64; ++i)
+            check(
+                makeKey(order8),
+                "small order key " + std::to_string(i),
+                makeSignature(neutral, toLE(0)));
+    }
+
     void
     run() override
     {
         testBase58();
         testCanonical();
         testMiscOperations();
+        testBatchVerify();
     }
 };
 
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/STObjectView.h>
+#include <ripple/protocol/st.h>
+#include <test/jtx.h>
+
+namespace ripple {
+
+class STObjectView_test : public beast::unit_test::suite
+{
+    void
+    testFields()
+    {
+        testcase("Fields");
+
+        auto const alice = test::jtx::Account("alice");
+
+        STObject object(sfGeneric);
+        object.setFieldU8(sfTickSize, 5);
+        object.setFieldU16(sfTransferFee, 100);
+        object.setFieldU32(sfFlags, 0x00010000);
+        object.setFieldU64(sfIndexNext, 42);
+        object.setFieldH128(sfEmailHash, uint128(7));
+        object.setFieldH160(sfTakerPaysCurrency, to_currency("USD"));
+        object.setFieldH256(sfPreviousTxnID, uint256(9));
+        object.setAccountID(sfAccount, alice.id());
+        object.setFieldAmount(sfBalance, STAmount(12345));
+        object.setFieldAmount(
+            sfLimitAmount, STAmount(alice["USD"].issue(), 100, -2));
+        object.setFieldVL(sfDomain, makeSlice(std::string("example.com")));
+        object.setFieldV256(
+            sfIndexes, STVector256(sfIndexes, {uint256(1), uint256(2)}));
+
+        STObjectView const view(object);
+        BEAST_EXPECT(view.size() == 12);
+        BEAST_EXPECT(view.getFieldU8(sfTickSize) == 5);
+        BEAST_EXPECT(view.getFieldU16(sfTransferFee) == 100);
+        BEAST_EXPECT(view.getFieldU32(sfFlags) == 0x00010000);
+        BEAST_EXPECT(view.getFieldU64(sfIndexNext) == 42);
+        BEAST_EXPECT(view.getFieldH128(sfEmailHash) == uint128(7));
+        BEAST_EXPECT(
+            view.getFieldH160(sfTakerPaysCurrency) ==
+            object.getFieldH160(sfTakerPaysCurrency));
+        BEAST_EXPECT(view.getFieldH256(sfPreviousTxnID) == uint256(9));
+        BEAST_EXPECT(view.getAccountID(sfAccount) == alice.id());
+        BEAST_EXPECT(view.getFieldAmount(sfBalance) == STAmount(12345));
+        BEAST_EXPECT(
+            view.getFieldAmount(sfLimitAmount) ==
+            object.getFieldAmount(sfLimitAmount));
+        auto const domain = object.getFieldVL(sfDomain);
+        BEAST_EXPECT(view.getFieldVL(sfDomain) == makeSlice(domain));
+        BEAST_EXPECT(
+            view.getFieldV256(sfIndexes) == object.getFieldV256(sfIndexes));
+
+        // Absent fields read as their defaults
+        BEAST_EXPECT(!view.isFieldPresent(sfSequence));
+        BEAST_EXPECT(view.getFieldU32(sfSequence) == 0);
+        BEAST_EXPECT(view.getFieldVL(sfMemoData).empty());
+        BEAST_EXPECT(view.getFieldV256(sfHashes).empty());
+
+        // Reading a field as the wrong type throws
+        try
+        {
+            view.getFieldU64(sfFlags);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testMalformed()
+    {
+        testcase("Malformed");
+
+        // A field header for an unknown field
+        std::vector<std::uint8_t> const data{0x00, 0xC8, 0xC8};
+        try
+        {
+            STObjectView const view(makeSlice(data), nullptr);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+
+        // A truncated value
+        Serializer s;
+        s.addFieldID(STI_UINT32, 2);
+        s.add16(1);
+        try
+        {
+            STObjectView const view(s.slice(), nullptr);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testReadFields()
+    {
+        testcase("Read fields");
+
+        using namespace test::jtx;
+        Env env(*this);
+        Account const alice("alice");
+        Account const gw("gw");
+        env.fund(XRP(10000), alice, gw);
+        env.trust(gw["USD"](1000), alice);
+        env.close();
+
+        auto const check = [&](ReadView const& ledger) {
+            auto const sle = ledger.read(keylet::account(alice));
+            auto const view = ledger.readFields(keylet::account(alice));
+            if (!BEAST_EXPECT(sle && view))
+                return;
+            BEAST_EXPECT(view->getAccountID(sfAccount) == alice.id());
+            BEAST_EXPECT(
+                view->getFieldAmount(sfBalance) ==
+                sle->getFieldAmount(sfBalance));
+            BEAST_EXPECT(
+                view->getFieldU32(sfSequence) == sle->getFieldU32(sfSequence));
+            BEAST_EXPECT(
+                view->getFieldU32(sfOwnerCount) ==
+                sle->getFieldU32(sfOwnerCount));
+
+            // The keylet's type is checked
+            BEAST_EXPECT(!ledger.readFields(
+                Keylet(ltOFFER, keylet::account(alice).key)));
+            BEAST_EXPECT(!ledger.readFields(keylet::account(Account("bob"))));
+
+            auto const dir = ledger.readFields(keylet::ownerDir(alice));
+            if (!BEAST_EXPECT(dir))
+                return;
+            BEAST_EXPECT(dir->getFieldV256(sfIndexes).size() == 1);
+            BEAST_EXPECT(dir->getFieldU64(sfIndexNext) == 0);
+        };
+
+        // A closed ledger reads in place from the state map
+        check(*env.closed());
+
+        // An open view reads through its own changes
+        env(pay(alice, gw, XRP(10)));
+        check(*env.current());
+        auto const open = env.current()->readFields(keylet::account(alice));
+        auto const closed = env.closed()->readFields(keylet::account(alice));
+        if (BEAST_EXPECT(open && closed))
+            BEAST_EXPECT(
+                open->getFieldU32(sfSequence) ==
+                closed->getFieldU32(sfSequence) + 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFields();
+        testMalformed();
+        testReadFields();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STObjectView, protocol, ripple);
+
+}  // namespace ripple
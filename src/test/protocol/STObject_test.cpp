@@ -18,13 +18,17 @@
 //==============================================================================
 
 #include <ripple/basics/Log.h>
+#include <ripple/beast/core/LexicalCast.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/to_string.h>
+#include <ripple/ledger/detail/ApplyStateTable.h>
 #include <ripple/protocol/SecretKey.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/st.h>
 #include <test/jtx.h>
+#include <boost/container/pmr/global_resource.hpp>
+#include <boost/container/pmr/monotonic_buffer_resource.hpp>
 
 #include <array>
 #include <memory>
@@ -704,6 +708,39 @@ testMalformed()
     }
 }
 
+void
+testArena()
+{
+    testcase("Arena");
+
+    AccountID const account(7);
+    std::optional<STObject> copy;
+    {
+        boost::container::pmr::monotonic_buffer_resource arena;
+        STObject obj(sfGeneric, &arena);
+        obj.setFieldU32(sfFlags, 1);
+        obj.setAccountID(sfAccount, account);
+        obj.setFieldVL(sfDomain, Blob(100, 0xAB));
+
+        STObject inner(sfFinalFields, &arena);
+        inner.setFieldU64(sfIndexNext, 2);
+        obj.emplace_back(std::move(inner));
+
+        STObject const moved(std::move(obj));
+        BEAST_EXPECT(moved.getCount() == 4);
+
+        // A copy must not refer to the arena
+        copy.emplace(moved);
+        BEAST_EXPECT(*copy == moved);
+    }
+    BEAST_EXPECT(copy->getFieldU32(sfFlags) == 1);
+    BEAST_EXPECT(copy->getAccountID(sfAccount) == account);
+    BEAST_EXPECT(copy->getFieldVL(sfDomain) == Blob(100, 0xAB));
+    BEAST_EXPECT(
+        copy->peekAtField(sfFinalFields).downcast<STObject>().getFieldU64(
+            sfIndexNext) == 2);
+}
+
 void
 run() override
 {
@@ -716,10 +753,142 @@ run() override
     testParseJSONArrayWithInvalidChildrenObjects();
     testParseJSONEdgeCases();
     testMalformed();
+    testArena();
 }
 }
 ;
 
+/** Measure building transaction metadata with and without an arena.
+
+    Metadata for a modified account is built the way ApplyStateTable
+    builds it, once with every allocation made on the heap and once
+    with the fields allocated from an arena. Pass an iteration count as
+    the argument to override the default.
+*/
+class STObjectArena_test : public beast::unit_test::suite
+{
+    static constexpr int defaultIterations = 100000;
+
+    // Counts the allocations passed through to the heap
+    class CountingResource : public boost::container::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations = 0;
+
+    private:
+        void*
+        do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            return boost::container::pmr::new_delete_resource()->allocate(
+                bytes, alignment);
+        }
+
+        void
+        do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+            override
+        {
+            boost::container::pmr::new_delete_resource()->deallocate(
+                p, bytes, alignment);
+        }
+
+        bool
+        do_is_equal(memory_resource const& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    static void
+    buildMeta(
+        SLE const& before,
+        SLE& after,
+        boost::container::pmr::memory_resource* resource,
+        Serializer& s)
+    {
+        TxMeta meta(uint256(1), 2, resource);
+        meta.setAffectedNode(after.key(), sfModifiedNode, ltACCOUNT_ROOT);
+
+        STObject prevs(sfPreviousFields, resource);
+        for (auto const& obj : before)
+        {
+            if (obj.getFName().shouldMeta(SField::sMD_ChangeOrig) &&
+                !after.hasMatchingEntry(obj))
+                prevs.emplace_back(obj);
+        }
+        meta.getAffectedNode(after.key()).emplace_back(std::move(prevs));
+
+        STObject finals(sfFinalFields, resource);
+        for (auto const& obj : after)
+        {
+            if (obj.getFName().shouldMeta(
+                    SField::sMD_Always | SField::sMD_ChangeNew))
+                finals.emplace_back(obj);
+        }
+        meta.getAffectedNode(after.key()).emplace_back(std::move(finals));
+
+        s.erase();
+        meta.addRaw(s, tesSUCCESS, 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        int const iterations = arg().empty()
+            ? defaultIterations
+            : beast::lexicalCastThrow<int>(arg());
+
+        AccountID const account(3);
+        SLE before(keylet::account(account));
+        before.setAccountID(sfAccount, account);
+        before.setFieldAmount(sfBalance, STAmount(1000000));
+        before.setFieldU32(sfSequence, 5);
+        before.setFieldU32(sfOwnerCount, 1);
+        before.setFieldH256(sfPreviousTxnID, uint256(4));
+        before.setFieldU32(sfPreviousTxnLgrSeq, 1);
+        SLE after(before, before.key());
+        after.setFieldAmount(sfBalance, STAmount(999990));
+        after.setFieldU32(sfSequence, 6);
+
+        using namespace std::chrono;
+
+        auto measure = [&](char const* name, bool useArena) {
+            testcase(name);
+            CountingResource counter;
+            Serializer s;
+            auto const start = steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                if (useArena)
+                {
+                    boost::container::pmr::monotonic_buffer_resource arena{
+                        detail::ApplyStateTable::initialMetaBufferSize,
+                        &counter};
+                    buildMeta(before, after, &arena, s);
+                }
+                else
+                {
+                    buildMeta(before, after, &counter, s);
+                }
+            }
+            auto const elapsed =
+                duration_cast<nanoseconds>(steady_clock::now() - start);
+            BEAST_EXPECT(s.size() != 0);
+            log << iterations << " metadata, "
+                << elapsed.count() / iterations << " ns and "
+                << static_cast<double>(counter.allocations) / iterations
+                << " field allocations each" << std::endl;
+            return counter.allocations;
+        };
+
+        auto const heap = measure("heap", false);
+        auto const arena = measure("arena", true);
+        BEAST_EXPECT(arena < heap);
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(STObject, protocol, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(STObjectArena, protocol, ripple);
 
 }  // ripple
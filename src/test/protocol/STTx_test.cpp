@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/basics/Slice.h>
+#include <ripple/beast/core/LexicalCast.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/json/to_string.h>
 #include <ripple/protocol/Rules.h>
@@ -28,6 +29,7 @@
 #include <ripple/protocol/TxFormats.h>
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/protocol/messages.h>
+#include <chrono>
 #include <memory>
 #include <regex>
 
@@ -61,6 +63,41 @@ public:
 
         testcase("STObject constructor errors");
         testObjectCtorErrors();
+
+        testCheckSignBatch();
+
+        testTemplateIndex();
+    }
+
+    void
+    testTemplateIndex()
+    {
+        testcase("Template field index");
+
+        for (auto const& format : TxFormats::getInstance())
+        {
+            auto const& tmpl = format.getSOTemplate();
+
+            int i = 0;
+            for (auto const& element : tmpl)
+                BEAST_EXPECT(tmpl.getIndex(element.sField()) == i++);
+        }
+
+        auto const& payment =
+            TxFormats::getInstance().findByType(ttPAYMENT)->getSOTemplate();
+        BEAST_EXPECT(payment.getIndex(sfLimitAmount) == -1);
+        BEAST_EXPECT(payment.getIndex(sfOwnerCount) == -1);
+        BEAST_EXPECT(payment.getIndex(sfDestination) != -1);
+
+        STTx const tx(ttPAYMENT, [](auto& obj) {
+            obj.setAccountID(sfAccount, AccountID(1));
+            obj.setAccountID(sfDestination, AccountID(2));
+            obj.setFieldAmount(sfAmount, STAmount(1000));
+        });
+        BEAST_EXPECT(tx.isFieldPresent(sfDestination));
+        BEAST_EXPECT(!tx.isFieldPresent(sfDestinationTag));
+        BEAST_EXPECT(!tx.isFieldPresent(sfLimitAmount));
+        BEAST_EXPECT(tx.getAccountID(sfDestination) == AccountID(2));
     }
 
     void
@@ -1630,6 +1667,64 @@ public:
         }
     }
 
+    void
+    testCheckSignBatch()
+    {
+        testcase("Batch signature checks");
+
+        Rules defaultRules{{}};
+
+        auto makeTx = [](std::pair<PublicKey, SecretKey> const& keypair,
+                         std::uint32_t sequence) {
+            auto tx = std::make_shared<STTx>(
+                ttACCOUNT_SET, [&keypair, sequence](auto& obj) {
+                    obj.setAccountID(sfAccount, calcAccountID(keypair.first));
+                    obj.setFieldU32(sfSequence, sequence);
+                    obj.setFieldVL(sfSigningPubKey, keypair.first.slice());
+                });
+            tx->sign(keypair.first, keypair.second);
+            return tx;
+        };
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        for (std::uint32_t i = 0; i < 100; ++i)
+        {
+            auto tx = makeTx(
+                randomKeyPair(i % 2 ? KeyType::ed25519 : KeyType::secp256k1),
+                i);
+
+            // Invalidate every seventh signature by changing the signed data
+            if (i % 7 == 3)
+                tx->setFieldU32(sfSequence, i + 1000);
+
+            txs.push_back(tx);
+        }
+
+        // A multi-signed transaction with no signers is checked on its own
+        txs.push_back(std::make_shared<STTx const>(
+            ttACCOUNT_SET, [](auto& obj) {
+                auto const kp = randomKeyPair(KeyType::secp256k1);
+                obj.setAccountID(sfAccount, calcAccountID(kp.first));
+                obj.setFieldVL(sfSigningPubKey, Slice{});
+            }));
+
+        auto const results = STTx::checkSignBatch(
+            txs, STTx::RequireFullyCanonicalSig::yes, defaultRules);
+        BEAST_EXPECT(results.size() == txs.size());
+
+        for (std::size_t i = 0; i < txs.size(); ++i)
+        {
+            auto const single = txs[i]->checkSign(
+                STTx::RequireFullyCanonicalSig::yes, defaultRules);
+            BEAST_EXPECT(bool(results[i]) == bool(single));
+            if (i < 100)
+                BEAST_EXPECT(bool(results[i]) == (i % 7 != 3));
+            if (!results[i] && !single)
+                BEAST_EXPECT(results[i].error() == single.error());
+        }
+        BEAST_EXPECT(!results.back());
+    }
+
     void
     testObjectCtorErrors()
     {
@@ -1817,7 +1912,90 @@ public:
     }
 };
 
+/** Time the construction of STTx and the field accesses of a transactor.
+
+    A signed payment is deserialized repeatedly, and each copy has its
+    fields read the way that Transactor and Payment read them. Pass an
+    iteration count as the argument to override the default.
+*/
+class STTxTiming_test : public beast::unit_test::suite
+{
+    static constexpr int defaultIterations = 200000;
+
+public:
+    void
+    run() override
+    {
+        int const iterations = arg().empty()
+            ? defaultIterations
+            : beast::lexicalCastThrow<int>(arg());
+
+        auto const keypair = randomKeyPair(KeyType::secp256k1);
+        Issue const usd{Currency(1), AccountID(3)};
+        STTx tx(ttPAYMENT, [&keypair, &usd](auto& obj) {
+            obj.setAccountID(sfAccount, calcAccountID(keypair.first));
+            obj.setAccountID(sfDestination, AccountID(2));
+            obj.setFieldAmount(sfAmount, STAmount(usd, 100));
+            obj.setFieldAmount(sfSendMax, STAmount(usd, 101));
+            obj.setFieldU32(sfDestinationTag, 7);
+            obj.setFieldU32(sfSequence, 1);
+            obj.setFieldAmount(sfFee, STAmount(10));
+            obj.setFieldVL(sfSigningPubKey, keypair.first.slice());
+        });
+        tx.sign(keypair.first, keypair.second);
+
+        Serializer s;
+        tx.add(s);
+
+        using namespace std::chrono;
+
+        testcase("construction");
+        {
+            auto const start = steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                SerialIter sit(s.slice());
+                STTx const copy(sit);
+                BEAST_EXPECT(copy.getTxnType() == ttPAYMENT);
+            }
+            auto const elapsed = duration_cast<nanoseconds>(
+                steady_clock::now() - start);
+            log << iterations << " transactions, "
+                << elapsed.count() / iterations << " ns each" << std::endl;
+        }
+
+        testcase("field access");
+        {
+            SerialIter sit(s.slice());
+            STTx const copy(sit);
+
+            std::uint64_t found = 0;
+            auto const start = steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                found += copy.getAccountID(sfAccount) != beast::zero;
+                found += copy.getAccountID(sfDestination) != beast::zero;
+                found += copy.getFieldAmount(sfAmount) != beast::zero;
+                found += copy.isFieldPresent(sfSendMax);
+                found += copy.isFieldPresent(sfDeliverMin);
+                found += copy.isFieldPresent(sfPaths);
+                found += copy.isFieldPresent(sfTicketSequence);
+                found += copy.getFieldU32(sfSequence) != 0;
+                found += copy.getFieldU32(sfFlags) == 0;
+                found += copy.getFieldAmount(sfFee) != beast::zero;
+            }
+            auto const elapsed = duration_cast<nanoseconds>(
+                steady_clock::now() - start);
+            BEAST_EXPECT(found == 7ull * iterations);
+            log << iterations << " transactions, "
+                << elapsed.count() / iterations << " ns for 10 accesses"
+                << std::endl;
+        }
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(STTx, ripple_app, ripple);
 BEAST_DEFINE_TESTSUITE(InnerObjectFormatsSerializer, ripple_app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(STTxTiming, ripple_app, ripple);
 
 }  // namespace ripple
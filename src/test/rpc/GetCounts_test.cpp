@@ -77,6 +77,10 @@ class GetCounts_test : public beast::unit_test::suite
                 BEAST_EXPECTS(result[it.first].asInt() == it.second, it.first);
             }
             BEAST_EXPECT(!result.isMember(jss::local_txs));
+
+            // every close built a ledger
+            auto const& built = result[jss::ledger_phases]["build_ledger"];
+            BEAST_EXPECT(std::stoull(built[jss::count].asString()) >= 20);
         }
 
         {
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/shamap/SHAMap.h>
+#include <test/jtx.h>
+#include <test/shamap/common.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace ripple {
+namespace tests {
+
+// Measures the cost of hashing and flushing a state map, which dominates
+// the time taken to build a ledger at close.
+class SHAMapTiming_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static constexpr std::size_t defaultItems = 100000;
+    static constexpr std::size_t modifiedItems = 1000;
+    static constexpr int repeat = 3;
+
+    beast::xor_shift_engine gen_;
+
+    uint256
+    randomKey()
+    {
+        uint256 key;
+        for (auto& byte : key)
+            byte = static_cast<std::uint8_t>(gen_());
+        return key;
+    }
+
+    boost::intrusive_ptr<SHAMapItem const>
+    randomItem(uint256 const& key)
+    {
+        // Roughly the size of a serialized account root
+        Blob data(120);
+        for (auto& byte : data)
+            byte = static_cast<std::uint8_t>(gen_());
+        return make_shamapitem(key, makeSlice(data));
+    }
+
+    std::shared_ptr<SHAMap>
+    makeMap(Family& f, std::vector<uint256> const& keys)
+    {
+        auto map = std::make_shared<SHAMap>(SHAMapType::STATE, f);
+        for (auto const& key : keys)
+            map->addItem(SHAMapNodeType::tnACCOUNT_STATE, randomItem(key));
+        return map;
+    }
+
+    void
+    report(std::string const& name, clock_type::duration d, int nodes)
+    {
+        using ms = std::chrono::duration<double, std::milli>;
+        auto const elapsed = std::chrono::duration_cast<ms>(d).count();
+        std::stringstream ss;
+        ss << std::left << std::setw(14) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(10) << elapsed << " ms"
+           << std::setw(10) << nodes << " nodes";
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t const items = arg().empty()
+            ? defaultItems
+            : beast::lexicalCastThrow<std::size_t>(arg());
+
+        test::SuiteJournal journal("SHAMapTiming_test", *this);
+        TestNodeFamily f(journal);
+
+        std::vector<uint256> keys;
+        keys.reserve(items);
+        for (std::size_t i = 0; i < items; ++i)
+            keys.push_back(randomKey());
+
+        testcase("rehash and flushDirty");
+        log << items << " items, " << modifiedItems
+            << " modified per ledger, flushed by 1 and 4 workers"
+            << std::endl;
+
+        // The helpers run as jobs, so the queue needs more than one thread
+        test::jtx::Env env(
+            *this, test::jtx::envconfig([](std::unique_ptr<Config> cfg) {
+                cfg->FORCE_MULTI_THREAD = true;
+                return cfg;
+            }));
+        auto flush = [&jobQueue = env.app().getJobQueue()](
+                         SHAMap& map, int workers) {
+            if (workers == 1)
+                return map.flushDirty(hotACCOUNT_NODE);
+            return map.flushDirty(hotACCOUNT_NODE, jobQueue, workers - 1);
+        };
+
+        for (int i = 0; i < repeat; ++i)
+        {
+            // Hash every node of a newly built map
+            auto map = makeMap(f, keys);
+            auto start = clock_type::now();
+            auto nodes = map->unshare();
+            report("rehash", clock_type::now() - start, nodes);
+
+            for (int const workers : {1, 4})
+            {
+                auto const suffix = "/" + std::to_string(workers);
+
+                // Hash and write every node of a newly built map
+                map = makeMap(f, keys);
+                start = clock_type::now();
+                nodes = flush(*map, workers);
+                report("flush" + suffix, clock_type::now() - start, nodes);
+                auto const hash = map->getHash();
+
+                // Hash and write the nodes changed by a typical ledger
+                auto next = map->snapShot(true);
+                std::uniform_int_distribution<std::size_t> d(0, items - 1);
+                for (std::size_t j = 0; j < modifiedItems; ++j)
+                    next->updateGiveItem(
+                        SHAMapNodeType::tnACCOUNT_STATE,
+                        randomItem(keys[d(gen_)]));
+                start = clock_type::now();
+                nodes = flush(*next, workers);
+                report(
+                    "incremental" + suffix, clock_type::now() - start, nodes);
+
+                BEAST_EXPECT(next->getHash() != hash);
+            }
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapTiming, ripple_app, ripple);
+
+}  // namespace tests
+}  // namespace ripple
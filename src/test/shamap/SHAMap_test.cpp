@@ -21,9 +21,12 @@
 #include <ripple/basics/Buffer.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/shamap/SHAMap.h>
+#include <test/jtx.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <map>
 
 namespace ripple {
 namespace tests {
@@ -122,6 +125,202 @@ public:
 
         run(true, journal);
         run(false, journal);
+        testInnerNodeHashes(journal);
+        testParallelFlush(journal);
+        testPrefetch(journal);
+    }
+
+    // Returns the serialization of every node in the map, by hash
+    static std::map<uint256, Blob>
+    serializeNodes(SHAMap const& map)
+    {
+        std::map<uint256, Blob> nodes;
+        map.visitNodes([&](SHAMapTreeNode& node) {
+            Serializer s;
+            node.serializeWithPrefix(s);
+            nodes.emplace(node.getHash().as_uint256(), s.peekData());
+            return true;
+        });
+        return nodes;
+    }
+
+    void
+    testParallelFlush(beast::Journal const& journal)
+    {
+        testcase("parallel flush");
+
+        using namespace test::jtx;
+
+        // The helpers run as jobs, so the queue needs more than one thread
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            cfg->FORCE_MULTI_THREAD = true;
+            return cfg;
+        }));
+        auto& jobQueue = env.app().getJobQueue();
+
+        auto build = [&](tests::TestNodeFamily& f, int items, int seed) {
+            auto map = std::make_shared<SHAMap>(SHAMapType::STATE, f);
+            for (int k = 0; k < items; ++k)
+                map->addItem(
+                    SHAMapNodeType::tnACCOUNT_STATE,
+                    make_shamapitem(sha512Half(seed, k), IntToVUC(k)));
+            return map;
+        };
+
+        // Modify a few entries of an already flushed map, so that only
+        // some of the subtrees below the root are dirty.
+        auto modify = [&](SHAMap& map, int items, int seed, int modified) {
+            auto next = map.snapShot(true);
+            for (int k = 0; k < modified; ++k)
+                next->updateGiveItem(
+                    SHAMapNodeType::tnACCOUNT_STATE,
+                    make_shamapitem(
+                        sha512Half(seed, (k * 7919) % items),
+                        IntToVUC(k + modified)));
+            return next;
+        };
+
+        // Every node of the map must have been written to the nodestore
+        auto stored = [&](tests::TestNodeFamily& f,
+                          std::map<uint256, Blob> const& nodes) {
+            for (auto const& [hash, data] : nodes)
+            {
+                auto const obj = f.db().fetchNodeObject(hash, 0);
+                if (!obj || obj->getData() != data)
+                    return false;
+            }
+            return true;
+        };
+
+        for (int const items : {1, 2, 20, 1000})
+        {
+            for (int const workers : {2, 4, 16})
+            {
+                // Each map writes to its own nodestore, so the checks of
+                // the parallel flush can't be satisfied by the serial one.
+                tests::TestNodeFamily parallelFamily(journal);
+                tests::TestNodeFamily serialFamily(journal);
+
+                auto const seed = items + workers;
+                auto parallel = build(parallelFamily, items, seed);
+                auto serial = build(serialFamily, items, seed);
+                auto const flushed = parallel->flushDirty(
+                    hotACCOUNT_NODE, jobQueue, workers - 1);
+                BEAST_EXPECT(serial->flushDirty(hotACCOUNT_NODE) == flushed);
+                BEAST_EXPECT(serial->getHash() == parallel->getHash());
+
+                auto const nodes = serializeNodes(*parallel);
+                BEAST_EXPECT(nodes == serializeNodes(*serial));
+                BEAST_EXPECT(stored(parallelFamily, nodes));
+
+                for (int const modified : {1, 3, 100})
+                {
+                    auto parallelNext =
+                        modify(*parallel, items, seed, modified);
+                    auto serialNext = modify(*serial, items, seed, modified);
+                    auto const flushedNext = parallelNext->flushDirty(
+                        hotACCOUNT_NODE, jobQueue, workers - 1);
+                    BEAST_EXPECT(
+                        serialNext->flushDirty(hotACCOUNT_NODE) ==
+                        flushedNext);
+                    BEAST_EXPECT(
+                        serialNext->getHash() == parallelNext->getHash());
+
+                    auto const nextNodes = serializeNodes(*parallelNext);
+                    BEAST_EXPECT(nextNodes == serializeNodes(*serialNext));
+                    BEAST_EXPECT(stored(parallelFamily, nextNodes));
+                }
+            }
+        }
+    }
+
+    void
+    testPrefetch(beast::Journal const& journal)
+    {
+        testcase("prefetch");
+
+        tests::TestNodeFamily f(journal);
+
+        SHAMapHash hash;
+        {
+            SHAMap map(SHAMapType::STATE, f);
+            for (int k = 0; k < 1000; ++k)
+                map.addItem(
+                    SHAMapNodeType::tnACCOUNT_STATE,
+                    make_shamapitem(sha512Half(k), IntToVUC(k)));
+            map.flushDirty(hotACCOUNT_NODE);
+            hash = map.getHash();
+        }
+
+        // Some of the keys are in the map and some are not
+        std::vector<uint256> keys;
+        for (int k = 0; k < 2000; k += 7)
+            keys.push_back(sha512Half(k));
+
+        f.reset();
+        SHAMap map(SHAMapType::STATE, f);
+        BEAST_EXPECT(map.fetchRoot(hash, nullptr));
+
+        auto const before = f.db().getFetchTotalCount();
+        auto const fetched = map.prefetch(keys);
+        BEAST_EXPECT(fetched > 0);
+        BEAST_EXPECT(f.db().getFetchTotalCount() - before == fetched);
+
+        // Every node on the paths is now in memory
+        auto const prefetched = f.db().getFetchTotalCount();
+        for (int k = 0; k < 2000; k += 7)
+            BEAST_EXPECT(
+                static_cast<bool>(map.peekItem(sha512Half(k))) == (k < 1000));
+        BEAST_EXPECT(f.db().getFetchTotalCount() == prefetched);
+        BEAST_EXPECT(map.prefetch(keys) == 0);
+        BEAST_EXPECT(map.getHash() == hash);
+    }
+
+    void
+    testInnerNodeHashes(beast::Journal const& journal)
+    {
+        testcase("inner node hashes");
+
+        tests::TestNodeFamily f(journal);
+        SHAMap map(SHAMapType::FREE, f);
+        map.setUnbacked();
+
+        // Enough keys for dense nodes near the root and sparse ones below
+        for (int k = 0; k < 512; ++k)
+        {
+            uint256 key = sha512Half(k);
+            map.addItem(
+                SHAMapNodeType::tnTRANSACTION_NM,
+                make_shamapitem(key, IntToVUC(k)));
+        }
+        BEAST_EXPECT(map.getHash() != beast::zero);
+
+        int dense = 0;
+        int sparse = 0;
+        map.visitNodes([&](SHAMapTreeNode& node) {
+            if (!node.isInner())
+                return true;
+            auto const& inner = static_cast<SHAMapInnerNode&>(node);
+
+            Serializer expected;
+            expected.add32(HashPrefix::innerNode);
+            for (int b = 0; b < SHAMapInnerNode::branchFactor; ++b)
+                expected.addBitString(inner.getChildHash(b).as_uint256());
+
+            Serializer actual;
+            inner.serializeWithPrefix(actual);
+            BEAST_EXPECT(actual.peekData() == expected.peekData());
+            BEAST_EXPECT(
+                inner.getHash().as_uint256() == expected.getSHA512Half());
+
+            if (inner.getBranchCount() == SHAMapInnerNode::branchFactor)
+                ++dense;
+            else
+                ++sparse;
+            return true;
+        });
+        BEAST_EXPECT(dense > 0);
+        BEAST_EXPECT(sparse > 0);
     }
 
     void